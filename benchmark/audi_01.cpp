@@ -28,19 +28,6 @@ using namespace obake_benchmark;
 //
 // truncated to the total degree of 10.
 
-// Small helper to compute the truncated power to the n.
-template <typename T>
-auto truncated_pow(const T &x, unsigned n, unsigned limit)
-{
-    T retval(1);
-
-    for (auto i = 0u; i < n; ++i) {
-        retval = truncated_mul(retval, x, limit);
-    }
-
-    return retval;
-}
-
 int main()
 {
     using p_type = polynomial<p_monomial, double>;
@@ -0,0 +1,32 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OBAKE_DETAIL_CACHE_SIZES_HPP
+#define OBAKE_DETAIL_CACHE_SIZES_HPP
+
+#include <obake/detail/visibility.hpp>
+
+namespace obake::detail
+{
+
+// The sizes (in bytes) of the L1 data cache
+// and of the L2/L3 caches. A value of zero
+// signals that the size could not be determined.
+struct cache_sizes {
+    unsigned long l1d = 0;
+    unsigned long l2 = 0;
+    unsigned long l3 = 0;
+};
+
+// Return the cache sizes of the system, as
+// detected at runtime.
+OBAKE_DLL_PUBLIC const cache_sizes &get_cache_sizes();
+
+} // namespace obake::detail
+
+#endif
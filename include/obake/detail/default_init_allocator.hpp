@@ -0,0 +1,53 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OBAKE_DETAIL_DEFAULT_INIT_ALLOCATOR_HPP
+#define OBAKE_DETAIL_DEFAULT_INIT_ALLOCATOR_HPP
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace obake::detail
+{
+
+// Allocator adaptor which performs default initialisation
+// (rather than value initialisation) when constructing
+// an object without arguments. This is useful in order to avoid
+// the zeroing of fundamental types in standard containers,
+// e.g., std::vector::resize(), when the newly-created elements
+// will be overwritten anyway.
+template <typename T, typename A = ::std::allocator<T>>
+class default_init_allocator : public A
+{
+    using a_t = ::std::allocator_traits<A>;
+
+public:
+    template <typename U>
+    struct rebind {
+        using other = default_init_allocator<U, typename a_t::template rebind_alloc<U>>;
+    };
+
+    using A::A;
+
+    template <typename U>
+    void construct(U *ptr) noexcept(::std::is_nothrow_default_constructible_v<U>)
+    {
+        ::new (static_cast<void *>(ptr)) U;
+    }
+    template <typename U, typename... Args>
+    void construct(U *ptr, Args &&...args)
+    {
+        a_t::construct(static_cast<A &>(*this), ptr, ::std::forward<Args>(args)...);
+    }
+};
+
+} // namespace obake::detail
+
+#endif
@@ -0,0 +1,135 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OBAKE_DETAIL_MODULAR_HPP
+#define OBAKE_DETAIL_MODULAR_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <obake/detail/abseil.hpp>
+#include <obake/detail/visibility.hpp>
+
+namespace obake::detail
+{
+
+// Word-sized modular arithmetic via Montgomery multiplication,
+// with R = 2**64. The modulus must be odd and less than 2**62.
+// Unless otherwise noted, the arguments of the member functions
+// are assumed to be in the [0, p) range, and so are the return values.
+class montgomery_modulus
+{
+public:
+    explicit montgomery_modulus(::std::uint64_t p) : m_p(p)
+    {
+        assert(p % 2u == 1u);
+        assert(p < (::std::uint64_t(1) << 62));
+
+        // Compute p**-1 mod 2**64 via Newton iterations. The
+        // initial value is correct to 3 bits (p * p = 1 mod 8 for odd p),
+        // and each iteration doubles the number of correct bits.
+        auto inv = p;
+        for (auto i = 0; i < 5; ++i) {
+            inv *= 2u - p * inv;
+        }
+        assert(inv * p == 1u);
+        m_pinv = -inv;
+
+        // R**2 mod p.
+        const auto r = static_cast<::std::uint64_t>((::absl::uint128(1) << 64) % p);
+        m_r2 = static_cast<::std::uint64_t>((::absl::uint128(r) * r) % p);
+    }
+
+    ::std::uint64_t get_p() const
+    {
+        return m_p;
+    }
+
+    // Montgomery multiplication: a * b * R**-1 mod p.
+    // NOTE: it is enough for a * b to be less than p * R.
+    ::std::uint64_t mul(::std::uint64_t a, ::std::uint64_t b) const
+    {
+        const auto t = ::absl::uint128(a) * b;
+        const auto m = ::absl::Uint128Low64(t) * m_pinv;
+        // NOTE: t + m * p < p * R + R * p < 2**127,
+        // and the low 64 bits of the sum are zero.
+        const auto u = ::absl::Uint128High64(t + ::absl::uint128(m) * m_p);
+
+        return u >= m_p ? u - m_p : u;
+    }
+
+    // Conversion to/from the Montgomery representation.
+    ::std::uint64_t to_mont(::std::uint64_t a) const
+    {
+        return mul(a, m_r2);
+    }
+    ::std::uint64_t from_mont(::std::uint64_t a) const
+    {
+        return mul(a, 1);
+    }
+
+    ::std::uint64_t add(::std::uint64_t a, ::std::uint64_t b) const
+    {
+        const auto s = a + b;
+
+        return s >= m_p ? s - m_p : s;
+    }
+    ::std::uint64_t sub(::std::uint64_t a, ::std::uint64_t b) const
+    {
+        return a >= b ? a - b : a + (m_p - b);
+    }
+
+    // Modular inverse of a (in the standard representation)
+    // via the extended Euclidean algorithm.
+    // NOTE: a must be nonzero and coprime with p.
+    ::std::uint64_t inv(::std::uint64_t a) const
+    {
+        assert(a != 0u);
+
+        // NOTE: p < 2**62, thus all the quantities
+        // involved fit in a signed 64-bit integer.
+        ::std::int64_t r0 = static_cast<::std::int64_t>(m_p), r1 = static_cast<::std::int64_t>(a), s0 = 0, s1 = 1;
+        while (r1 != 0) {
+            const auto q = r0 / r1;
+
+            const auto r2 = r0 - q * r1;
+            r0 = r1;
+            r1 = r2;
+
+            const auto s2 = s0 - q * s1;
+            s0 = s1;
+            s1 = s2;
+        }
+        assert(r0 == 1);
+
+        return static_cast<::std::uint64_t>(s0 < 0 ? s0 + static_cast<::std::int64_t>(m_p) : s0);
+    }
+
+private:
+    ::std::uint64_t m_p;
+    // -p**-1 mod R.
+    ::std::uint64_t m_pinv;
+    // R**2 mod p.
+    ::std::uint64_t m_r2;
+};
+
+// Deterministic primality test for 64-bit unsigned integers.
+OBAKE_DLL_PUBLIC bool is_prime_u64(::std::uint64_t);
+
+// The number of primes returned by modular_primes().
+inline constexpr ::std::size_t modular_primes_size = 256;
+
+// The modular_primes_size largest primes less than
+// 2**62, in descending order.
+OBAKE_DLL_PUBLIC const ::std::vector<::std::uint64_t> &modular_primes();
+
+} // namespace obake::detail
+
+#endif
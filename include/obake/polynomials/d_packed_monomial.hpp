@@ -548,6 +548,26 @@ inline void monomial_mul(d_packed_monomial<T, PSize> &out, const d_packed_monomi
     assert(polynomials::key_is_compatible(out, ss));
 }
 
+// Implementation of monomial_unpack().
+// NOTE: requires d to be compatible with ss, and out
+// to point to an array of at least ss.size() elements.
+template <typename T, unsigned PSize>
+inline void monomial_unpack(T *out, const d_packed_monomial<T, PSize> &d, const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(d, ss));
+
+    const auto s_size = ss.size();
+
+    symbol_idx idx = 0;
+    for (const auto &n : d._container()) {
+        kunpacker<T> ku(n, PSize);
+
+        for (auto j = 0u; j < PSize && idx < s_size; ++j, ++idx) {
+            ku >> out[idx];
+        }
+    }
+}
+
 namespace detail
 {
 
@@ -905,18 +925,65 @@ inline T key_degree(const d_packed_monomial<T, PSize> &d, const symbol_set &ss)
 
     const auto s_size = ss.size();
 
-    symbol_idx idx = 0;
-    T tmp, retval(0);
-    for (const auto &n : d._container()) {
-        kunpacker<T> ku(n, PSize);
+    // NOTE: the unpacked exponents are within the limits
+    // [-lim, lim] (or [0, lim] for unsigned types) of the Kronecker
+    // packing. If s_size * lim is representable by T, then no partial
+    // sum of the exponents can overflow (for signed types, the negative
+    // range of T is at least as large as the positive one), and the exponents
+    // can be accumulated without any check. This is the common case, unless
+    // PSize is very small or the number of symbols is very large.
+    const auto lim = ::obake::detail::kpack_get_lims<T>(PSize).second;
+    using u_t = ::std::make_unsigned_t<T>;
+
+    if (obake_likely(s_size <= static_cast<u_t>(::obake::detail::limits_max<T> / lim))) {
+        // Unpack each packed word into a local array, and accumulate
+        // it lane-wise into acc. The accumulation loop has a fixed
+        // trip count and no branches, so that it can be vectorised.
+        // NOTE: each lane holds a partial sum of the exponents, hence
+        // it cannot overflow either.
+        T acc[PSize] = {}, tmp[PSize];
+        symbol_idx idx = 0;
+        for (const auto &n : d._container()) {
+            kunpacker<T> ku(n, PSize);
+
+            // NOTE: only the last word may contain
+            // less than PSize exponents.
+            const auto n_expo = static_cast<unsigned>(::std::min(s_size - idx, static_cast<symbol_idx>(PSize)));
+            for (auto j = 0u; j < n_expo; ++j) {
+                ku >> tmp[j];
+            }
+            for (auto j = n_expo; j < PSize; ++j) {
+                tmp[j] = T(0);
+            }
+            for (auto j = 0u; j < PSize; ++j) {
+                acc[j] = static_cast<T>(acc[j] + tmp[j]);
+            }
 
-        for (auto j = 0u; j < PSize && idx < s_size; ++j, ++idx) {
-            ku >> tmp;
-            retval = ::obake::detail::safe_int_add(retval, tmp);
+            idx += n_expo;
         }
-    }
 
-    return static_cast<T>(retval);
+        T retval(0);
+        for (auto j = 0u; j < PSize; ++j) {
+            retval = static_cast<T>(retval + acc[j]);
+        }
+
+        return retval;
+    } else {
+        // Compute the degree via checked
+        // arithmetic, one exponent at a time.
+        symbol_idx idx = 0;
+        T tmp, retval(0);
+        for (const auto &n : d._container()) {
+            kunpacker<T> ku(n, PSize);
+
+            for (auto j = 0u; j < PSize && idx < s_size; ++j, ++idx) {
+                ku >> tmp;
+                retval = ::obake::detail::safe_int_add(retval, tmp);
+            }
+        }
+
+        return retval;
+    }
 }
 
 extern template dpm_default_s_t key_degree(const d_packed_monomial<dpm_default_s_t, dpm_default_psize> &,
@@ -0,0 +1,443 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OBAKE_POLYNOMIALS_EVAL_PLAN_HPP
+#define OBAKE_POLYNOMIALS_EVAL_PLAN_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <mp++/integer.hpp>
+
+#include <obake/config.hpp>
+#include <obake/detail/abseil.hpp>
+#include <obake/detail/safe_integral_arith.hpp>
+#include <obake/detail/to_string.hpp>
+#include <obake/detail/type_c.hpp>
+#include <obake/exceptions.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/math/safe_cast.hpp>
+#include <obake/polynomials/monomial_unpack.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/series.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_traits.hpp>
+
+namespace obake::polynomials
+{
+
+namespace detail
+{
+
+// Meta-programming for the evaluation of a plan
+// for polynomial<K, C> with values of type U. The requirements are:
+// - U must be exponentiable to the exponent type of K (via
+//   const lvalue refs), with a semi-regular result,
+// - the return type (i.e., the type of the product of the result of the
+//   exponentiation by the coefficient, via const lvalue refs) must be
+//   semi-regular, constructible from int and from the coefficient type,
+//   multipliable in-place by the result of the exponentiation
+//   and addable in-place with an rvalue.
+template <typename K, typename C, typename U>
+constexpr auto eval_plan_algorithm_impl()
+{
+    [[maybe_unused]] constexpr auto failure = ::std::make_pair(false, ::obake::detail::type_c<void>{});
+
+    using expo_t = typename K::value_type;
+
+    if constexpr (::std::conjunction_v<is_semi_regular<U>,
+                                       is_exponentiable<::std::add_lvalue_reference_t<const U>,
+                                                        ::std::add_lvalue_reference_t<const expo_t>>>) {
+        using pow_ret_t = ::obake::detail::pow_t<const U &, const expo_t &>;
+        using ret_t = detected_t<::obake::detail::mul_t, const pow_ret_t &, const C &>;
+
+        if constexpr (::std::conjunction_v<
+                          is_semi_regular<pow_ret_t>,
+                          // NOTE: these will also verify that ret_t is detected.
+                          is_semi_regular<ret_t>, ::std::is_constructible<ret_t, int>,
+                          ::std::is_constructible<ret_t, const C &>,
+                          is_in_place_multipliable<::std::add_lvalue_reference_t<ret_t>, const pow_ret_t &>,
+                          is_in_place_addable<::std::add_lvalue_reference_t<ret_t>, ret_t>>) {
+            return ::std::make_pair(true, ::obake::detail::type_c<ret_t>{});
+        } else {
+            return failure;
+        }
+    } else {
+        return failure;
+    }
+}
+
+template <typename K, typename C, typename U>
+inline constexpr auto eval_plan_algorithm = detail::eval_plan_algorithm_impl<K, C, U>();
+
+template <typename K, typename C, typename U>
+inline constexpr bool eval_plan_algo = eval_plan_algorithm<K, C, U>.first;
+
+template <typename K, typename C, typename U>
+using eval_plan_ret_t = typename decltype(eval_plan_algorithm<K, C, U>.second)::type;
+
+} // namespace detail
+
+// Compiled evaluation plan for a polynomial.
+//
+// The plan encodes a recursive (multivariate) Horner scheme for the
+// polynomial: the terms are grouped according to the exponent of
+// the first variable, each group is evaluated recursively in the
+// remaining variables, and the groups are then combined via Horner's
+// rule in the first variable. The scheme is stored as a flat array of
+// instructions for a small stack machine, with the coefficients stored
+// contiguously in the order in which they are consumed. The powers of the
+// symbols' values needed by the plan are computed once per evaluation.
+// After construction, the evaluation requires no hashing and no
+// unpacking of the monomials.
+// NOTE: the plan is immutable, and it can be evaluated
+// concurrently from multiple threads.
+template <typename K, typename C>
+    requires ::std::conjunction_v<is_integral<typename K::value_type>,
+                                  is_unpackable_monomial<typename K::value_type *, const K &>,
+                                  ::std::bool_constant<series_rank<C> == 0u>>
+class eval_plan
+{
+public:
+    using expo_t = typename K::value_type;
+
+private:
+    // The opcodes of the stack machine:
+    // - push_cf: push the next coefficient,
+    // - mul_pow: multiply the top of the stack by
+    //   a power of a symbol's value,
+    // - add: pop the top of the stack, and add
+    //   it to the new top of the stack.
+    enum class opcode : unsigned char { push_cf, mul_pow, add };
+
+    struct instruction {
+        opcode op;
+        // For mul_pow, the index in m_pows
+        // of the power of the symbol's value.
+        ::std::size_t idx;
+    };
+
+    // Map from the (var, exponent) pairs in m_pows
+    // to their indices, used during the construction
+    // of the plan.
+    using pow_map_t = ::absl::flat_hash_map<::std::pair<symbol_idx, expo_t>, ::std::size_t>;
+
+    // Helper to emit the instructions for the
+    // terms in the sorted range [begin, end), which
+    // share the exponents of the variables before var.
+    // The terms are represented as indices in the
+    // flat vector of exponents.
+    template <typename It>
+    void emit(It begin, It end, const ::std::vector<expo_t> &expos, const ::std::vector<const C *> &cfs,
+              pow_map_t &pow_map, symbol_idx var, ::std::size_t depth)
+    {
+        assert(begin != end);
+
+        const auto n_vars = m_symbol_set.size();
+
+        if (var == n_vars) {
+            // Terms are unique, thus at this point
+            // we must have a single term.
+            assert(end - begin == 1);
+
+            m_cfs.push_back(*cfs[*begin]);
+            m_instructions.push_back(instruction{opcode::push_cf, 0});
+            m_max_stack = ::std::max(m_max_stack, depth + 1u);
+
+            return;
+        }
+
+        // The exponent of var in the term at index i.
+        auto get_expo = [&expos, n_vars, var](::std::size_t i) { return expos[i * n_vars + var]; };
+
+        // Split the range in groups sharing the exponent of var.
+        // The groups are sorted in ascending order of the exponent.
+        ::std::vector<It> groups{begin};
+        for (auto it = begin + 1; it != end; ++it) {
+            if (get_expo(*it) != get_expo(*(it - 1))) {
+                groups.push_back(it);
+            }
+        }
+        groups.push_back(end);
+
+        // Horner's rule, starting from the group
+        // with the highest exponent.
+        auto g = groups.size() - 2u;
+        emit(groups[g], groups[g + 1u], expos, cfs, pow_map, var + 1u, depth);
+        while (g != 0u) {
+            --g;
+
+            // Multiply the accumulator by the power
+            // of var corresponding to the exponent gap.
+            emit_mul_pow(pow_map, var,
+                         ::obake::detail::safe_int_sub(get_expo(*groups[g + 1u]), get_expo(*groups[g])));
+
+            // Evaluate the current group on top of the
+            // accumulator, and add it to the accumulator.
+            emit(groups[g], groups[g + 1u], expos, cfs, pow_map, var + 1u, depth + 1u);
+            m_instructions.push_back(instruction{opcode::add, 0});
+        }
+
+        // Multiply by the power of var corresponding
+        // to the lowest exponent, if nonzero.
+        if (get_expo(*begin) != expo_t(0)) {
+            emit_mul_pow(pow_map, var, get_expo(*begin));
+        }
+    }
+    // Emit a mul_pow instruction for var**e, adding
+    // the power to m_pows (and pow_map) if not present already.
+    void emit_mul_pow(pow_map_t &pow_map, symbol_idx var, const expo_t &e)
+    {
+        const auto p = ::std::make_pair(var, e);
+        const auto [it, inserted] = pow_map.try_emplace(p, m_pows.size());
+        if (inserted) {
+            m_pows.push_back(p);
+        }
+
+        m_instructions.push_back(instruction{opcode::mul_pow, it->second});
+    }
+
+public:
+    // Def ctor: an empty plan, which
+    // will evaluate to zero.
+    eval_plan() = default;
+    // Constructor from a polynomial.
+    explicit eval_plan(const polynomial<K, C> &p) : m_symbol_set(p.get_symbol_set())
+    {
+        if (p.empty()) {
+            return;
+        }
+
+        const auto n_vars = m_symbol_set.size();
+        const auto n_terms = ::obake::safe_cast<::std::size_t>(p.size());
+
+        // Unpack the monomials and store
+        // pointers to the coefficients.
+        ::std::vector<expo_t> expos;
+        expos.resize(::obake::safe_cast<decltype(expos.size())>(::mppp::integer<1>(n_terms) * n_vars));
+        ::std::vector<const C *> cfs;
+        cfs.reserve(::obake::safe_cast<decltype(cfs.size())>(n_terms));
+        for (const auto &t : p) {
+            ::obake::monomial_unpack(expos.data() + cfs.size() * n_vars, t.first, m_symbol_set);
+            cfs.push_back(&t.second);
+        }
+
+        // Sort the terms in lexicographic order of the exponents.
+        ::std::vector<::std::size_t> idx;
+        idx.resize(::obake::safe_cast<decltype(idx.size())>(n_terms));
+        ::std::iota(idx.begin(), idx.end(), ::std::size_t(0));
+        ::std::sort(idx.begin(), idx.end(), [&expos, n_vars](::std::size_t a, ::std::size_t b) {
+            return ::std::lexicographical_compare(expos.data() + a * n_vars, expos.data() + (a + 1u) * n_vars,
+                                                  expos.data() + b * n_vars, expos.data() + (b + 1u) * n_vars);
+        });
+
+        m_cfs.reserve(::obake::safe_cast<decltype(m_cfs.size())>(n_terms));
+        pow_map_t pow_map;
+        emit(idx.cbegin(), idx.cend(), expos, cfs, pow_map, 0, 0);
+        assert(m_cfs.size() == n_terms);
+    }
+
+    // Workspace for the evaluation with values of type U.
+    // A workspace holds the storage for the powers and for
+    // the stack of the evaluation, and it can be reused
+    // across evaluations (also of different plans) in order to avoid
+    // memory allocations. A workspace must not be used
+    // concurrently from multiple threads.
+    template <typename U>
+        requires detail::eval_plan_algo<K, C, U>
+    class workspace
+    {
+        friend class eval_plan;
+
+        ::std::vector<::obake::detail::pow_t<const U &, const expo_t &>> m_pw;
+        ::std::vector<detail::eval_plan_ret_t<K, C, U>> m_st;
+    };
+
+    const symbol_set &get_symbol_set() const
+    {
+        return m_symbol_set;
+    }
+    // The number of instructions in the plan.
+    ::std::size_t size() const
+    {
+        return m_instructions.size();
+    }
+
+private:
+    // Implementation of the evaluation. vals is the array of values
+    // of the symbols, ws provides the storage for the powers
+    // and for the stack.
+    template <typename U>
+    detail::eval_plan_ret_t<K, C, U> eval_impl(const U *vals, workspace<U> &ws) const
+    {
+        using ret_t = detail::eval_plan_ret_t<K, C, U>;
+
+        if (m_instructions.empty()) {
+            return ret_t(0);
+        }
+
+        // Make sure the workspace is large enough.
+        auto &pw = ws.m_pw;
+        auto &st = ws.m_st;
+        if (pw.size() < m_pows.size()) {
+            pw.resize(m_pows.size());
+        }
+        if (st.size() < m_max_stack) {
+            st.resize(m_max_stack);
+        }
+
+        // Compute the powers.
+        for (decltype(m_pows.size()) i = 0; i < m_pows.size(); ++i) {
+            pw[i] = ::obake::pow(vals[m_pows[i].first], m_pows[i].second);
+        }
+
+        // Run the instructions.
+        ::std::size_t sp = 0;
+        auto cf_ptr = m_cfs.data();
+        for (const auto &ins : m_instructions) {
+            switch (ins.op) {
+                case opcode::push_cf:
+                    assert(sp < st.size());
+                    st[sp++] = ret_t(*cf_ptr++);
+                    break;
+                case opcode::mul_pow:
+                    assert(sp > 0u);
+                    st[sp - 1u] *= ::std::as_const(pw[ins.idx]);
+                    break;
+                case opcode::add:
+                    assert(sp > 1u);
+                    st[sp - 2u] += ::std::move(st[sp - 1u]);
+                    --sp;
+            }
+        }
+        assert(sp == 1u);
+
+        return ::std::move(st[0]);
+    }
+    // Helper to check that sm contains all the
+    // symbols of the plan and fetch the corresponding
+    // values via the getter f.
+    template <typename M, typename F>
+    void fetch_values(const M &sm, const F &f) const
+    {
+        for (decltype(m_symbol_set.size()) i = 0; i < m_symbol_set.size(); ++i) {
+            const auto &s = *m_symbol_set.nth(i);
+            const auto it = sm.find(s);
+
+            if (obake_unlikely(it == sm.end())) {
+                obake_throw(::std::invalid_argument,
+                            "Cannot evaluate a polynomial evaluation plan: the symbol '" + s
+                                + "' is missing from the evaluation map");
+            }
+
+            f(i, it->second);
+        }
+    }
+
+public:
+    // Evaluation with the values of the symbols
+    // in the array vals, in the order of the plan's
+    // symbol set.
+    template <typename U>
+        requires detail::eval_plan_algo<K, C, U>
+    detail::eval_plan_ret_t<K, C, U> operator()(const U *vals) const
+    {
+        workspace<U> ws;
+
+        return eval_impl(vals, ws);
+    }
+    // Evaluation with the values of the symbols
+    // in the array vals, using the storage
+    // provided by the workspace ws. Repeated evaluations
+    // with the same workspace do not allocate memory
+    // (apart from the memory allocated by the operations on U
+    // and on the return type).
+    template <typename U>
+        requires detail::eval_plan_algo<K, C, U>
+    detail::eval_plan_ret_t<K, C, U> operator()(const U *vals, workspace<U> &ws) const
+    {
+        return eval_impl(vals, ws);
+    }
+    // Evaluation with the values of the symbols
+    // in the symbol map sm.
+    template <typename U>
+        requires detail::eval_plan_algo<K, C, U>
+    detail::eval_plan_ret_t<K, C, U> operator()(const symbol_map<U> &sm) const
+    {
+        ::std::vector<U> vals(m_symbol_set.size());
+        fetch_values(sm, [&vals](auto i, const U &v) { vals[i] = v; });
+
+        return (*this)(vals.data());
+    }
+    // Batch evaluation: the values of each symbol are
+    // contiguous arrays in sm, all of the same size n. The
+    // return value contains the n evaluations.
+    template <typename U>
+        requires detail::eval_plan_algo<K, C, U>
+    ::std::vector<detail::eval_plan_ret_t<K, C, U>> operator()(const symbol_map<::std::vector<U>> &sm) const
+    {
+        using ret_t = detail::eval_plan_ret_t<K, C, U>;
+
+        // Fetch pointers to the arrays of values,
+        // and check their sizes.
+        const auto n_points = sm.empty() ? ::std::size_t(0)
+                                         : ::obake::safe_cast<::std::size_t>(sm.begin()->second.size());
+        for (const auto &p : sm) {
+            if (obake_unlikely(p.second.size() != n_points)) {
+                obake_throw(::std::invalid_argument,
+                            "Cannot evaluate a polynomial evaluation plan in batch mode: the array of values for "
+                            "the symbol '"
+                                + p.first + "' has a size of " + ::obake::detail::to_string(p.second.size())
+                                + ", but the array of values for the symbol '" + sm.begin()->first
+                                + "' has a size of " + ::obake::detail::to_string(n_points));
+            }
+        }
+        ::std::vector<const U *> arrs(m_symbol_set.size());
+        fetch_values(sm, [&arrs](auto i, const ::std::vector<U> &v) { arrs[i] = v.data(); });
+
+        ::std::vector<ret_t> retval;
+        retval.resize(::obake::safe_cast<decltype(retval.size())>(n_points));
+
+        // The points are evaluated in parallel.
+        ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, n_points), [this, &arrs, &retval](const auto &range) {
+            ::std::vector<U> vals(arrs.size());
+            workspace<U> ws;
+
+            for (auto i = range.begin(); i != range.end(); ++i) {
+                for (decltype(arrs.size()) j = 0; j < arrs.size(); ++j) {
+                    vals[j] = arrs[j][i];
+                }
+
+                retval[i] = eval_impl(vals.data(), ws);
+            }
+        });
+
+        return retval;
+    }
+
+private:
+    symbol_set m_symbol_set;
+    ::std::vector<instruction> m_instructions;
+    ::std::vector<C> m_cfs;
+    ::std::vector<::std::pair<symbol_idx, expo_t>> m_pows;
+    ::std::size_t m_max_stack = 0;
+};
+
+} // namespace obake::polynomials
+
+#endif
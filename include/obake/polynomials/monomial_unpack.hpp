@@ -0,0 +1,81 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OBAKE_POLYNOMIALS_MONOMIAL_UNPACK_HPP
+#define OBAKE_POLYNOMIALS_MONOMIAL_UNPACK_HPP
+
+#include <utility>
+
+#include <obake/detail/not_implemented.hpp>
+#include <obake/detail/priority_tag.hpp>
+#include <obake/detail/ss_func_forward.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_traits.hpp>
+
+namespace obake
+{
+
+namespace customisation
+{
+
+// External customisation point for obake::monomial_unpack().
+template <typename T, typename U>
+inline constexpr auto monomial_unpack = not_implemented;
+
+} // namespace customisation
+
+namespace detail
+{
+
+// Highest priority: explicit user override in the external customisation namespace.
+template <typename T, typename U>
+constexpr auto monomial_unpack_impl(T &&x, U &&y, const symbol_set &ss, priority_tag<1>)
+    OBAKE_SS_FORWARD_FUNCTION((customisation::monomial_unpack<T &&, U &&>)(::std::forward<T>(x),
+                                                                           ::std::forward<U>(y), ss));
+
+// Unqualified function call implementation.
+template <typename T, typename U>
+constexpr auto monomial_unpack_impl(T &&x, U &&y, const symbol_set &ss, priority_tag<0>)
+    OBAKE_SS_FORWARD_FUNCTION(monomial_unpack(::std::forward<T>(x), ::std::forward<U>(y), ss));
+
+} // namespace detail
+
+// Write the exponents of the monomial y, one per symbol in ss,
+// into the output x (typically a pointer to the beginning of
+// an array of ss.size() elements).
+// NOTE: as usual, cast the return value to void in order to ensure
+// it is never used.
+inline constexpr auto monomial_unpack = [](auto &&x, auto &&y, const symbol_set &ss) OBAKE_SS_FORWARD_LAMBDA(
+    void(detail::monomial_unpack_impl(::std::forward<decltype(x)>(x), ::std::forward<decltype(y)>(y), ss,
+                                      detail::priority_tag<1>{})));
+
+namespace detail
+{
+
+template <typename T, typename U>
+using monomial_unpack_t = decltype(::obake::monomial_unpack(::std::declval<T>(), ::std::declval<U>(),
+                                                            ::std::declval<const symbol_set &>()));
+
+}
+
+// NOTE: runtime requirement: y must be compatible with the reference symbol set.
+template <typename T, typename U>
+using is_unpackable_monomial = is_detected<detail::monomial_unpack_t, T, U>;
+
+template <typename T, typename U>
+inline constexpr bool is_unpackable_monomial_v = is_unpackable_monomial<T, U>::value;
+
+template <typename T, typename U>
+concept UnpackableMonomial = requires(T &&x, U &&y, const symbol_set &ss)
+{
+    ::obake::monomial_unpack(::std::forward<T>(x), ::std::forward<U>(y), ss);
+};
+
+} // namespace obake
+
+#endif
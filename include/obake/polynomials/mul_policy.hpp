@@ -0,0 +1,132 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OBAKE_POLYNOMIALS_MUL_POLICY_HPP
+#define OBAKE_POLYNOMIALS_MUL_POLICY_HPP
+
+#include <ostream>
+
+#include <obake/detail/cache_sizes.hpp>
+#include <obake/detail/visibility.hpp>
+
+namespace obake::polynomials
+{
+
+// The tunable parameters of the multi-threaded
+// polynomial multiplication.
+// NOTE: the default member values are the historical
+// hard-coded values, which are also used by default
+// in the multiplication. cache_mul_policy() instead returns
+// values deduced from the cache sizes detected at runtime.
+struct mul_policy {
+    // The desired segment size (in bytes) of the product
+    // for highly sparse multiplications.
+    unsigned long sparse_seg_size = 200ul * 1024ul;
+    // The desired segment size (in bytes) of the product
+    // for the other multiplications.
+    unsigned long dense_seg_size = 20ul * 1024ul;
+    // The estimated sparsity at or above which a
+    // multiplication is considered highly sparse.
+    double sp_threshold = 1E-3;
+    // The estimated sparsity below which the dense
+    // multiplication algorithm is attempted.
+    double dense_sp_threshold = 1E-1;
+    // The maximum ratio between the size of the bounding box
+    // of the product and the estimated number of terms
+    // of the product in the dense multiplication algorithm.
+    unsigned long dense_max_box_ratio = 32;
+    // The size (in bytes) of the accumulation chunks
+    // in the dense multiplication algorithm.
+    unsigned long dense_chunk_size = 256ul * 1024ul;
+    // The maximum number of terms in the shorter operand
+    // at or below which the heap-based multiplication
+    // algorithm is attempted.
+    unsigned long heap_max_size = 64;
+    // The minimum number of terms in the longer operand
+    // at or above which the heap-based multiplication
+    // algorithm is attempted.
+    unsigned long heap_min_size = 4096;
+    // The minimum ratio between the number of terms in
+    // the longer operand and the number of terms in the shorter
+    // operand at or above which the heap-based multiplication
+    // algorithm is attempted.
+    unsigned long heap_min_ratio = 16;
+    // The minimum number of terms in the shorter operand
+    // at or above which the Kronecker substitution and
+    // multi-modular algorithms are attempted for products
+    // of polynomials with multiprecision integral coefficients.
+    unsigned long kronecker_min_size = 128;
+    // The minimum number of terms in the shorter operand
+    // at or above which the FFT algorithm is attempted
+    // for products of polynomials with double coefficients.
+    unsigned long fft_min_size = 128;
+    // The maximum relative error on the coefficients
+    // of the product accepted in the FFT algorithm
+    // when the exact result cannot be recovered. A value
+    // of zero restricts the FFT algorithm to the cases in
+    // which its result is identical to the result of the
+    // other multiplication algorithms.
+    double fft_tolerance = 0;
+};
+
+// The multiplication policy deduced from the cache
+// sizes detected at runtime (or from the cache sizes
+// passed as input). Cache sizes of zero (i.e., not detected)
+// result in the default values. It can be enabled via
+// set_mul_policy() or mul_policy_guard.
+OBAKE_DLL_PUBLIC mul_policy cache_mul_policy();
+OBAKE_DLL_PUBLIC mul_policy cache_mul_policy(const ::obake::detail::cache_sizes &);
+
+// Return the multiplication policy in use in the calling
+// thread (i.e., the policy set by the innermost mul_policy_guard
+// in the calling thread, if any, otherwise the global policy).
+OBAKE_DLL_PUBLIC mul_policy get_mul_policy();
+
+// The cache sizes detected at runtime, together
+// with the multiplication policy in use in the
+// calling thread.
+struct mul_policy_info {
+    ::obake::detail::cache_sizes cache_sizes;
+    mul_policy policy;
+};
+
+OBAKE_DLL_PUBLIC mul_policy_info get_mul_policy_info();
+
+// Set/reset the global multiplication policy. The global
+// policy is initially (and after a reset) the default-constructed one.
+OBAKE_DLL_PUBLIC void set_mul_policy(const mul_policy &);
+OBAKE_DLL_PUBLIC void reset_mul_policy();
+
+// Scoped override of the multiplication policy
+// in the calling thread.
+// NOTE: the policy is fetched at the beginning of
+// each multiplication in the thread which
+// invoked it. Multiplications triggered from within
+// other threads (e.g., the multiplication of series
+// coefficients in a parallel product) are not affected
+// by the override, and they will use the global policy.
+class OBAKE_DLL_PUBLIC mul_policy_guard
+{
+public:
+    explicit mul_policy_guard(const mul_policy &);
+    mul_policy_guard(const mul_policy_guard &) = delete;
+    mul_policy_guard(mul_policy_guard &&) = delete;
+    mul_policy_guard &operator=(const mul_policy_guard &) = delete;
+    mul_policy_guard &operator=(mul_policy_guard &&) = delete;
+    ~mul_policy_guard();
+
+private:
+    mul_policy m_policy;
+    const mul_policy *m_prev;
+};
+
+OBAKE_DLL_PUBLIC ::std::ostream &operator<<(::std::ostream &, const mul_policy &);
+
+} // namespace obake::polynomials
+
+#endif
@@ -261,6 +261,23 @@ constexpr void monomial_mul(packed_monomial<T> &out, const packed_monomial<T> &a
     assert(polynomials::key_is_compatible(out, ss));
 }
 
+// Implementation of monomial_unpack().
+// NOTE: requires p to be compatible with ss, and out
+// to point to an array of at least ss.size() elements.
+template <typename T>
+inline void monomial_unpack(T *out, const packed_monomial<T> &p, const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+
+    // NOTE: because we assume compatibility, the static cast is safe.
+    const auto s_size = static_cast<unsigned>(ss.size());
+
+    kunpacker<T> ku(p.get_value(), s_size);
+    for (auto i = 0u; i < s_size; ++i) {
+        ku >> out[i];
+    }
+}
+
 namespace detail
 {
 
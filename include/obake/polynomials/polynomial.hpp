@@ -11,12 +11,17 @@
 
 #include <algorithm>
 #include <atomic>
+#include <bit>
 #include <cassert>
 #include <cmath>
+#include <complex>
 #include <cstddef>
 #include <cstdint>
 #include <initializer_list>
+#include <limits>
+#include <numbers>
 #include <numeric>
+#include <optional>
 #include <random>
 #include <stdexcept>
 #include <string>
@@ -31,6 +36,8 @@
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/serialization/tracking.hpp>
 
+#include <gmp.h>
+
 #include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_invoke.h>
@@ -42,20 +49,31 @@
 #include <obake/byte_size.hpp>
 #include <obake/config.hpp>
 #include <obake/detail/abseil.hpp>
+#include <obake/detail/atomic_flag_array.hpp>
+#include <obake/detail/atomic_lock_guard.hpp>
+#include <obake/detail/default_init_allocator.hpp>
 #include <obake/detail/hc.hpp>
 #include <obake/detail/ignore.hpp>
 #include <obake/detail/it_diff_check.hpp>
+#include <obake/detail/limits.hpp>
 #include <obake/detail/make_array.hpp>
+#include <obake/detail/modular.hpp>
+#include <obake/detail/mppp_utils.hpp>
 #include <obake/detail/ss_func_forward.hpp>
 #include <obake/detail/to_string.hpp>
 #include <obake/detail/type_c.hpp>
 #include <obake/detail/xoroshiro128_plus.hpp>
 #include <obake/exceptions.hpp>
 #include <obake/hash.hpp>
+#include <obake/kpack.hpp>
+#include <obake/key/key_evaluate.hpp>
 #include <obake/key/key_merge_symbols.hpp>
+#include <obake/key/key_trim_identify.hpp>
 #include <obake/math/diff.hpp>
+#include <obake/math/evaluate.hpp>
 #include <obake/math/fma3.hpp>
 #include <obake/math/is_zero.hpp>
+#include <obake/math/negate.hpp>
 #include <obake/math/pow.hpp>
 #include <obake/math/safe_cast.hpp>
 #include <obake/math/subs.hpp>
@@ -66,6 +84,8 @@
 #include <obake/polynomials/monomial_pow.hpp>
 #include <obake/polynomials/monomial_range_overflow_check.hpp>
 #include <obake/polynomials/monomial_subs.hpp>
+#include <obake/polynomials/monomial_unpack.hpp>
+#include <obake/polynomials/mul_policy.hpp>
 #include <obake/ranges.hpp>
 #include <obake/s11n.hpp>
 #include <obake/series.hpp>
@@ -237,10 +257,11 @@ namespace detail
 template <typename V>
 inline auto poly_mul_impl_par_make_idx_vector(const V &v)
 {
-    // NOTE: we could use here a custom allocator
-    // that does default initialisation, instead of
-    // value initialisation.
-    ::std::vector<decltype(v.size())> ret;
+    // NOTE: use an allocator that does default initialisation,
+    // instead of value initialisation, as we will be
+    // overwriting the values anyway.
+    using idx_t = decltype(v.size());
+    ::std::vector<idx_t, ::obake::detail::default_init_allocator<idx_t>> ret;
     ret.resize(::obake::safe_cast<decltype(ret.size())>(v.size()));
 
     ::tbb::parallel_for(::tbb::blocked_range<decltype(v.size())>(0, v.size()), [&ret](const auto &range) {
@@ -793,18 +814,394 @@ inline auto poly_mul_estimate_product_size(const ::std::vector<T1> &x, const ::s
     }
 }
 
-// The multi-threaded homomorphic implementation.
-template <typename Ret, typename T, typename U, typename... Args>
-inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args &...args)
+// Meta-programming to establish if the multiplication algorithms
+// based on the Kronecker encoding of the bounding box of the product
+// (i.e., the dense, heap-based, Kronecker substitution and FFT algorithms) can be used to compute
+// polynomial products with return type Ret. The requirements are:
+// - the key type must expose an integral value_type for its exponents,
+// - the key must be unpackable into an array of exponents,
+// - the key must be constructible from a pointer to an array
+//   of exponents and the array size.
+template <typename T>
+using poly_mul_kbox_expo_t = typename T::value_type;
+
+template <typename Ret>
+constexpr bool poly_mul_kbox_algorithm_impl()
+{
+    using ret_key_t = series_key_t<Ret>;
+    using expo_t = detected_t<poly_mul_kbox_expo_t, ret_key_t>;
+
+    if constexpr (is_integral_v<expo_t>) {
+        return ::std::conjunction_v<is_unpackable_monomial<expo_t *, const ret_key_t &>,
+                                    ::std::is_constructible<ret_key_t, const expo_t *, unsigned>>;
+    } else {
+        return false;
+    }
+}
+
+template <typename Ret>
+inline constexpr bool poly_mul_kbox_algo = detail::poly_mul_kbox_algorithm_impl<Ret>();
+
+// Kronecker encoding of the bounding box of a polynomial product.
+//
+// Each monomial in the bounding box of the exponents of the product
+// is mapped to an offset in the [0, size) range via a mixed-radix
+// encoding which, being linear in the exponents, guarantees that the offset
+// of the product of two monomials is the sum of the offsets of the factors.
+// In other words, the offsets are (compact) Kronecker codes, and their
+// ordering is compatible with monomial multiplication.
+template <typename Expo, typename Cf1, typename Cf2>
+struct poly_mul_kbox {
+    // The offsets of the terms of the two operands,
+    // paired to pointers to their coefficients and
+    // sorted in ascending order.
+    ::std::vector<::std::pair<::std::size_t, const Cf1 *>> ov1;
+    ::std::vector<::std::pair<::std::size_t, const Cf2 *>> ov2;
+    // The exponents of the monomial at offset zero.
+    ::std::vector<Expo> lo;
+    // The dimensions of the box and the strides
+    // of the encoding.
+    ::std::vector<::std::size_t> dims, strides;
+    // The total number of monomials in the box.
+    ::std::size_t size = 0;
+
+    // Decode the offset off into the exponents of
+    // a monomial, which will be written into out.
+    void decode(Expo *out, ::std::size_t off) const
+    {
+        assert(off < size);
+
+        for (decltype(lo.size()) j = 0; j < lo.size(); ++j) {
+            out[j] = static_cast<Expo>(lo[j] + static_cast<Expo>((off / strides[j]) % dims[j]));
+        }
+    }
+};
+
+// Setup the Kronecker encoding kb of the bounding box of the
+// product of the polynomials whose terms are in the ranges r1 and r2.
+// If the number of monomials in the box is greater than max_size, or it
+// does not fit in std::size_t, kb will be left in an unspecified state and
+// false will be returned.
+// NOTE: requires r1 and r2 to be non-empty, the monomials to be compatible with ss
+// and the monomial overflow check to have passed.
+template <typename Expo, typename Cf1, typename Cf2, typename R1, typename R2>
+inline bool poly_mul_kbox_init(poly_mul_kbox<Expo, Cf1, Cf2> &kb, const R1 &r1, const R2 &r2, const symbol_set &ss,
+                               const ::mppp::integer<1> &max_size)
+{
+    assert(!r1.empty());
+    assert(!r2.empty());
+
+    // Cache the number of variables.
+    const auto n_vars = ss.size();
+
+    // Helper to unpack the exponents of the terms in r into a flat
+    // vector, and to compute the minimum/maximum exponent for each variable.
+    auto unpack = [&ss, n_vars](const auto &r, auto &vexpo, auto &lo, auto &hi) {
+        vexpo.resize(::obake::safe_cast<decltype(vexpo.size())>(::mppp::integer<1>(r.size()) * n_vars));
+        lo.resize(::obake::safe_cast<decltype(lo.size())>(n_vars));
+        hi.resize(::obake::safe_cast<decltype(hi.size())>(n_vars));
+
+        decltype(vexpo.size()) i = 0;
+        for (const auto &t : r) {
+            const auto ptr = vexpo.data() + i * n_vars;
+            ::obake::monomial_unpack(ptr, t.first, ss);
+
+            for (decltype(ss.size()) j = 0; j < n_vars; ++j) {
+                if (i == 0u) {
+                    lo[j] = ptr[j];
+                    hi[j] = ptr[j];
+                } else {
+                    lo[j] = ::std::min(lo[j], ptr[j]);
+                    hi[j] = ::std::max(hi[j], ptr[j]);
+                }
+            }
+
+            ++i;
+        }
+    };
+
+    ::std::vector<Expo> vexpo1, vexpo2, lo1, lo2, hi1, hi2;
+    ::tbb::parallel_invoke([&unpack, &r1, &vexpo1, &lo1, &hi1]() { unpack(r1, vexpo1, lo1, hi1); },
+                           [&unpack, &r2, &vexpo2, &lo2, &hi2]() { unpack(r2, vexpo2, lo2, hi2); });
+
+    // Compute the dimensions of the bounding box of the product,
+    // the strides of the mixed-radix encoding and the total number
+    // of elements in the bounding box.
+    kb.dims.resize(::obake::safe_cast<decltype(kb.dims.size())>(n_vars));
+    kb.strides.resize(::obake::safe_cast<decltype(kb.strides.size())>(n_vars));
+    ::mppp::integer<1> box_size(1);
+    for (decltype(ss.size()) j = 0; j < n_vars; ++j) {
+        const auto d = ::mppp::integer<1>(hi1[j]) - lo1[j] + hi2[j] - lo2[j] + 1;
+
+        // NOTE: here box_size is guaranteed to fit in std::size_t,
+        // as we check below that the final box_size does.
+        kb.strides[j] = static_cast<::std::size_t>(box_size);
+        box_size *= d;
+
+        if (box_size > max_size || box_size > ::obake::detail::limits_max<::std::size_t>) {
+            // The bounding box is too large, bail out.
+            return false;
+        }
+
+        kb.dims[j] = static_cast<::std::size_t>(d);
+    }
+    kb.size = static_cast<::std::size_t>(box_size);
+
+    // Helper to compute the vector of offsets of the terms in r
+    // into the bounding box, paired to pointers to the coefficients.
+    // The vector is then sorted according to the offsets.
+    // NOTE: because the bounding box fits in std::size_t, none
+    // of the computations below can overflow.
+    auto make_ovec = [n_vars, &kb](const auto &r, const auto &vexpo, const auto &lo, auto &ov) {
+        ov.clear();
+        ov.reserve(::obake::safe_cast<decltype(ov.size())>(r.size()));
+
+        decltype(vexpo.size()) i = 0;
+        for (const auto &t : r) {
+            const auto ptr = vexpo.data() + i * n_vars;
+
+            ::std::size_t off = 0;
+            for (::std::remove_const_t<decltype(n_vars)> j = 0; j < n_vars; ++j) {
+                off += static_cast<::std::size_t>(ptr[j] - lo[j]) * kb.strides[j];
+            }
+
+            ov.emplace_back(off, &t.second);
+
+            ++i;
+        }
+
+        ::tbb::parallel_sort(ov.begin(), ov.end(), [](const auto &p1, const auto &p2) { return p1.first < p2.first; });
+    };
+
+    ::tbb::parallel_invoke([&make_ovec, &kb, &r1, &vexpo1, &lo1]() { make_ovec(r1, vexpo1, lo1, kb.ov1); },
+                           [&make_ovec, &kb, &r2, &vexpo2, &lo2]() { make_ovec(r2, vexpo2, lo2, kb.ov2); });
+
+    // The exponents of the monomial at offset zero in the bounding box.
+    kb.lo.resize(::obake::safe_cast<decltype(kb.lo.size())>(n_vars));
+    for (decltype(ss.size()) j = 0; j < n_vars; ++j) {
+        // NOTE: the monomial overflow check ensures that
+        // this cannot overflow.
+        kb.lo[j] = static_cast<Expo>(lo1[j] + lo2[j]);
+    }
+
+    return true;
+}
+
+// Dense multiplication via flat array accumulation.
+//
+// The term-by-term products are mapped into the Kronecker-encoded
+// bounding box of the product (see poly_mul_kbox). The offset
+// range is then split into chunks which are processed in parallel:
+// each chunk accumulates the term-by-term products into a small contiguous
+// buffer (with no hashing or probing), and at the end the nonzero
+// entries of the buffer are converted back to terms and
+// inserted into retval.
+//
+// v1 and v2 are the input terms (as vectors of pairs), est_nterms
+// the estimated number of terms in the product, mp the multiplication
+// policy (from which the tuning parameters are read). The return
+// value signals whether the dense multiplication was actually performed:
+// if the bounding box turns out to be too large with respect to
+// the estimated size of the product, nothing is done and false is returned.
+template <typename Ret, typename T1, typename T2>
+inline bool poly_mul_impl_mt_dense(Ret &retval, const ::std::vector<T1> &v1, const ::std::vector<T2> &v2,
+                                   const ::mppp::integer<1> &est_nterms, const mul_policy &mp)
 {
-    using cf1_t = series_cf_t<T>;
-    using cf2_t = series_cf_t<U>;
     using ret_key_t = series_key_t<Ret>;
     using ret_cf_t = series_cf_t<Ret>;
+    using cf1_t = typename T1::second_type;
+    using cf2_t = typename T2::second_type;
+    using expo_t = typename ret_key_t::value_type;
     using s_size_t = typename Ret::s_size_type;
 
     // Preconditions.
-    static_assert(sizeof...(args) <= 2u);
+    static_assert(poly_mul_kbox_algo<Ret>);
+    assert(!v1.empty());
+    assert(!v2.empty());
+    assert(retval.empty());
+
+    // The maximum ratio between the number of elements in the bounding
+    // box and the estimated number of terms in the product. Above this
+    // ratio, the dense representation is deemed too wasteful.
+    // NOTE: the default value is chosen so that the product of dense polynomials
+    // with total degree bounded exponents in a handful of variables (i.e.,
+    // polynomials whose exponents fill a simplex rather than
+    // the whole bounding box) is still handled by the dense algorithm.
+    const auto max_box_ratio = mp.dense_max_box_ratio;
+    // The size of the chunks in bytes.
+    // NOTE: the idea is to have the accumulation buffer
+    // fit comfortably in L2 cache.
+    const auto chunk_size = mp.dense_chunk_size;
+
+    // Cache the symbol set and its size.
+    const auto &ss = retval.get_symbol_set();
+    const auto n_vars = ss.size();
+
+    // Setup the Kronecker encoding of the bounding box.
+    poly_mul_kbox<expo_t, cf1_t, cf2_t> kb;
+    if (!detail::poly_mul_kbox_init(kb, v1, v2, ss, max_box_ratio * est_nterms)) {
+        return false;
+    }
+    const auto box = kb.size;
+    const auto &ov1 = kb.ov1;
+    const auto &ov2 = kb.ov2;
+
+    // Compute the number of elements in a chunk and the number of chunks.
+    const auto chunk_len = ::std::max(::std::size_t(1), chunk_size / sizeof(ret_cf_t));
+    const auto n_chunks = box / chunk_len + static_cast<::std::size_t>(box % chunk_len != 0u);
+
+    // Cache the number of segments in retval, and
+    // prepare the array of flags which will be used to
+    // lock the segments during term insertion.
+    auto &s_table = retval._get_s_table();
+    const auto nsegs = static_cast<s_size_t>(s_table.size());
+    ::obake::detail::atomic_flag_array sl(nsegs);
+
+    try {
+        ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, n_chunks), [&](const auto &range) {
+            // The accumulation buffer, and a vector of flags
+            // signalling which elements of the buffer have been
+            // written to.
+            ::std::vector<ret_cf_t> buf(chunk_len);
+            ::std::vector<unsigned char> written(chunk_len);
+
+            // Temporary vector of exponents for the conversion
+            // of offsets into monomials.
+            ::std::vector<expo_t> tmp_expo(kb.lo);
+
+            // The terms produced in the current chunk, paired
+            // to the index of their destination segment.
+            ::std::vector<::std::tuple<s_size_t, ret_key_t, ret_cf_t>> out_terms;
+
+            for (auto c_idx = range.begin(); c_idx != range.end(); ++c_idx) {
+                // The offset range of the current chunk.
+                const auto c_begin = c_idx * chunk_len;
+                const auto c_end = ::std::min(box, c_begin + chunk_len);
+
+                // Perform all the term-by-term multiplications whose
+                // result falls within the current chunk. ov1 and ov2 are
+                // both sorted by offset: for increasing offsets in ov1, the range of
+                // offsets in ov2 which end up in the chunk moves towards
+                // the beginning of ov2, thus we can keep track of it
+                // with two monotonically-decreasing indices.
+                auto j_begin = ov2.size(), j_end = ov2.size();
+                for (const auto &[off1, c1_ptr] : ov1) {
+                    if (off1 >= c_end) {
+                        // No more terms from ov1 can end
+                        // up in the current chunk.
+                        break;
+                    }
+
+                    while (j_end > 0u && ov2[j_end - 1u].first + off1 >= c_end) {
+                        --j_end;
+                    }
+                    while (j_begin > 0u && ov2[j_begin - 1u].first + off1 >= c_begin) {
+                        --j_begin;
+                    }
+
+                    const auto &c1 = *c1_ptr;
+                    for (auto j = j_begin; j < j_end; ++j) {
+                        const auto idx = ov2[j].first + off1 - c_begin;
+                        const auto &c2 = *ov2[j].second;
+
+                        if (written[idx]) {
+                            // NOTE: do it with fma3(), if possible.
+                            if constexpr (is_mult_addable_v<ret_cf_t &, const cf1_t &, const cf2_t &>) {
+                                ::obake::fma3(buf[idx], c1, c2);
+                            } else {
+                                buf[idx] += c1 * c2;
+                            }
+                        } else {
+                            // NOTE: coefficients are guaranteed to be move-assignable.
+                            buf[idx] = c1 * c2;
+                            written[idx] = 1;
+                        }
+                    }
+                }
+
+                // Convert the nonzero elements of the buffer into terms.
+                for (::std::size_t idx = 0; idx < c_end - c_begin; ++idx) {
+                    if (!written[idx]) {
+                        continue;
+                    }
+                    written[idx] = 0;
+
+                    if (obake_unlikely(::obake::is_zero(::std::as_const(buf[idx])))) {
+                        continue;
+                    }
+
+                    // Decode the offset into the exponents.
+                    kb.decode(tmp_expo.data(), c_begin + idx);
+
+                    ret_key_t key(::std::as_const(tmp_expo).data(), static_cast<unsigned>(n_vars));
+                    const auto seg_idx = static_cast<s_size_t>(::obake::hash(::std::as_const(key)) & (nsegs - 1u));
+                    out_terms.emplace_back(seg_idx, ::std::move(key), ::std::move(buf[idx]));
+                }
+
+                // Sort the terms according to the destination segment,
+                // and insert them into retval, locking each segment only once.
+                ::std::sort(out_terms.begin(), out_terms.end(),
+                            [](const auto &t1, const auto &t2) { return ::std::get<0>(t1) < ::std::get<0>(t2); });
+                for (auto it = out_terms.begin(); it != out_terms.end();) {
+                    const auto seg_idx = ::std::get<0>(*it);
+
+                    ::obake::detail::atomic_lock_guard lock(sl[seg_idx]);
+
+                    for (; it != out_terms.end() && ::std::get<0>(*it) == seg_idx; ++it) {
+                        // NOTE: all the monomials in the product are unique
+                        // and the coefficients are nonzero.
+                        ::obake::detail::series_add_term_table<true, ::obake::detail::sat_check_zero::off,
+                                                               ::obake::detail::sat_check_compat_key::off,
+                                                               ::obake::detail::sat_check_table_size::on,
+                                                               ::obake::detail::sat_assume_unique::on>(
+                            retval, s_table[seg_idx], ::std::move(::std::get<1>(*it)),
+                            ::std::move(::std::get<2>(*it)));
+                    }
+                }
+                out_terms.clear();
+            }
+        });
+        // LCOV_EXCL_START
+    } catch (...) {
+        // In case of exceptions, clear retval before
+        // rethrowing to ensure a known sane state.
+        retval.clear();
+        throw;
+        // LCOV_EXCL_STOP
+    }
+
+    return true;
+}
+
+// Heap-based multiplication (Monagan-Pearce).
+//
+// The terms of x and y are ordered according to their offsets
+// in the Kronecker-encoded bounding box of the product (see poly_mul_kbox).
+// The term-by-term products are then generated in ascending order
+// by merging the streams x_i * y (one for each term x_i of x) via
+// a binary heap, so that products with identical monomials come
+// out consecutively and can be combined on the spot. Terms are thus
+// produced already sorted and fully accumulated, the working set is
+// limited to a heap of at most x.size() elements, and the output
+// table is accessed only once per term of the product (rather than once
+// per term-by-term multiplication). This is most useful for sparse and highly
+// rectangular products, in which the product series is large compared
+// to the amount of work performed.
+//
+// The return value signals whether the heap-based multiplication was actually
+// performed: if the bounding box of the product cannot be represented via
+// std::size_t offsets, nothing is done and false is returned.
+template <typename Ret, typename T, typename U>
+inline bool poly_mul_impl_heap(Ret &retval, const T &x, const U &y)
+{
+    using ret_key_t = series_key_t<Ret>;
+    using ret_cf_t = series_cf_t<Ret>;
+    using cf1_t = series_cf_t<T>;
+    using cf2_t = series_cf_t<U>;
+    using expo_t = typename ret_key_t::value_type;
+
+    // Preconditions.
+    static_assert(poly_mul_kbox_algo<Ret>);
     assert(!x.empty());
     assert(!y.empty());
     assert(x.size() <= y.size());
@@ -816,157 +1213,1622 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
     // Cache the symbol set.
     const auto &ss = retval.get_symbol_set();
 
-    // Create vectors containing copies of
-    // the input terms.
-    // NOTE: in theory, it would be possible here
-    // to move the coefficients (in conjunction with
-    // rref_cleaner, as usual).
-    // NOTE: drop the const from the key type in order
-    // to allow mutability.
-    // NOTE: need to better assess the benefits of
-    // copying the input series.
-    ::std::vector<::std::pair<series_key_t<T>, cf1_t>> v1(
-        ::boost::make_transform_iterator(x.begin(), poly_mul_impl_pair_transform{}),
-        ::boost::make_transform_iterator(x.end(), poly_mul_impl_pair_transform{}));
-    ::std::vector<::std::pair<series_key_t<U>, cf2_t>> v2(
-        ::boost::make_transform_iterator(y.begin(), poly_mul_impl_pair_transform{}),
-        ::boost::make_transform_iterator(y.end(), poly_mul_impl_pair_transform{}));
-
-    // Do the monomial overflow checking, if supported.
-    // NOTE: we have to sequence the overflow checking before the product
-    // size estimation and the average term size estimation, as those two
-    // operations might generate overflows during monomial multiplication.
+    // Do the monomial overflow checking, if possible.
     const auto r1
-        = ::obake::detail::make_range(::boost::make_transform_iterator(v1.cbegin(), poly_term_key_ref_extractor{}),
-                                      ::boost::make_transform_iterator(v1.cend(), poly_term_key_ref_extractor{}));
+        = ::obake::detail::make_range(::boost::make_transform_iterator(x.begin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(x.end(), poly_term_key_ref_extractor{}));
     const auto r2
-        = ::obake::detail::make_range(::boost::make_transform_iterator(v2.cbegin(), poly_term_key_ref_extractor{}),
-                                      ::boost::make_transform_iterator(v2.cend(), poly_term_key_ref_extractor{}));
+        = ::obake::detail::make_range(::boost::make_transform_iterator(y.begin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(y.end(), poly_term_key_ref_extractor{}));
     if constexpr (are_overflow_testable_monomial_ranges_v<decltype(r1) &, decltype(r2) &>) {
-        // The monomial overflow checking is supported, run it.
         if (obake_unlikely(!::obake::monomial_range_overflow_check(r1, r2, ss))) {
-            obake_throw(::std::overflow_error, "An overflow in the monomial exponents was detected while "
-                                               "attempting to multiply two polynomials");
+            obake_throw(
+                ::std::overflow_error,
+                "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
         }
     }
 
-    // Estimate the total number of terms, and compute the total number
-    // of term-by-term multiplications.
-    // NOTE: poly_mul_estimate_product_size() requires the shorter series first,
-    // which is ensured by the preconditions of this function.
-    const auto [est_nterms, tot_n_mults] = detail::poly_mul_estimate_product_size<T, U>(v1, v2, ss, args...);
-    // Exit early if the truncation limits
-    // result in an empty output series.
-    if (sizeof...(Args) > 0u && tot_n_mults.is_zero()) {
-        return;
+    // Setup the Kronecker encoding of the bounding box.
+    poly_mul_kbox<expo_t, cf1_t, cf2_t> kb;
+    if (!detail::poly_mul_kbox_init(kb, x, y, ss, ::mppp::integer<1>(::obake::detail::limits_max<::std::size_t>))) {
+        return false;
     }
+    const auto &ov1 = kb.ov1;
+    const auto &ov2 = kb.ov2;
+
+    using idx_t = decltype(ov2.size());
+
+    // The heap. Each item contains the offset of the
+    // product x_i * y_j, and the indices i and j.
+    // NOTE: following Monagan and Pearce, the stream x_{i+1} * y
+    // is added to the heap only once the product x_i * y_0
+    // is extracted. Because the offsets are sorted, this guarantees that
+    // the heap never contains more than a single item per term of x.
+    ::std::vector<::std::tuple<::std::size_t, idx_t, idx_t>> heap;
+    heap.reserve(::obake::safe_cast<decltype(heap.size())>(ov1.size()));
+    // NOTE: we want the item with the smallest offset
+    // at the top of the heap.
+    auto heap_cmp = [](const auto &a, const auto &b) { return ::std::get<0>(a) > ::std::get<0>(b); };
+    heap.emplace_back(ov1[0].first + ov2[0].first, 0, 0);
+
+    // Helper to restore the heap property after the
+    // replacement of the item at the top of the heap.
+    // NOTE: this is cheaper than popping the top item
+    // and then pushing the replacement.
+    auto sift_down = [&heap]() {
+        const auto size = heap.size();
+        const auto item = heap.front();
+
+        decltype(heap.size()) cur = 0;
+        while (true) {
+            auto child = 2u * cur + 1u;
+            if (child >= size) {
+                break;
+            }
+            if (child + 1u < size && ::std::get<0>(heap[child + 1u]) < ::std::get<0>(heap[child])) {
+                ++child;
+            }
+            if (::std::get<0>(heap[child]) >= ::std::get<0>(item)) {
+                break;
+            }
+            heap[cur] = heap[child];
+            cur = child;
+        }
+        heap[cur] = item;
+    };
 
-    // Estimate the average term size.
-    // NOTE: once poly_mul_impl_estimate_average_term_size() becomes more computationally intensive,
-    // we can do it in parallel with poly_mul_estimate_product_size().
-    const auto avg_term_size = detail::poly_mul_impl_estimate_average_term_size<ret_cf_t>(v1, v2, ss);
+    // Temporary vector of exponents for the conversion
+    // of offsets into monomials.
+    ::std::vector<expo_t> tmp_expo(kb.lo);
 
-    // Compute the estimated sparsity.
-    const auto est_sp = static_cast<double>(est_nterms) / static_cast<double>(tot_n_mults);
+    // The accumulator for the coefficients.
+    ret_cf_t acc;
 
-    // Establish the desired segment size in kilobytes.
-    // NOTE: the idea here is the following. For highly
-    // sparse polynomials (est_sp >= threshold), we want to pick
-    // a relatively large size so that it fits somewhere in L2
-    // cache, say. The reason is that we won't do much computation
-    // per segment due to the sparsity, thus we aim at reducing
-    // the parallelisation overhead by operating on larger chunks
-    // of the product series. When the sparsity is smaller, then
-    // we have a higher computational density, thus we will spend
-    // more time computing a single segment, and thus we can aim
-    // at staying in L1 cache instead, as the parallelisation overhead
-    // will be smaller. Note that these values will be just rule-of-thumb,
-    // because the sparsity is not estimated accurately and because
-    // of further manipulations below. Additionally, it is not clear
-    // to me how smooth the transition between high and low sparsity
-    // will be. Eventually, we may perhaps want to leave this parameter as
-    // a tunable parameter for the user or perhaps even determine
-    // the cache sizes at runtime and use those.
-    // NOTE: if est_sp is not finite, due to tot_n_mults being zero or other
-    // FP issues, go with a default value.
-    // NOTE: is it worth it to exit early if tot_n_mults is zero? This would
-    // mean that the truncation limits will produce an empty series.
-    const auto seg_size = (!::std::isfinite(est_sp) || est_sp >= 1E-3) ? 200ul : 20ul;
+    auto &tab = retval._get_s_table()[0];
+    // NOTE: the product has usually at least as many
+    // terms as the longest operand.
+    tab.reserve(::obake::safe_cast<decltype(tab.size())>(ov2.size()));
 
-    // Estimate the number of segments via the deduced segment size.
-    const auto est_nsegs = (est_nterms * avg_term_size) / (seg_size * 1024ul);
+    try {
+        while (!heap.empty()) {
+            // Pop from the heap all the products with the
+            // smallest offset, accumulating them into acc.
+            const auto cur_off = ::std::get<0>(heap.front());
+            bool first = true;
+
+            do {
+                const auto i = ::std::get<1>(heap.front()), j = ::std::get<2>(heap.front());
+
+                const auto &c1 = *ov1[i].second;
+                const auto &c2 = *ov2[j].second;
+
+                if (first) {
+                    // NOTE: coefficients are guaranteed to be move-assignable.
+                    acc = c1 * c2;
+                    first = false;
+                } else {
+                    // NOTE: do it with fma3(), if possible.
+                    if constexpr (is_mult_addable_v<ret_cf_t &, const cf1_t &, const cf2_t &>) {
+                        ::obake::fma3(acc, c1, c2);
+                    } else {
+                        acc += c1 * c2;
+                    }
+                }
 
-    // Fetch the base-2 logarithm + 1 of est_nsegs, making sure it does not
-    // overflow the max allowed value for the return polynomial type.
-    const auto log2_nsegs = ::std::min(::obake::safe_cast<unsigned>(est_nsegs.nbits()),
-                                       polynomial<ret_key_t, ret_cf_t>::get_max_s_size());
+                // Replace the top item with the next product
+                // in the stream x_i * y, if any, otherwise remove it.
+                if (j + 1u < ov2.size()) {
+                    heap.front() = ::std::make_tuple(ov1[i].first + ov2[j + 1u].first, i, j + 1u);
+                } else {
+                    heap.front() = heap.back();
+                    heap.pop_back();
+                }
+                if (!heap.empty()) {
+                    sift_down();
+                }
 
-    // Setup the number of segments in retval.
-    retval.set_n_segments(log2_nsegs);
+                // Start the stream x_{i+1} * y, if needed.
+                if (j == 0u && i + 1u < ov1.size()) {
+                    heap.emplace_back(ov1[i + 1u].first + ov2[0].first, i + 1u, 0);
+                    ::std::push_heap(heap.begin(), heap.end(), heap_cmp);
+                }
+            } while (!heap.empty() && ::std::get<0>(heap.front()) == cur_off);
+
+            if (!::obake::is_zero(::std::as_const(acc))) {
+                // Decode the offset into the exponents, and insert
+                // the new term.
+                kb.decode(tmp_expo.data(), cur_off);
+
+                // NOTE: all the monomials in the product are unique
+                // and retval is not segmented.
+                ::obake::detail::series_add_term_table<true, ::obake::detail::sat_check_zero::off,
+                                                       ::obake::detail::sat_check_compat_key::off,
+                                                       ::obake::detail::sat_check_table_size::off,
+                                                       ::obake::detail::sat_assume_unique::on>(
+                    retval, tab, ret_key_t(::std::as_const(tmp_expo).data(), static_cast<unsigned>(ss.size())),
+                    ::std::move(acc));
+            }
+        }
+        // LCOV_EXCL_START
+    } catch (...) {
+        // In case of exceptions, clear retval before
+        // rethrowing to ensure a known sane state.
+        retval.clear();
+        throw;
+        // LCOV_EXCL_STOP
+    }
 
-    // Cache the actual number of segments.
-    const auto nsegs = s_size_t(1) << log2_nsegs;
+    return true;
+}
 
-    // Helper to sort the input terms according to the hash value modulo
-    // 2**log2_nsegs. That is, sort them according to the bucket
-    // they would occupy in a segmented table with 2**log2_nsegs
-    // segments.
-    auto t_sorter = [log2_nsegs](const auto &p1, const auto &p2) {
-        const auto h1 = ::obake::hash(p1.first);
-        const auto h2 = ::obake::hash(p2.first);
+// Cost model for the selection of the heap-based multiplication algorithm
+// for the product of two polynomials with n1 and n2 terms (n1 <= n2).
+//
+// The heap-based algorithm performs O(log2(n1)) heap operations per term-by-term
+// multiplication on a working set of n1 items, and it accesses the output table only
+// once per term of the product. The hash-based algorithms, on the other hand, access
+// the output table once per term-by-term multiplication. The heap-based algorithm
+// is thus selected for highly rectangular products (i.e., n2 / n1 >= mp.heap_min_ratio)
+// in which the shorter operand is small enough to keep the heap shallow
+// (i.e., n1 <= mp.heap_max_size) and the longer operand is large enough
+// for the output table not to fit in cache (i.e., n2 >= mp.heap_min_size).
+// NOTE: the heap-based algorithm is not worth it
+// for single-term polynomials.
+inline bool poly_mul_heap_cost_model(::std::size_t n1, ::std::size_t n2, const mul_policy &mp)
+{
+    assert(n1 <= n2);
 
-        return h1 % (s_size_t(1) << log2_nsegs) < h2 % (s_size_t(1) << log2_nsegs);
-    };
+    return n1 >= 2u && n1 <= mp.heap_max_size && n2 >= mp.heap_min_size && n2 / n1 >= mp.heap_min_ratio;
+}
 
-    // Helper to compute the segmentation for the input series.
-    // The segmentation is a vector of ranges (represented
-    // as pairs of indices into v1/v2) paired to indices
-    // representing the bucket that the range
-    // would occupy in a segmented table
-    // with 2**log2_nsegs segments.
-    auto compute_vseg = [nsegs, log2_nsegs](const auto &v) {
-        // Ensure that the size of v is representable by
-        // its iterator's diff type. We need to do some
-        // iterator arithmetics below.
-        ::obake::detail::container_it_diff_check(v);
+// Meta-programming to establish if the Kronecker substitution
+// algorithm can be used to compute the product of polynomials
+// with coefficient types Cf1 and Cf2 and return type Ret.
+// The requirements are:
+// - the Kronecker encoding of the bounding box of the product
+//   must be available (see poly_mul_kbox_algo),
+// - the coefficient types of the operands and of the return
+//   type must all be the same mp++ integer type.
+template <typename Ret, typename Cf1, typename Cf2>
+inline constexpr bool poly_mul_kronecker_algo
+    = ::std::conjunction_v<::std::bool_constant<poly_mul_kbox_algo<Ret>>,
+                           ::obake::detail::is_mppp_integer<series_cf_t<Ret>>, ::std::is_same<series_cf_t<Ret>, Cf1>,
+                           ::std::is_same<series_cf_t<Ret>, Cf2>>;
+
+// The number of slots below which the packing/unpacking
+// of the Kronecker substitution is performed sequentially.
+inline constexpr ::std::size_t poly_mul_kronecker_seq_size = 16;
+
+// The number of slots above which the packing/unpacking
+// of the Kronecker substitution is parallelised.
+inline constexpr ::std::size_t poly_mul_kronecker_par_size = 4096;
+
+// Pack the coefficients in the range [b, e) of a vector of offsets paired
+// to pointers to coefficients (sorted by offset, see poly_mul_kbox) into
+// the integer sum_i c_i * 2**(n_bits * (off_i - off_b)).
+// NOTE: the range must not be empty, and the offsets must be such
+// that the bit shifts do not overflow std::size_t.
+template <typename Int, typename It>
+inline Int poly_mul_kronecker_pack(It b, It e, ::std::size_t n_bits)
+{
+    assert(b != e);
+
+    const auto n = static_cast<::std::size_t>(e - b);
+
+    if (n <= poly_mul_kronecker_seq_size) {
+        // Horner scheme, starting from the highest offset.
+        auto it = e - 1;
+        Int retval(*it->second);
+        while (it != b) {
+            const auto prev = it - 1;
+            retval <<= (it->first - prev->first) * n_bits;
+            retval += *prev->second;
+            it = prev;
+        }
 
-        using idx_t = decltype(v.size());
-        ::std::vector<::std::tuple<idx_t, idx_t, s_size_t>> vseg;
-        // NOTE: the max possible size of vseg is the number of segments.
-        vseg.reserve(::obake::safe_cast<decltype(vseg.size())>(nsegs));
+        return retval;
+    }
 
-        const auto v_begin = v.begin(), v_end = v.end();
+    // Divide and conquer: pack separately the lower and upper
+    // halves, and then shift the upper half into place.
+    const auto mid = b + static_cast<decltype(e - b)>(n / 2u);
+    Int lo, hi;
+    if (n > poly_mul_kronecker_par_size) {
+        ::tbb::parallel_invoke([&lo, b, mid, n_bits]() { lo = detail::poly_mul_kronecker_pack<Int>(b, mid, n_bits); },
+                               [&hi, mid, e, n_bits]() { hi = detail::poly_mul_kronecker_pack<Int>(mid, e, n_bits); });
+    } else {
+        lo = detail::poly_mul_kronecker_pack<Int>(b, mid, n_bits);
+        hi = detail::poly_mul_kronecker_pack<Int>(mid, e, n_bits);
+    }
+    hi <<= (mid->first - b->first) * n_bits;
+    lo += hi;
 
-        // NOTE: if the number of terms in v is small enough,
-        // compute a sparse representation of vseg (meaning that
-        // the number of segmentation ranges will be less than
-        // nsegs and all the ranges will be non-empty). Otherwise,
-        // compute a dense representation, where the number
-        // of ranges is equal to nsegs and empty ranges might
-        // be present. We will later run different parallel
-        // functors depending on whether we are in the sparse
-        // or dense case.
-        // NOTE: the idea here is that we want to run
-        // the sparse functor only in highly sparse cases,
-        // because otherwise the more complicated logic
-        // of the sparse functor carries a measurable performance
-        // penalty in the "mostly-dense" cases.
-        if (v.size() < nsegs / 2u) {
-            for (auto it = v_begin; it != v_end;) {
-                // Get the bucket index of the current term.
-                const auto cur_b_idx = static_cast<s_size_t>(::obake::hash(it->first) % (s_size_t(1) << log2_nsegs));
-                // Look for the first term whose bucket index is greater than cur_b_idx.
-                const auto range_end
-                    = ::std::upper_bound(it, v_end, cur_b_idx, [log2_nsegs](const auto &b_idx, const auto &p) {
-                          return b_idx < ::obake::hash(p.first) % (s_size_t(1) << log2_nsegs);
-                      });
-                // NOTE: because we are in the sparse representation case,
-                // range_end cannot be equal to it.
-                assert(range_end != it);
-                // Add the range to vseg.
-                // NOTE: the overflow check was done earlier.
-                vseg.emplace_back(static_cast<idx_t>(it - v_begin), static_cast<idx_t>(range_end - v_begin), cur_b_idx);
-                // Update 'it'.
+    return lo;
+}
+
+// Unpack into out the n coefficients (i.e., the base-2**n_bits
+// digits in balanced representation) of the Kronecker substitution c,
+// via divide and conquer.
+// NOTE: out must be zero-initialised, and the coefficients
+// must be less than 2**(n_bits - 1) in absolute value.
+template <typename Int>
+inline void poly_mul_kronecker_unpack_dc(Int *out, Int c, ::std::size_t n, ::std::size_t n_bits)
+{
+    assert(n > 0u);
+    assert(n_bits > 1u);
+
+    if (c.is_zero()) {
+        // Nothing to do, out is already zeroed.
+        return;
+    }
+
+    if (n <= poly_mul_kronecker_seq_size) {
+        const auto full = Int(1) << n_bits;
+        const auto half = Int(1) << (n_bits - 1u);
+        const auto mask = full - 1;
+
+        for (::std::size_t i = 0; i < n && !c.is_zero(); ++i) {
+            auto d = c & mask;
+            if (d >= half) {
+                d -= full;
+            }
+            // NOTE: after the subtraction of the digit,
+            // the right shift is exact.
+            c -= d;
+            c >>= n_bits;
+            out[i] = ::std::move(d);
+        }
+        assert(c.is_zero());
+
+        return;
+    }
+
+    // Extract the lower half in balanced representation (which,
+    // given the bounds on the digits, is exactly the value of the
+    // lower half of the digits), and then remove it from c in
+    // order to obtain the upper half.
+    const auto n_lo = n / 2u;
+    const auto lo_bits = n_lo * n_bits;
+    const auto full = Int(1) << lo_bits;
+    auto lo = c & (full - 1);
+    if (lo >= (Int(1) << (lo_bits - 1u))) {
+        lo -= full;
+    }
+    c -= lo;
+    c >>= lo_bits;
+
+    if (n > poly_mul_kronecker_par_size) {
+        ::tbb::parallel_invoke(
+            [out, &lo, n_lo, n_bits]() { detail::poly_mul_kronecker_unpack_dc(out, ::std::move(lo), n_lo, n_bits); },
+            [out, &c, n, n_lo, n_bits]() {
+                detail::poly_mul_kronecker_unpack_dc(out + n_lo, ::std::move(c), n - n_lo, n_bits);
+            });
+    } else {
+        detail::poly_mul_kronecker_unpack_dc(out, ::std::move(lo), n_lo, n_bits);
+        detail::poly_mul_kronecker_unpack_dc(out + n_lo, ::std::move(c), n - n_lo, n_bits);
+    }
+}
+
+// Unpack into out the n coefficients (i.e., the base-2**n_bits
+// digits in balanced representation) of the Kronecker substitution c.
+// NOTE: out must be zero-initialised, and the coefficients
+// must be less than 2**(n_bits - 1) in absolute value.
+template <typename Int>
+inline void poly_mul_kronecker_unpack(Int *out, Int c, ::std::size_t n, ::std::size_t n_bits)
+{
+    assert(n > 0u);
+    assert(n_bits > 1u);
+
+    if (n_bits + 1u >= static_cast<::std::size_t>(GMP_NUMB_BITS)) {
+        // The digits (plus the carry) do not fit in a
+        // limb, go with the divide and conquer implementation.
+        detail::poly_mul_kronecker_unpack_dc(out, ::std::move(c), n, n_bits);
+
+        return;
+    }
+
+    // The digits fit in a limb: read them directly off
+    // the limbs of |c|, in parallel. Denoting with f_i the i-th n_bits-wide
+    // bit field of |c|, the i-th digit is d_i = f_i + b_{i-1} - 2**n_bits * b_i,
+    // where b_i is the carry from the i-th digit. Because the digits are less
+    // than 2**(n_bits - 1) in absolute value, the carry b_i is just the top bit
+    // of f_i, and thus each digit can be computed independently of the others.
+    const auto v = c.get_mpz_view();
+    const ::mpz_srcptr ptr = v;
+    const auto sgn = mpz_sgn(ptr);
+    const auto n_limbs = static_cast<::std::size_t>(::mpz_size(ptr));
+    const auto limb_bits = static_cast<::std::size_t>(GMP_NUMB_BITS);
+    const auto mask = (::mp_limb_t(1) << n_bits) - 1u;
+
+    // Fetch the bit field starting at bit index pos.
+    auto field = [ptr, n_limbs, limb_bits, n_bits, mask](::std::size_t pos) {
+        const auto idx = pos / limb_bits, sh = pos % limb_bits;
+        if (idx >= n_limbs) {
+            return ::mp_limb_t(0);
+        }
+
+        auto ret = ::mpz_getlimbn(ptr, static_cast<::mp_size_t>(idx)) >> sh;
+        if (sh + n_bits > limb_bits && idx + 1u < n_limbs) {
+            ret |= ::mpz_getlimbn(ptr, static_cast<::mp_size_t>(idx + 1u)) << (limb_bits - sh);
+        }
+
+        return static_cast<::mp_limb_t>(ret & mask);
+    };
+
+    ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, n), [&](const auto &range) {
+        for (auto i = range.begin(); i != range.end(); ++i) {
+            const auto f = field(i * n_bits);
+            const auto cur_carry = static_cast<long long>(f >> (n_bits - 1u));
+            const auto prev_carry
+                = i == 0u ? 0ll : static_cast<long long>(field((i - 1u) * n_bits) >> (n_bits - 1u));
+
+            const auto d = static_cast<long long>(f) + prev_carry - (cur_carry << n_bits);
+            if (d != 0) {
+                out[i] = sgn < 0 ? -d : d;
+            }
+        }
+    });
+}
+
+// The state shared by the multiplication algorithms for polynomials
+// with multiprecision integral coefficients (see poly_mul_impl_int()).
+template <typename Expo, typename Cf1, typename Cf2>
+struct poly_mul_int_state {
+    // The Kronecker encoding of the bounding box of the product.
+    poly_mul_kbox<Expo, Cf1, Cf2> kb;
+    // The number of term-by-term multiplications.
+    ::mppp::integer<1> n_mults;
+    // The number of bits sufficient to represent any
+    // coefficient of the product (including the sign bit).
+    ::std::size_t n_bits = 0;
+    // The offsets of the terms of the product
+    // are in the [base, base + n_slots) range.
+    ::std::size_t base = 0;
+    ::std::size_t n_slots = 0;
+    // The size (in bytes) of the accumulation chunks
+    // of the multi-modular algorithm.
+    unsigned long chunk_size = 0;
+};
+
+// Convert the nonzero coefficients in slots (which correspond to the
+// offsets in the [base, base + slots.size()) range of the Kronecker-encoded
+// bounding box kb) into terms of retval. The coefficients are moved out of slots.
+// NOTE: retval must be empty and not segmented.
+template <typename Ret, typename KBox, typename V>
+inline void poly_mul_kbox_insert_slots(Ret &retval, const KBox &kb, ::std::size_t base, V &slots)
+{
+    using ret_key_t = series_key_t<Ret>;
+    using expo_t = typename ret_key_t::value_type;
+
+    assert(retval.empty());
+    assert(retval._get_s_table().size() == 1u);
+
+    const auto n_vars = static_cast<unsigned>(retval.get_symbol_set().size());
+    ::std::vector<expo_t> tmp_expo(kb.lo);
+    auto &tab = retval._get_s_table()[0];
+    tab.reserve(::obake::safe_cast<decltype(tab.size())>(::std::count_if(
+        slots.begin(), slots.end(), [](const auto &c) { return !::obake::is_zero(::std::as_const(c)); })));
+
+    try {
+        for (decltype(slots.size()) i = 0; i < slots.size(); ++i) {
+            if (::obake::is_zero(::std::as_const(slots[i]))) {
+                continue;
+            }
+
+            kb.decode(tmp_expo.data(), base + i);
+
+            // NOTE: all the monomials in the product are unique
+            // and retval is not segmented.
+            ::obake::detail::series_add_term_table<true, ::obake::detail::sat_check_zero::off,
+                                                   ::obake::detail::sat_check_compat_key::off,
+                                                   ::obake::detail::sat_check_table_size::off,
+                                                   ::obake::detail::sat_assume_unique::on>(
+                retval, tab, ret_key_t(::std::as_const(tmp_expo).data(), n_vars), ::std::move(slots[i]));
+        }
+        // LCOV_EXCL_START
+    } catch (...) {
+        // In case of exceptions, clear retval before
+        // rethrowing to ensure a known sane state.
+        retval.clear();
+        throw;
+        // LCOV_EXCL_STOP
+    }
+}
+
+// Multiplication via Kronecker substitution.
+//
+// The coefficients of the operands are packed into two large integers,
+// with each offset in the Kronecker-encoded bounding box of the product
+// (see poly_mul_kbox) occupying a slot of st.n_bits bits. Because the slots
+// are wide enough to contain any coefficient of the product, the coefficients of
+// the product can be read off the slots of the product of the two large integers.
+// In other words, the polynomial product is reduced to a single multiprecision
+// integer multiplication, which, for large operands, is performed by GMP via
+// asymptotically fast algorithms.
+//
+// The coefficients may be negative: they are packed via shifts and signed
+// additions, and they are unpacked as digits in balanced representation.
+//
+// If Sqr is true, the product of the packed integer by itself will be computed.
+//
+// The return value signals whether the multiplication was actually
+// performed: if the packed integers are too large to be addressed
+// via std::size_t bit counts, nothing is done and false is returned.
+template <bool Sqr, typename Ret, typename State>
+inline bool poly_mul_kronecker(Ret &retval, const State &st)
+{
+    using ret_cf_t = series_cf_t<Ret>;
+
+    const auto &ov1 = st.kb.ov1;
+    const auto &ov2 = st.kb.ov2;
+    const auto n_bits = st.n_bits;
+
+    // Check that the bit counts fit in std::size_t.
+    if (::mppp::integer<1>(st.n_slots) * n_bits > ::obake::detail::limits_max<::std::size_t>) {
+        return false;
+    }
+
+    // Pack the operands and multiply them.
+    ret_cf_t prod;
+    if constexpr (Sqr) {
+        const auto a = detail::poly_mul_kronecker_pack<ret_cf_t>(ov1.begin(), ov1.end(), n_bits);
+        ::mppp::mul(prod, a, a);
+    } else {
+        ret_cf_t a, b;
+        ::tbb::parallel_invoke(
+            [&a, &ov1, n_bits]() { a = detail::poly_mul_kronecker_pack<ret_cf_t>(ov1.begin(), ov1.end(), n_bits); },
+            [&b, &ov2, n_bits]() { b = detail::poly_mul_kronecker_pack<ret_cf_t>(ov2.begin(), ov2.end(), n_bits); });
+        ::mppp::mul(prod, a, b);
+    }
+
+    // Unpack the product and convert it into terms.
+    ::std::vector<ret_cf_t> slots(::obake::safe_cast<typename ::std::vector<ret_cf_t>::size_type>(st.n_slots));
+    detail::poly_mul_kronecker_unpack(slots.data(), ::std::move(prod), st.n_slots, n_bits);
+    detail::poly_mul_kbox_insert_slots(retval, st.kb, st.base, slots);
+
+    return true;
+}
+
+// The number of bits of the primes used by the multi-modular
+// multiplication algorithm (see ::obake::detail::modular_primes()),
+// rounded down.
+inline constexpr ::std::size_t poly_mul_crt_prime_bits = 61;
+
+// Compute the residue of the multiprecision integer n modulo p.
+template <typename Int>
+inline ::std::uint64_t poly_mul_crt_reduce(const Int &n, ::std::uint64_t p)
+{
+    const auto v = n.get_mpz_view();
+    const ::mpz_srcptr ptr = v;
+    const auto n_limbs = ::mpz_size(ptr);
+
+    // Horner scheme on the limbs of |n|, starting from the most significant one.
+    ::std::uint64_t r = 0;
+    for (auto i = n_limbs; i > 0u; --i) {
+        r = static_cast<::std::uint64_t>(
+            ((::absl::uint128(r) << GMP_NUMB_BITS) + ::mpz_getlimbn(ptr, static_cast<::mp_size_t>(i - 1u))) % p);
+    }
+
+    return (mpz_sgn(ptr) < 0 && r != 0u) ? p - r : r;
+}
+
+// Multi-modular multiplication.
+//
+// The product is computed modulo several word-sized primes, whose product is larger
+// than twice the bound on the absolute value of the coefficients of the product.
+// Each modular image of the product is accumulated with word-sized Montgomery arithmetic
+// into a dense buffer indexed by the offsets in the Kronecker-encoded bounding box of
+// the product (see poly_mul_kbox). The buffer is split into chunks, and each
+// (prime, chunk) pair is processed by a separate parallel task.
+// The coefficients of the product are then reconstructed from their residues
+// via the Chinese remainder theorem (in Garner's mixed-radix form), and mapped
+// to the symmetric range.
+//
+// If Sqr is true, only the term-by-term products x_i * x_j with i <= j are
+// computed, and the off-diagonal products are doubled.
+//
+// The return value signals whether the multiplication was actually
+// performed: if the coefficients of the product are too large for the
+// available primes, nothing is done and false is returned.
+template <bool Sqr, typename Ret, typename State>
+inline bool poly_mul_crt(Ret &retval, const State &st)
+{
+    using ret_cf_t = series_cf_t<Ret>;
+
+    const auto &ov1 = st.kb.ov1;
+    const auto &ov2 = st.kb.ov2;
+    const auto n_slots = st.n_slots;
+
+    // The size (in bytes) of the accumulation chunks.
+    const auto chunk_size = st.chunk_size;
+
+    // Determine the number of primes. Each prime is greater than
+    // 2**poly_mul_crt_prime_bits, and the product of the primes must be greater
+    // than 2**n_bits (i.e., twice the bound on the absolute values of the coefficients).
+    const auto n_primes = st.n_bits / poly_mul_crt_prime_bits + 1u;
+    if (n_primes > ::obake::detail::modular_primes_size) {
+        return false;
+    }
+    const auto &primes = ::obake::detail::modular_primes();
+
+    // Setup the moduli.
+    ::std::vector<::obake::detail::montgomery_modulus> mods;
+    mods.reserve(n_primes);
+    for (::std::size_t k = 0; k < n_primes; ++k) {
+        mods.emplace_back(primes[k]);
+    }
+
+    // The offsets of the terms of the operands,
+    // relative to the first term of each operand.
+    // NOTE: the sum of two relative offsets
+    // is an index into the [0, n_slots) range.
+    auto rel_offsets = [](const auto &ov) {
+        ::std::vector<::std::size_t> ret;
+        ret.reserve(ov.size());
+        for (const auto &t : ov) {
+            ret.push_back(t.first - ov.front().first);
+        }
+        return ret;
+    };
+    const auto o1 = rel_offsets(ov1);
+    const auto o2 = Sqr ? ::std::vector<::std::size_t>{} : rel_offsets(ov2);
+    const auto &oo2 = Sqr ? o1 : o2;
+    const auto n1 = o1.size(), n2 = oo2.size();
+
+    // Compute the residues of the coefficients of the operands (one row per prime).
+    // The residues of the first operand are converted to Montgomery representation:
+    // the Montgomery product of a number in Montgomery representation and a number in
+    // standard representation is in standard representation.
+    // NOTE: in squaring mode, the residues of the second
+    // operand are those of the first one.
+    ::std::vector<::std::uint64_t> r1(n_primes * n1), r2(n_primes * n2);
+    ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, n_primes, 1), [&](const auto &range) {
+        for (auto k = range.begin(); k != range.end(); ++k) {
+            const auto &mm = mods[k];
+            const auto p = mm.get_p();
+
+            for (decltype(ov2.size()) j = 0; j < n2; ++j) {
+                r2[k * n2 + j] = detail::poly_mul_crt_reduce(Sqr ? *ov1[j].second : *ov2[j].second, p);
+            }
+
+            for (decltype(ov1.size()) i = 0; i < n1; ++i) {
+                r1[k * n1 + i] = Sqr ? mm.to_mont(r2[k * n2 + i])
+                                     : mm.to_mont(detail::poly_mul_crt_reduce(*ov1[i].second, p));
+            }
+        }
+    });
+
+    // The residues of the coefficients of the product (one row
+    // of n_slots elements per prime).
+    ::std::vector<::std::uint64_t> res(
+        ::obake::safe_cast<::std::vector<::std::uint64_t>::size_type>(::mppp::integer<1>(n_primes) * n_slots));
+
+    // Compute the modular images of the product. The slots range is split
+    // into chunks, and each (prime, chunk) pair is processed in parallel.
+    const auto chunk_len
+        = ::std::max(::std::size_t(1), static_cast<::std::size_t>(chunk_size / sizeof(::std::uint64_t)));
+    const auto n_chunks = n_slots / chunk_len + static_cast<::std::size_t>(n_slots % chunk_len != 0u);
+    const auto n_tasks = ::obake::safe_cast<::std::size_t>(::mppp::integer<1>(n_primes) * n_chunks);
+    ::tbb::parallel_for(
+        ::tbb::blocked_range<::std::size_t>(0, n_tasks),
+        [&](const auto &range) {
+            for (auto idx = range.begin(); idx != range.end(); ++idx) {
+                const auto k = idx / n_chunks;
+                const auto c_begin = (idx % n_chunks) * chunk_len;
+                const auto c_end = ::std::min(n_slots, c_begin + chunk_len);
+
+                const auto &mm = mods[k];
+                const auto buf = res.data() + k * n_slots;
+                const auto cr1 = r1.data() + k * n1;
+                const auto cr2 = r2.data() + k * n2;
+
+                // As in poly_mul_impl_mt_dense(), for increasing offsets in o1 the range
+                // of offsets in oo2 which end up in the chunk moves towards the beginning
+                // of oo2, thus we can keep track of it with two monotonically-decreasing indices.
+                auto j_begin = n2, j_end = n2;
+                for (decltype(o1.size()) i = 0; i < n1; ++i) {
+                    const auto off1 = o1[i];
+                    if (off1 >= c_end) {
+                        break;
+                    }
+
+                    while (j_end > 0u && oo2[j_end - 1u] + off1 >= c_end) {
+                        --j_end;
+                    }
+                    while (j_begin > 0u && oo2[j_begin - 1u] + off1 >= c_begin) {
+                        --j_begin;
+                    }
+
+                    const auto cur = buf + off1;
+                    auto a = cr1[i];
+
+                    if constexpr (Sqr) {
+                        // Only the products with j >= i are computed. The
+                        // diagonal product is counted once, the others twice.
+                        auto jb = ::std::max(j_begin, i);
+                        if (jb == i && i < j_end) {
+                            cur[oo2[i]] = mm.add(cur[oo2[i]], mm.mul(a, cr2[i]));
+                            ++jb;
+                        }
+                        a = mm.add(a, a);
+                        for (auto j = jb; j < j_end; ++j) {
+                            cur[oo2[j]] = mm.add(cur[oo2[j]], mm.mul(a, cr2[j]));
+                        }
+                    } else {
+                        for (auto j = j_begin; j < j_end; ++j) {
+                            cur[oo2[j]] = mm.add(cur[oo2[j]], mm.mul(a, cr2[j]));
+                        }
+                    }
+                }
+            }
+        });
+
+    // Precompute the inverses of p_i modulo p_j (for i < j)
+    // in Montgomery representation, for use in Garner's algorithm.
+    ::std::vector<::std::uint64_t> invs(n_primes * n_primes);
+    for (::std::size_t j = 0; j < n_primes; ++j) {
+        for (::std::size_t i = 0; i < j; ++i) {
+            invs[i * n_primes + j] = mods[j].to_mont(mods[j].inv(primes[i] % primes[j]));
+        }
+    }
+
+    // The product of the primes, and its half.
+    ret_cf_t m(1);
+    for (::std::size_t k = 0; k < n_primes; ++k) {
+        m *= primes[k];
+    }
+    const auto half_m = m >> 1;
+
+    // Reconstruct the coefficients.
+    ::std::vector<ret_cf_t> slots(::obake::safe_cast<typename ::std::vector<ret_cf_t>::size_type>(n_slots));
+    ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, n_slots), [&](const auto &range) {
+        // The mixed-radix digits.
+        ::std::vector<::std::uint64_t> v(n_primes);
+
+        for (auto s = range.begin(); s != range.end(); ++s) {
+            bool all_zero = true;
+            for (::std::size_t k = 0; k < n_primes && all_zero; ++k) {
+                all_zero = res[k * n_slots + s] == 0u;
+            }
+            if (all_zero) {
+                continue;
+            }
+
+            // Garner's algorithm: the coefficient is
+            // v_0 + v_1 * p_0 + v_2 * p_0 * p_1 + ...
+            for (::std::size_t j = 0; j < n_primes; ++j) {
+                const auto &mm = mods[j];
+                const auto p = mm.get_p();
+
+                auto t = res[j * n_slots + s];
+                for (::std::size_t i = 0; i < j; ++i) {
+                    // NOTE: all the primes are in the (2**61, 2**62) range,
+                    // thus v_i < 2 * p_j.
+                    const auto vi = v[i] >= p ? v[i] - p : v[i];
+                    t = mm.mul(mm.sub(t, vi), invs[i * n_primes + j]);
+                }
+                v[j] = t;
+            }
+
+            auto &c = slots[s];
+            c = v[n_primes - 1u];
+            for (auto i = n_primes - 1u; i > 0u; --i) {
+                c *= primes[i - 1u];
+                c += v[i - 1u];
+            }
+
+            // Map to the symmetric range.
+            if (c > half_m) {
+                c -= m;
+            }
+        }
+    });
+
+    // Convert the coefficients into terms.
+    detail::poly_mul_kbox_insert_slots(retval, st.kb, st.base, slots);
+
+    return true;
+}
+
+// The multiplication algorithms for polynomials
+// with multiprecision integral coefficients.
+enum class poly_mul_int_algorithm { automatic, kronecker, crt, none };
+
+// Cost model for the selection of the multiplication algorithm for polynomials
+// with multiprecision integral coefficients, for a product with n_mults
+// term-by-term multiplications whose terms fall in a range of n_slots offsets
+// in the bounding box. n_bits1 and n_bits2 are the bit sizes of the largest coefficients
+// of the operands, n_bits the bit size of the coefficients of the product.
+//
+// The model estimates the cost (in arbitrary units) of the Kronecker substitution,
+// of the multi-modular algorithm and of the other multiplication algorithms,
+// and it selects the cheapest of the first two, provided that it is clearly cheaper
+// than the last one. The constants are the ratios measured on a single core for products
+// of dense univariate and trivariate polynomials with coefficients from 20 to 200 bits:
+//
+// - the other algorithms cost ~40ns per term-by-term multiplication, plus ~2.5ns
+//   per product of limbs of the coefficients;
+// - the Kronecker substitution costs ~300ns per limb of the packed integers (the cost being
+//   dominated by the packing/unpacking of the coefficients, which is proportional to the size
+//   of the packed integers rather than to the number of term-by-term multiplications);
+// - the multi-modular algorithm costs ~3ns per term-by-term multiplication and per prime,
+//   plus ~30ns per slot and ~4ns per slot and per squared number of primes for the
+//   reconstruction of the coefficients via Garner's algorithm.
+//
+// If too many primes would be needed, the multi-modular algorithm is not considered.
+inline poly_mul_int_algorithm poly_mul_int_cost_model(const ::mppp::integer<1> &n_mults, ::std::size_t n_slots,
+                                                      ::std::size_t n_bits1, ::std::size_t n_bits2,
+                                                      ::std::size_t n_bits)
+{
+    using int_t = ::mppp::integer<1>;
+
+    const auto limb_bits = static_cast<::std::size_t>(GMP_NUMB_BITS);
+    auto n_limbs = [limb_bits](::std::size_t nb) {
+        return nb / limb_bits + static_cast<::std::size_t>(nb % limb_bits != 0u);
+    };
+
+    // NOTE: the costs are measured in units of 0.5ns.
+    const auto school_cost = n_mults * (int_t{80} + int_t{5} * n_limbs(n_bits1) * n_limbs(n_bits2));
+    const auto kron_cost = int_t{n_slots} * n_limbs(n_bits) * 600u;
+
+    auto algo = poly_mul_int_algorithm::kronecker;
+    auto cost = kron_cost;
+
+    const auto n_primes = n_bits / poly_mul_crt_prime_bits + 1u;
+    if (n_primes <= ::obake::detail::modular_primes_size) {
+        const auto crt_cost = n_mults * n_primes * 6u + int_t{n_slots} * (n_primes * n_primes * 8u + 60u);
+        if (crt_cost < cost) {
+            algo = poly_mul_int_algorithm::crt;
+            cost = crt_cost;
+        }
+    }
+
+    // NOTE: require a margin of 1.5 over the other algorithms, so that
+    // the inaccuracies of the model do not result in slowdowns.
+    return cost * 3u <= school_cost * 2u ? algo : poly_mul_int_algorithm::none;
+}
+
+// Multiplication of polynomials with multiprecision integral coefficients
+// via either the Kronecker substitution or the multi-modular algorithm. Both algorithms
+// operate on the Kronecker-encoded bounding box of the product (see poly_mul_kbox), and
+// they require the coefficients of the product to be bounded a priori: the bound is
+// min(n1, n2) * max|c1| * max|c2|.
+//
+// If Sqr is true, x and y must be the same object, and the squaring
+// mode of the selected algorithm will be used.
+//
+// The algorithm is selected by the cost model (see poly_mul_int_cost_model()), unless
+// algo is not poly_mul_int_algorithm::automatic. The return value signals whether the multiplication
+// was actually performed: if the cost model rejects both algorithms (or the bounding box of the product
+// is larger than the number of term-by-term multiplications), nothing is done and false is returned.
+// The tuning parameters are read from the multiplication policy mp.
+template <bool Sqr, typename Ret, typename T, typename U>
+inline bool poly_mul_impl_int(Ret &retval, const T &x, const U &y,
+                              poly_mul_int_algorithm algo = poly_mul_int_algorithm::automatic,
+                              const mul_policy &mp = polynomials::get_mul_policy())
+{
+    using expo_t = typename series_key_t<Ret>::value_type;
+
+    // Preconditions.
+    static_assert(poly_mul_kronecker_algo<Ret, series_cf_t<T>, series_cf_t<U>>);
+    assert(!x.empty());
+    assert(!y.empty());
+    assert(x.size() <= y.size());
+    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
+    assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
+    assert(retval.empty());
+    assert(retval._get_s_table().size() == 1u);
+    if constexpr (Sqr) {
+        assert(static_cast<const void *>(&x) == static_cast<const void *>(&y));
+    }
+
+    // Cache the symbol set.
+    const auto &ss = retval.get_symbol_set();
+
+    // Do the monomial overflow checking, if possible.
+    const auto r1
+        = ::obake::detail::make_range(::boost::make_transform_iterator(x.begin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(x.end(), poly_term_key_ref_extractor{}));
+    const auto r2
+        = ::obake::detail::make_range(::boost::make_transform_iterator(y.begin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(y.end(), poly_term_key_ref_extractor{}));
+    if constexpr (are_overflow_testable_monomial_ranges_v<decltype(r1) &, decltype(r2) &>) {
+        if (obake_unlikely(!::obake::monomial_range_overflow_check(r1, r2, ss))) {
+            obake_throw(
+                ::std::overflow_error,
+                "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+        }
+    }
+
+    // Setup the Kronecker encoding of the bounding box.
+    // NOTE: the cost model never accepts bounding boxes
+    // larger than the number of term-by-term multiplications.
+    poly_mul_int_state<expo_t, series_cf_t<T>, series_cf_t<U>> st;
+    st.n_mults = ::mppp::integer<1>(x.size()) * y.size();
+    if (!detail::poly_mul_kbox_init(st.kb, x, y, ss, st.n_mults)) {
+        return false;
+    }
+    const auto &ov1 = st.kb.ov1;
+    const auto &ov2 = st.kb.ov2;
+
+    // Compute the bit size of the coefficients of the product. The coefficients are bounded in
+    // absolute value by min(n1, n2) * max|c1| * max|c2|, and we need an extra bit for the sign.
+    auto max_nbits = [](const auto &ov) {
+        ::std::size_t ret = 0;
+        for (const auto &p : ov) {
+            ret = ::std::max(ret, static_cast<::std::size_t>(p.second->nbits()));
+        }
+        return ret;
+    };
+    const auto n_bits1 = max_nbits(ov1), n_bits2 = Sqr ? n_bits1 : max_nbits(ov2);
+    st.n_bits = n_bits1 + n_bits2 + static_cast<::std::size_t>(::std::bit_width(static_cast<::std::size_t>(ov1.size())))
+                + 1u;
+
+    st.base = ov1.front().first + ov2.front().first;
+    st.n_slots = ov1.back().first + ov2.back().first - st.base + 1u;
+
+    // NOTE: we re-use the chunk size employed
+    // by the dense multiplication algorithm.
+    st.chunk_size = mp.dense_chunk_size;
+
+    if (algo == poly_mul_int_algorithm::automatic) {
+        algo = detail::poly_mul_int_cost_model(st.n_mults, st.n_slots, n_bits1, n_bits2, st.n_bits);
+    }
+
+    switch (algo) {
+        case poly_mul_int_algorithm::kronecker:
+            return detail::poly_mul_kronecker<Sqr>(retval, st);
+        case poly_mul_int_algorithm::crt:
+            return detail::poly_mul_crt<Sqr>(retval, st);
+        default:
+            return false;
+    }
+}
+
+// Check if the polynomial multiplication algorithm via floating-point
+// FFT can be used: the key type must support the Kronecker encoding of
+// the bounding box, and the coefficients must all be double.
+template <typename Ret, typename Cf1, typename Cf2>
+inline constexpr bool poly_mul_fft_algo
+    = ::std::conjunction_v<::std::bool_constant<poly_mul_kbox_algo<Ret>>, ::std::is_same<series_cf_t<Ret>, double>,
+                           ::std::is_same<Cf1, double>, ::std::is_same<Cf2, double>>;
+
+// The transform length at or above which the
+// FFT-based multiplication is parallelised.
+inline constexpr ::std::size_t poly_mul_fft_par_size = 1u << 14;
+
+// Complex multiplication.
+// NOTE: the operator of std::complex
+// is slowed down by the checks for
+// infinities and NaNs.
+inline ::std::complex<double> poly_mul_fft_cmul(const ::std::complex<double> &a, const ::std::complex<double> &b)
+{
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+// In-place radix-2 decimation-in-time FFT of the n values in data.
+// The twiddle factors of the stage whose butterflies span h elements
+// are stored contiguously in w: w[h + j] = exp(-pi*i*j/h), for j in [0, h).
+// NOTE: n must be a power of 2 greater than 1.
+inline void poly_mul_fft_transform(::std::complex<double> *data, ::std::size_t n, const ::std::complex<double> *w)
+{
+    assert(n > 1u && ::std::has_single_bit(n));
+
+    // Bit-reversal permutation.
+    for (::std::size_t i = 1, j = 0; i < n; ++i) {
+        auto bit = n >> 1;
+        for (; (j & bit) != 0u; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+
+        if (i < j) {
+            ::std::swap(data[i], data[j]);
+        }
+    }
+
+    const auto log2n = static_cast<unsigned>(::std::countr_zero(n));
+
+    for (unsigned s = 0; s < log2n; ++s) {
+        const auto h = ::std::size_t(1) << s;
+
+        // NOTE: the butterfly b operates on the elements with indices top and
+        // top + h, where top is obtained by inserting a zero bit in position s of b.
+        // The butterflies within a stage are independent, thus they can be run in parallel.
+        auto stage = [data, w, s, h](::std::size_t b_begin, ::std::size_t b_end) {
+            for (auto b = b_begin; b != b_end; ++b) {
+                const auto j = b & (h - 1u);
+                const auto top = ((b >> s) << (s + 1u)) | j;
+
+                const auto u = data[top], v = detail::poly_mul_fft_cmul(data[top + h], w[h + j]);
+                data[top] = u + v;
+                data[top + h] = u - v;
+            }
+        };
+
+        if (n >= poly_mul_fft_par_size) {
+            ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, n / 2u, poly_mul_fft_par_size / 8u),
+                                [&stage](const auto &range) { stage(range.begin(), range.end()); });
+        } else {
+            stage(0, n / 2u);
+        }
+    }
+}
+
+// Multiplication via floating-point FFT.
+//
+// The coefficients of the operands are laid out in two dense vectors a and b indexed by the
+// offsets in the Kronecker-encoded bounding box of the product (see poly_mul_kbox), so that
+// the polynomial product is reduced to the linear convolution of a and b. The convolution
+// is computed via complex FFTs whose length n is large enough to avoid wraparound.
+// a and b are packed into the real and imaginary parts of z = a + i*b, so that,
+// denoting with Z the transform of z, the transform of the convolution is
+// (Z_k**2 - conj(Z_(n-k))**2) / 4i, and only one direct and one inverse
+// transform are needed.
+//
+// The absolute error on the coefficients of the product is bounded by
+// (||a||**2 + ||b||**2) * eps * (16 * log2(n) + 16), where ||.|| is the Euclidean
+// norm and eps the machine epsilon. This is a rounded-up version of the classical
+// bound for FFT-based convolutions (e.g., Percival, 2003). The result is accepted
+// only if either:
+//
+// - the coefficients of the operands are all integral, the coefficients of the
+//   product are computed exactly by the other multiplication algorithms (that is,
+//   min(n1, n2) * max|a| * max|b| <= 2**53) and the error bound is less than 1/2.
+//   The coefficients are then rounded to the nearest integer, and the result
+//   is identical to the result of the other algorithms; or
+// - the error bound is not greater than tol * min|a| * min|b| (so that the coefficients
+//   of the product which do not suffer from cancellation have a relative error not
+//   greater than tol), and all the coefficients of the product whose absolute value is
+//   greater than the error bound have a relative error not greater than tol.
+//   The coefficients whose absolute value does not exceed the error bound (which can
+//   result only from cancellation) are considered zero. A tol of zero disables this case.
+//
+// The return value signals whether the multiplication was actually performed:
+// if the error checks fail, nothing is done and false is returned.
+template <typename Ret, typename Expo>
+inline bool poly_mul_fft(Ret &retval, const poly_mul_kbox<Expo, double, double> &kb, double tol)
+{
+    const auto &ov1 = kb.ov1;
+    const auto &ov2 = kb.ov2;
+
+    // The offsets of the terms of the product
+    // are in the [base, base + n_slots) range.
+    const auto base = ov1.front().first + ov2.front().first;
+    const auto n_slots = ov1.back().first + ov2.back().first - base + 1u;
+    if (obake_unlikely(n_slots > (::obake::detail::limits_max<::std::size_t> >> 1) + 1u)) {
+        // LCOV_EXCL_START
+        return false;
+        // LCOV_EXCL_STOP
+    }
+    // The transform length.
+    const auto n = ::std::max(::std::bit_ceil(n_slots), ::std::size_t(2));
+    const auto log2n = static_cast<unsigned>(::std::countr_zero(n));
+
+    // Compute the squared norm, the min/max absolute values and the
+    // integrality of the coefficients of the operands.
+    // NOTE: the coefficients of a series are never zero.
+    auto cf_stats = [](const auto &ov, double &norm2, double &min_abs, double &max_abs, bool &integral) {
+        norm2 = 0;
+        min_abs = ::std::numeric_limits<double>::infinity();
+        max_abs = 0;
+        integral = true;
+        for (const auto &p : ov) {
+            const auto c = *p.second;
+            norm2 += c * c;
+            min_abs = ::std::min(min_abs, ::std::abs(c));
+            max_abs = ::std::max(max_abs, ::std::abs(c));
+            integral = integral && ::std::trunc(c) == c;
+        }
+    };
+    double norm2_1 = 0, norm2_2 = 0, min_abs1 = 0, min_abs2 = 0, max_abs1 = 0, max_abs2 = 0;
+    bool integral1 = false, integral2 = false;
+    cf_stats(ov1, norm2_1, min_abs1, max_abs1, integral1);
+    cf_stats(ov2, norm2_2, min_abs2, max_abs2, integral2);
+
+    const auto err_bound
+        = (norm2_1 + norm2_2) * ::std::numeric_limits<double>::epsilon() * (16. * static_cast<double>(log2n) + 16.);
+    if (!::std::isfinite(err_bound)) {
+        // Non-finite coefficients in the operands,
+        // or overflow in the computation of the error bound.
+        return false;
+    }
+
+    const auto exact_mode = integral1 && integral2
+                            && static_cast<double>(::std::min(ov1.size(), ov2.size())) * max_abs1 * max_abs2 <= 0x1p53
+                            && err_bound < .5;
+    // NOTE: in the non-exact mode, we also exclude the products
+    // involving subnormal values, for which the error bound does not hold.
+    if (!exact_mode
+        && !(tol > 0 && min_abs1 * min_abs2 >= ::std::numeric_limits<double>::min()
+             && err_bound <= tol * min_abs1 * min_abs2)) {
+        return false;
+    }
+
+    const auto par = n >= poly_mul_fft_par_size;
+
+    // The twiddle factors.
+    using cvec_t = ::std::vector<::std::complex<double>>;
+    cvec_t w(::obake::safe_cast<cvec_t::size_type>(n));
+    for (::std::size_t h = 1; h < n; h <<= 1) {
+        auto tw = [&w, h](::std::size_t j_begin, ::std::size_t j_end) {
+            for (auto j = j_begin; j != j_end; ++j) {
+                w[h + j] = ::std::polar(1., -::std::numbers::pi * static_cast<double>(j) / static_cast<double>(h));
+            }
+        };
+
+        if (par) {
+            ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, h),
+                                [&tw](const auto &range) { tw(range.begin(), range.end()); });
+        } else {
+            tw(0, h);
+        }
+    }
+
+    // Pack the operands into z and transform.
+    cvec_t z(::obake::safe_cast<cvec_t::size_type>(n));
+    for (const auto &p : ov1) {
+        z[p.first - ov1.front().first].real(*p.second);
+    }
+    for (const auto &p : ov2) {
+        z[p.first - ov2.front().first].imag(*p.second);
+    }
+    detail::poly_mul_fft_transform(z.data(), n, w.data());
+
+    // Compute the transform of the convolution C. The values at indices
+    // k and n - k are computed together: C is Hermitian-symmetric,
+    // because the convolution is real. We store conj(C), so that the inverse
+    // transform can be computed via the direct one (up to a conjugation
+    // and a scaling, which we will apply to the real part only).
+    auto conv_tr = [&z, n](::std::size_t k_begin, ::std::size_t k_end) {
+        for (auto k = k_begin; k != k_end; ++k) {
+            const auto nk = (n - k) & (n - 1u);
+
+            const auto zk = z[k], znk = ::std::conj(z[nk]);
+            const auto d = detail::poly_mul_fft_cmul(zk, zk) - detail::poly_mul_fft_cmul(znk, znk);
+
+            // NOTE: d / 4i = (Im(d) - i * Re(d)) / 4.
+            const ::std::complex<double> ck(d.imag() / 4, -d.real() / 4);
+            z[k] = ::std::conj(ck);
+            z[nk] = ck;
+        }
+    };
+    if (par) {
+        ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, n / 2u + 1u),
+                            [&conv_tr](const auto &range) { conv_tr(range.begin(), range.end()); });
+    } else {
+        conv_tr(0, n / 2u + 1u);
+    }
+    detail::poly_mul_fft_transform(z.data(), n, w.data());
+
+    // Read the coefficients of the product, checking their accuracy.
+    ::std::vector<double> slots(::obake::safe_cast<::std::vector<double>::size_type>(n_slots));
+    ::std::atomic<bool> accurate(true);
+    auto read_slots = [&](::std::size_t i_begin, ::std::size_t i_end) {
+        for (auto i = i_begin; i != i_end; ++i) {
+            const auto c = z[i].real() / static_cast<double>(n);
+
+            if (exact_mode) {
+                slots[i] = ::std::round(c);
+            } else if (::std::abs(c) > err_bound) {
+                if (obake_unlikely(err_bound > tol * ::std::abs(c))) {
+                    accurate.store(false, ::std::memory_order_relaxed);
+                    return;
+                }
+                slots[i] = c;
+            }
+        }
+    };
+    if (par) {
+        ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, n_slots),
+                            [&read_slots](const auto &range) { read_slots(range.begin(), range.end()); });
+    } else {
+        read_slots(0, n_slots);
+    }
+    if (!accurate.load(::std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // Convert the coefficients into terms.
+    detail::poly_mul_kbox_insert_slots(retval, kb, base, slots);
+
+    return true;
+}
+
+// Cost model for the selection of the FFT-based multiplication algorithm,
+// for a product with n_mults term-by-term multiplications whose terms fall in a range
+// of n_slots offsets in the bounding box.
+//
+// The model estimates the cost (in ns) of the FFT algorithm and of the other
+// multiplication algorithms, and it selects the FFT algorithm if it is clearly
+// cheaper. The constants are the ratios measured on a single core for products of dense
+// univariate and multivariate polynomials with small integral coefficients:
+//
+// - the other algorithms cost ~6ns per term-by-term multiplication;
+// - the FFT algorithm costs ~5ns per element and per stage of the transforms, plus
+//   ~150ns per slot for the conversion of the result into terms (which, for
+//   univariate products, is the dominating cost).
+//
+// Because the FFT operates on the bounding box of the product, multivariate products whose
+// terms fill only a small fraction of the box (e.g., products of polynomials which are
+// dense in the total degree) are typically rejected.
+inline bool poly_mul_fft_cost_model(const ::mppp::integer<1> &n_mults, ::std::size_t n_slots)
+{
+    using int_t = ::mppp::integer<1>;
+
+    if (n_slots > (::obake::detail::limits_max<::std::size_t> >> 1) + 1u) {
+        // LCOV_EXCL_START
+        return false;
+        // LCOV_EXCL_STOP
+    }
+
+    const auto n = ::std::max(::std::bit_ceil(n_slots), ::std::size_t(2));
+    const auto log2n = static_cast<unsigned>(::std::countr_zero(n));
+
+    const auto fft_cost = int_t{n} * log2n * 5u + int_t{n_slots} * 150u;
+    const auto school_cost = n_mults * 6u;
+
+    // NOTE: require a margin of 1.5 over the other algorithms, so that
+    // the inaccuracies of the model do not result in slowdowns.
+    return fft_cost * 3u <= school_cost * 2u;
+}
+
+// Multiplication of polynomials with double coefficients via floating-point FFT
+// (see poly_mul_fft()). If force is false, the algorithm is used only if the cost model
+// selects it (see poly_mul_fft_cost_model()). The return value signals whether the
+// multiplication was actually performed: if the algorithm is rejected by the cost model
+// or by the error checks (or the bounding box of the product is larger than the number
+// of term-by-term multiplications), nothing is done and false is returned.
+// The error tolerance is read from the multiplication policy mp.
+template <typename Ret, typename T, typename U>
+inline bool poly_mul_impl_fft(Ret &retval, const T &x, const U &y, bool force = false,
+                              const mul_policy &mp = polynomials::get_mul_policy())
+{
+    using expo_t = typename series_key_t<Ret>::value_type;
+
+    // Preconditions.
+    static_assert(poly_mul_fft_algo<Ret, series_cf_t<T>, series_cf_t<U>>);
+    assert(!x.empty());
+    assert(!y.empty());
+    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
+    assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
+    assert(retval.empty());
+    assert(retval._get_s_table().size() == 1u);
+
+    // Cache the symbol set.
+    const auto &ss = retval.get_symbol_set();
+
+    // Do the monomial overflow checking, if possible.
+    const auto r1
+        = ::obake::detail::make_range(::boost::make_transform_iterator(x.begin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(x.end(), poly_term_key_ref_extractor{}));
+    const auto r2
+        = ::obake::detail::make_range(::boost::make_transform_iterator(y.begin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(y.end(), poly_term_key_ref_extractor{}));
+    if constexpr (are_overflow_testable_monomial_ranges_v<decltype(r1) &, decltype(r2) &>) {
+        if (obake_unlikely(!::obake::monomial_range_overflow_check(r1, r2, ss))) {
+            obake_throw(
+                ::std::overflow_error,
+                "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+        }
+    }
+
+    // Setup the Kronecker encoding of the bounding box.
+    const auto n_mults = ::mppp::integer<1>(x.size()) * y.size();
+    poly_mul_kbox<expo_t, double, double> kb;
+    if (!detail::poly_mul_kbox_init(kb, x, y, ss, n_mults)) {
+        return false;
+    }
+
+    if (!force
+        && !detail::poly_mul_fft_cost_model(n_mults, kb.ov1.back().first + kb.ov2.back().first
+                                                         - (kb.ov1.front().first + kb.ov2.front().first) + 1u)) {
+        return false;
+    }
+
+    return detail::poly_mul_fft(retval, kb, mp.fft_tolerance);
+}
+
+// The maximum size (in bytes) of a buffer that will
+// be retained by the multiplication workspace.
+// NOTE: the idea is to avoid keeping alive indefinitely
+// large amounts of memory after multiplying very large
+// polynomials, in which case the cost of the allocation
+// is negligible anyway.
+inline constexpr ::std::size_t poly_mul_workspace_max_bytes = 64ul * 1024ul * 1024ul;
+
+// Workspace for poly_mul_impl_mt_hm(), consisting of the buffers
+// that hold the copies of the input terms (V1 and V2)
+// and the segmentations of the input series (S1 and S2).
+// On construction, the buffers are borrowed from a thread-local
+// instance of the workspace, so that their memory can be
+// re-used across multiplications. On destruction, the buffers
+// are cleared and given back to the thread-local instance.
+// NOTE: if the workspace is (re-)entered recursively from
+// the same thread (e.g., because TBB schedules another multiplication
+// of the same type while we are waiting in a parallel algorithm),
+// the inner workspace will just find empty buffers
+// in the thread-local instance, and it will allocate new ones.
+template <typename V1, typename V2, typename S1, typename S2>
+class poly_mul_workspace
+{
+    struct buffers {
+        V1 v1;
+        V2 v2;
+        S1 vseg1;
+        S2 vseg2;
+    };
+
+    static buffers &get_tl_buffers()
+    {
+        static thread_local buffers b;
+        return b;
+    }
+
+    // Helper to give back to the thread-local instance
+    // the buffer v (if it is not too large, and if it is
+    // larger than what is currently stored in the
+    // thread-local instance).
+    template <typename V>
+    static void give_back(V &tl_v, V &v) noexcept
+    {
+        v.clear();
+
+        if (v.capacity() <= poly_mul_workspace_max_bytes / sizeof(typename V::value_type)
+            && v.capacity() > tl_v.capacity()) {
+            tl_v = ::std::move(v);
+        }
+    }
+
+public:
+    poly_mul_workspace()
+    {
+        auto &b = get_tl_buffers();
+
+        // NOTE: the move operations leave the buffers
+        // in the thread-local instance empty.
+        v1 = ::std::move(b.v1);
+        v2 = ::std::move(b.v2);
+        vseg1 = ::std::move(b.vseg1);
+        vseg2 = ::std::move(b.vseg2);
+
+        assert(v1.empty());
+        assert(v2.empty());
+        assert(vseg1.empty());
+        assert(vseg2.empty());
+    }
+    poly_mul_workspace(const poly_mul_workspace &) = delete;
+    poly_mul_workspace(poly_mul_workspace &&) = delete;
+    poly_mul_workspace &operator=(const poly_mul_workspace &) = delete;
+    poly_mul_workspace &operator=(poly_mul_workspace &&) = delete;
+    ~poly_mul_workspace()
+    {
+        auto &b = get_tl_buffers();
+
+        give_back(b.v1, v1);
+        give_back(b.v2, v2);
+        give_back(b.vseg1, vseg1);
+        give_back(b.vseg2, vseg2);
+    }
+
+    V1 v1;
+    V2 v2;
+    S1 vseg1;
+    S2 vseg2;
+};
+
+// Helper to increase the number of segments of the
+// (possibly non-empty) series s to 2**log2_nsegs,
+// re-distributing its terms among the new segments.
+template <typename S>
+inline void poly_mul_resegment(S &s, unsigned log2_nsegs)
+{
+    assert(log2_nsegs > s.get_s_size());
+
+    S tmp;
+    tmp.set_symbol_set_fw(s.get_symbol_set_fw());
+    tmp.set_n_segments(log2_nsegs);
+    tmp.reserve(s.size());
+
+    try {
+        for (auto &t : s._get_s_table()) {
+            for (auto &term : t) {
+                // NOTE: the terms in s are unique, compatible
+                // and non-zero. We need to check the table size,
+                // as the terms will end up in different tables.
+                ::obake::detail::series_add_term<true, ::obake::detail::sat_check_zero::off,
+                                                 ::obake::detail::sat_check_compat_key::off,
+                                                 ::obake::detail::sat_check_table_size::on,
+                                                 ::obake::detail::sat_assume_unique::on>(tmp, term.first,
+                                                                                          ::std::move(term.second));
+            }
+        }
+        // LCOV_EXCL_START
+    } catch (...) {
+        // s may now contain moved-from coefficients.
+        // Make sure to clear it before rethrowing.
+        s.clear_terms();
+        throw;
+        // LCOV_EXCL_STOP
+    }
+
+    // NOTE: preserve the tag.
+    tmp.tag() = ::std::move(s.tag());
+    s = ::std::move(tmp);
+}
+
+// Detect if the square of a polynomial of type T can be computed
+// via the squaring mode of the multiplication algorithms. In squaring
+// mode, only the term-by-term products x_i * x_j with i <= j are computed,
+// and the off-diagonal products are accounted for twice by doubling
+// the coefficients of x. Thus, we require that the coefficients
+// can be added to themselves, yielding the same type.
+template <typename T>
+inline constexpr bool poly_mul_sqr_algo = ::std::is_same_v<
+    series_cf_t<T>, detected_t<::obake::detail::add_t, const series_cf_t<T> &, const series_cf_t<T> &>>;
+
+// Helper to invoke the functor f with a boolean constant
+// signalling whether or not the product x * y can be computed
+// via the squaring mode (that is, x and y are the same object).
+template <typename T, typename U, typename F>
+inline void poly_mul_sqr_dispatch(const T &x, const U &y, const F &f)
+{
+    if constexpr (::std::is_same_v<T, U> && detail::poly_mul_sqr_algo<T>) {
+        if (&x == &y) {
+            f(::std::true_type{});
+
+            return;
+        }
+    } else {
+        ::obake::detail::ignore(x, y);
+    }
+
+    f(::std::false_type{});
+}
+
+// The multi-threaded homomorphic implementation.
+// If Acc is true, the product will be accumulated into
+// retval (which may thus be non-empty and segmented).
+// If Sqr is true, x and y must be the same object, and
+// the squaring mode will be used. The tuning parameters
+// are read from the multiplication policy mp.
+template <bool Acc = false, bool Sqr = false, typename Ret, typename T, typename U, typename... Args>
+inline void poly_mul_impl_mt_hm(Ret &retval, const mul_policy &mp, const T &x, const U &y, const Args &...args)
+{
+    using cf1_t = series_cf_t<T>;
+    using cf2_t = series_cf_t<U>;
+    using ret_key_t = series_key_t<Ret>;
+    using ret_cf_t = series_cf_t<Ret>;
+    using s_size_t = typename Ret::s_size_type;
+
+    // Preconditions.
+    static_assert(sizeof...(args) <= 2u);
+    assert(!x.empty());
+    assert(!y.empty());
+    assert(x.size() <= y.size());
+    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
+    assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
+    if constexpr (!Acc) {
+        assert(retval.empty());
+        assert(retval._get_s_table().size() == 1u);
+    }
+    static_assert(!Sqr || (::std::is_same_v<T, U> && detail::poly_mul_sqr_algo<T>));
+    if constexpr (Sqr) {
+        assert(static_cast<const void *>(&x) == static_cast<const void *>(&y));
+    }
+
+    // Cache the symbol set.
+    const auto &ss = retval.get_symbol_set();
+
+    // Setup the workspace.
+    // NOTE: drop the const from the key type in order
+    // to allow mutability.
+    using v1_t = ::std::vector<::std::pair<series_key_t<T>, cf1_t>>;
+    using v2_t = ::std::vector<::std::pair<series_key_t<U>, cf2_t>>;
+    using vseg1_t = ::std::vector<::std::tuple<typename v1_t::size_type, typename v1_t::size_type, s_size_t>>;
+    using vseg2_t = ::std::vector<::std::tuple<typename v2_t::size_type, typename v2_t::size_type, s_size_t>>;
+    detail::poly_mul_workspace<v1_t, v2_t, vseg1_t, vseg2_t> ws;
+
+    // Fill the vectors containing copies of
+    // the input terms.
+    // NOTE: in theory, it would be possible here
+    // to move the coefficients (in conjunction with
+    // rref_cleaner, as usual).
+    // NOTE: need to better assess the benefits of
+    // copying the input series.
+    auto &v1 = ws.v1;
+    auto &v2 = ws.v2;
+    v1.insert(v1.end(), ::boost::make_transform_iterator(x.begin(), poly_mul_impl_pair_transform{}),
+              ::boost::make_transform_iterator(x.end(), poly_mul_impl_pair_transform{}));
+    v2.insert(v2.end(), ::boost::make_transform_iterator(y.begin(), poly_mul_impl_pair_transform{}),
+              ::boost::make_transform_iterator(y.end(), poly_mul_impl_pair_transform{}));
+
+    // Do the monomial overflow checking, if supported.
+    // NOTE: we have to sequence the overflow checking before the product
+    // size estimation and the average term size estimation, as those two
+    // operations might generate overflows during monomial multiplication.
+    const auto r1
+        = ::obake::detail::make_range(::boost::make_transform_iterator(v1.cbegin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(v1.cend(), poly_term_key_ref_extractor{}));
+    const auto r2
+        = ::obake::detail::make_range(::boost::make_transform_iterator(v2.cbegin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(v2.cend(), poly_term_key_ref_extractor{}));
+    if constexpr (are_overflow_testable_monomial_ranges_v<decltype(r1) &, decltype(r2) &>) {
+        // The monomial overflow checking is supported, run it.
+        if (obake_unlikely(!::obake::monomial_range_overflow_check(r1, r2, ss))) {
+            obake_throw(::std::overflow_error, "An overflow in the monomial exponents was detected while "
+                                               "attempting to multiply two polynomials");
+        }
+    }
+
+    // Estimate the total number of terms, and compute the total number
+    // of term-by-term multiplications.
+    // NOTE: poly_mul_estimate_product_size() requires the shorter series first,
+    // which is ensured by the preconditions of this function.
+    const auto [est_nterms, tot_n_mults] = detail::poly_mul_estimate_product_size<T, U>(v1, v2, ss, args...);
+    // Exit early if the truncation limits
+    // result in an empty output series.
+    if (sizeof...(Args) > 0u && tot_n_mults.is_zero()) {
+        return;
+    }
+
+    // Estimate the average term size.
+    // NOTE: once poly_mul_impl_estimate_average_term_size() becomes more computationally intensive,
+    // we can do it in parallel with poly_mul_estimate_product_size().
+    const auto avg_term_size = detail::poly_mul_impl_estimate_average_term_size<ret_cf_t>(v1, v2, ss);
+
+    // Compute the estimated sparsity.
+    const auto est_sp = static_cast<double>(est_nterms) / static_cast<double>(tot_n_mults);
+
+    // Establish the desired segment size in bytes.
+    // NOTE: the idea here is the following. For highly
+    // sparse polynomials (est_sp >= threshold), we want to pick
+    // a relatively large size so that it fits somewhere in L2
+    // cache, say. The reason is that we won't do much computation
+    // per segment due to the sparsity, thus we aim at reducing
+    // the parallelisation overhead by operating on larger chunks
+    // of the product series. When the sparsity is smaller, then
+    // we have a higher computational density, thus we will spend
+    // more time computing a single segment, and thus we can aim
+    // at staying in L1 cache instead, as the parallelisation overhead
+    // will be smaller. Note that these values will be just rule-of-thumb,
+    // because the sparsity is not estimated accurately and because
+    // of further manipulations below. Additionally, it is not clear
+    // to me how smooth the transition between high and low sparsity
+    // will be. The segment sizes and the sparsity threshold are read
+    // from the multiplication policy.
+    // NOTE: if est_sp is not finite, due to tot_n_mults being zero or other
+    // FP issues, go with a default value.
+    // NOTE: is it worth it to exit early if tot_n_mults is zero? This would
+    // mean that the truncation limits will produce an empty series.
+    const auto seg_size
+        = (!::std::isfinite(est_sp) || est_sp >= mp.sp_threshold) ? mp.sparse_seg_size : mp.dense_seg_size;
+
+    // Estimate the number of segments via the deduced segment size.
+    // NOTE: when accumulating, take into account also
+    // the terms already present in retval.
+    const auto est_nsegs = ((Acc ? est_nterms + retval.size() : est_nterms) * avg_term_size) / seg_size;
+
+    // Fetch the base-2 logarithm + 1 of est_nsegs, making sure it does not
+    // overflow the max allowed value for the return polynomial type,
+    // and setup the number of segments in retval.
+    const auto log2_nsegs = [&retval, &est_nsegs]() {
+        const auto ret = ::std::min(::obake::safe_cast<unsigned>(est_nsegs.nbits()),
+                                    polynomial<ret_key_t, ret_cf_t>::get_max_s_size());
+
+        if constexpr (Acc) {
+            // When accumulating, we cannot just reset the
+            // segmentation of retval. We increase the number of segments
+            // only if necessary, re-distributing the existing terms.
+            if (ret > retval.get_s_size()) {
+                detail::poly_mul_resegment(retval, ret);
+            }
+
+            return retval.get_s_size();
+        } else {
+            retval.set_n_segments(ret);
+
+            return ret;
+        }
+    }();
+
+    // For dense untruncated products, try first the dense
+    // multiplication algorithm, which avoids hashing altogether
+    // during the accumulation of the term-by-term products.
+    // NOTE: the sparsity threshold here is only a cheap filter
+    // to avoid the unpacking of the exponents in poly_mul_impl_mt_dense()
+    // for clearly sparse products (keeping in mind that the estimation
+    // of the number of terms tends to err on the high side): the actual
+    // decision is taken by poly_mul_impl_mt_dense() on the basis of the
+    // size of the bounding box of the product.
+    // NOTE: the dense algorithm requires an empty retval,
+    // hence it is not used when accumulating.
+    if constexpr (!Acc && sizeof...(Args) == 0u && detail::poly_mul_kbox_algo<Ret>) {
+        if (::std::isfinite(est_sp) && est_sp < mp.dense_sp_threshold
+            && detail::poly_mul_impl_mt_dense(retval, v1, v2, est_nterms, mp)) {
+            return;
+        }
+    }
+
+    // Cache the actual number of segments.
+    const auto nsegs = s_size_t(1) << log2_nsegs;
+
+    // Estimate the number of terms that will end up in
+    // each segment of retval. We will use this value to
+    // pre-allocate the tables before the accumulation of the
+    // term-by-term products, so that we avoid repeated rehashing
+    // as the tables grow.
+    // NOTE: because the number of segments was deduced from
+    // est_nterms, this value is bounded by the segment size
+    // selected above, even if est_nterms is overestimated.
+    // NOTE: clamp it to the max table size anyway, as the number
+    // of segments is capped by get_max_s_size().
+    const auto seg_est_nterms = ::obake::safe_cast<decltype(retval._get_max_table_size())>(
+        ::std::min(est_nterms >> log2_nsegs, ::mppp::integer<1>{retval._get_max_table_size()}));
+
+    // Helper to sort the input terms according to the hash value modulo
+    // 2**log2_nsegs. That is, sort them according to the bucket
+    // they would occupy in a segmented table with 2**log2_nsegs
+    // segments.
+    auto t_sorter = [log2_nsegs](const auto &p1, const auto &p2) {
+        const auto h1 = ::obake::hash(p1.first);
+        const auto h2 = ::obake::hash(p2.first);
+
+        return h1 % (s_size_t(1) << log2_nsegs) < h2 % (s_size_t(1) << log2_nsegs);
+    };
+
+    // Helper to compute the segmentation for the input series.
+    // The segmentation is a vector of ranges (represented
+    // as pairs of indices into v1/v2) paired to indices
+    // representing the bucket that the range
+    // would occupy in a segmented table
+    // with 2**log2_nsegs segments. The segmentation
+    // will be written into vseg.
+    auto compute_vseg = [nsegs, log2_nsegs](auto &vseg, const auto &v) {
+        // Ensure that the size of v is representable by
+        // its iterator's diff type. We need to do some
+        // iterator arithmetics below.
+        ::obake::detail::container_it_diff_check(v);
+
+        using idx_t = decltype(v.size());
+        static_assert(::std::is_same_v<typename ::std::remove_reference_t<decltype(vseg)>::value_type,
+                                       ::std::tuple<idx_t, idx_t, s_size_t>>);
+        vseg.clear();
+        // NOTE: the max possible size of vseg is the number of segments.
+        vseg.reserve(::obake::safe_cast<decltype(vseg.size())>(nsegs));
+
+        const auto v_begin = v.begin(), v_end = v.end();
+
+        // NOTE: if the number of terms in v is small enough,
+        // compute a sparse representation of vseg (meaning that
+        // the number of segmentation ranges will be less than
+        // nsegs and all the ranges will be non-empty). Otherwise,
+        // compute a dense representation, where the number
+        // of ranges is equal to nsegs and empty ranges might
+        // be present. We will later run different parallel
+        // functors depending on whether we are in the sparse
+        // or dense case.
+        // NOTE: the idea here is that we want to run
+        // the sparse functor only in highly sparse cases,
+        // because otherwise the more complicated logic
+        // of the sparse functor carries a measurable performance
+        // penalty in the "mostly-dense" cases.
+        if (v.size() < nsegs / 2u) {
+            for (auto it = v_begin; it != v_end;) {
+                // Get the bucket index of the current term.
+                const auto cur_b_idx = static_cast<s_size_t>(::obake::hash(it->first) % (s_size_t(1) << log2_nsegs));
+                // Look for the first term whose bucket index is greater than cur_b_idx.
+                const auto range_end
+                    = ::std::upper_bound(it, v_end, cur_b_idx, [log2_nsegs](const auto &b_idx, const auto &p) {
+                          return b_idx < ::obake::hash(p.first) % (s_size_t(1) << log2_nsegs);
+                      });
+                // NOTE: because we are in the sparse representation case,
+                // range_end cannot be equal to it.
+                assert(range_end != it);
+                // Add the range to vseg.
+                // NOTE: the overflow check was done earlier.
+                vseg.emplace_back(static_cast<idx_t>(it - v_begin), static_cast<idx_t>(range_end - v_begin), cur_b_idx);
+                // Update 'it'.
                 it = range_end;
             }
         } else {
@@ -987,8 +2849,6 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
                 vseg.emplace_back(old_idx, idx, i);
             }
         }
-
-        return vseg;
     };
 
     // Helper that, given a segmentation vseg into a vector of terms
@@ -1107,8 +2967,8 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
     // Prepare the variables to hold the segmentations
     // and the degrees of the terms, if we are in a
     // truncated multiplication.
-    decltype(compute_vseg(v1)) vseg1;
-    decltype(compute_vseg(v2)) vseg2;
+    auto &vseg1 = ws.vseg1;
+    auto &vseg2 = ws.vseg2;
     auto degree_data = detail::poly_mul_impl_prepare_degree_data<T, U>(v1, v2, ss, args...);
 
     // For both x and y, concurrently:
@@ -1117,25 +2977,44 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
     // - compute the degrees of the terms and sort according
     //   to the degree within each segment (only for truncated
     //   multiplication).
-    ::tbb::parallel_invoke(
-        [&v1, t_sorter, &vseg1, compute_vseg, &degree_data, seg_sorter]() {
-            ::tbb::parallel_sort(v1.begin(), v1.end(), t_sorter);
-            vseg1 = compute_vseg(v1);
-            if constexpr (sizeof...(Args) > 0u) {
-                ::std::get<0>(degree_data) = seg_sorter(v1, ::obake::detail::type_c<T>{}, vseg1);
-            } else {
-                ::obake::detail::ignore(degree_data, seg_sorter);
-            }
-        },
-        [&v2, t_sorter, &vseg2, compute_vseg, &degree_data, seg_sorter]() {
-            ::tbb::parallel_sort(v2.begin(), v2.end(), t_sorter);
-            vseg2 = compute_vseg(v2);
-            if constexpr (sizeof...(Args) > 0u) {
-                ::std::get<1>(degree_data) = seg_sorter(v2, ::obake::detail::type_c<U>{}, vseg2);
-            } else {
-                ::obake::detail::ignore(degree_data, seg_sorter);
-            }
-        });
+    if constexpr (Sqr) {
+        // In squaring mode, we process only v1. Then, we overwrite
+        // v2 with the terms of v1 in the same order, but with doubled
+        // coefficients, which will be used in the off-diagonal products.
+        ::tbb::parallel_sort(v1.begin(), v1.end(), t_sorter);
+        compute_vseg(vseg1, v1);
+        if constexpr (sizeof...(Args) > 0u) {
+            ::std::get<0>(degree_data) = seg_sorter(v1, ::obake::detail::type_c<T>{}, vseg1);
+            ::std::get<1>(degree_data) = ::std::get<0>(degree_data);
+        }
+
+        assert(v1.size() == v2.size());
+        for (decltype(v1.size()) i = 0; i < v1.size(); ++i) {
+            v2[i].first = v1[i].first;
+            v2[i].second = v1[i].second + v1[i].second;
+        }
+        vseg2 = vseg1;
+    } else {
+        ::tbb::parallel_invoke(
+            [&v1, t_sorter, &vseg1, compute_vseg, &degree_data, seg_sorter]() {
+                ::tbb::parallel_sort(v1.begin(), v1.end(), t_sorter);
+                compute_vseg(vseg1, v1);
+                if constexpr (sizeof...(Args) > 0u) {
+                    ::std::get<0>(degree_data) = seg_sorter(v1, ::obake::detail::type_c<T>{}, vseg1);
+                } else {
+                    ::obake::detail::ignore(degree_data, seg_sorter);
+                }
+            },
+            [&v2, t_sorter, &vseg2, compute_vseg, &degree_data, seg_sorter]() {
+                ::tbb::parallel_sort(v2.begin(), v2.end(), t_sorter);
+                compute_vseg(vseg2, v2);
+                if constexpr (sizeof...(Args) > 0u) {
+                    ::std::get<1>(degree_data) = seg_sorter(v2, ::obake::detail::type_c<U>{}, vseg2);
+                } else {
+                    ::obake::detail::ignore(degree_data, seg_sorter);
+                }
+            });
+    }
 
 #if !defined(NDEBUG)
     {
@@ -1246,7 +3125,8 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
 
     // The parallel multiplication functor for the sparse case.
     auto sparse_par_functor
-        = [&v1, &v2, &vseg1, &vseg2, nsegs, &retval, &ss, mts = retval._get_max_table_size(), &compute_end_idx2
+        = [&v1, &v2, &vseg1, &vseg2, nsegs, &retval, &ss, mts = retval._get_max_table_size(), &compute_end_idx2,
+           seg_est_nterms
 #if !defined(NDEBUG)
            ,
            log2_nsegs, &n_mults
@@ -1268,6 +3148,11 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
                   // Get a reference to the current table in retval.
                   auto &table = retval._get_s_table()[seg_idx];
 
+                  // Pre-allocate space in the table.
+                  // NOTE: when accumulating, the table
+                  // may already contain terms.
+                  table.reserve(table.size() + seg_est_nterms);
+
                   // The iterator in vseg2 that we will use
                   // as the end point in the binary search below.
                   // Initially, it is just the end of vseg2
@@ -1328,6 +3213,13 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
                       const auto [r2_start, r2_end, bi2] = r2;
                       ::obake::detail::ignore(r2_end, bi2);
 
+                      // In squaring mode, the products of the ranges with
+                      // bucket indices (bi1, bi2) and (bi2, bi1) coincide,
+                      // thus we compute only those with bi1 <= bi2.
+                      if (Sqr && bi1 > bi2) {
+                          continue;
+                      }
+
                       // The O(N**2) multiplication loop over the ranges.
                       for (auto idx1 = r1_start; idx1 != r1_end; ++idx1) {
                           const auto &[k1, c1] = *(vptr1 + idx1);
@@ -1346,9 +3238,24 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
                               break;
                           }
 
+                          // In squaring mode, when multiplying a range by itself,
+                          // start from the diagonal term, whose coefficient
+                          // must not be doubled.
+                          const auto begin2 = vptr2 + ((Sqr && bi1 == bi2) ? idx1 : r2_start);
+                          const auto diag2 = (Sqr && bi1 == bi2) ? begin2 : nullptr;
+
                           const auto end2 = vptr2 + idx_end2;
-                          for (auto ptr2 = vptr2 + r2_start; ptr2 != end2; ++ptr2) {
-                              const auto &[k2, c2] = *ptr2;
+                          for (auto ptr2 = begin2; ptr2 < end2; ++ptr2) {
+                              const auto &k2 = ptr2->first;
+                              const auto &c2 = [ptr1 = vptr1 + idx1, ptr2, diag2]() -> const auto & {
+                                  if constexpr (Sqr) {
+                                      return ptr2 == diag2 ? ptr1->second : ptr2->second;
+                                  } else {
+                                      ::obake::detail::ignore(ptr1, diag2);
+
+                                      return ptr2->second;
+                                  }
+                              }();
 
                               // Do the monomial multiplication.
                               ::obake::monomial_mul(tmp_key, k1, k2, ss);
@@ -1427,7 +3334,8 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
 
     // The parallel multiplication functor for the dense case.
     auto dense_par_functor
-        = [&v1, &v2, &vseg1, &vseg2, nsegs, &retval, &ss, mts = retval._get_max_table_size(), &compute_end_idx2
+        = [&v1, &v2, &vseg1, &vseg2, nsegs, &retval, &ss, mts = retval._get_max_table_size(), &compute_end_idx2,
+           seg_est_nterms
 #if !defined(NDEBUG)
            ,
            log2_nsegs, &n_mults
@@ -1446,6 +3354,11 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
                   // Get a reference to the current table in retval.
                   auto &table = retval._get_s_table()[seg_idx];
 
+                  // Pre-allocate space in the table.
+                  // NOTE: when accumulating, the table
+                  // may already contain terms.
+                  table.reserve(table.size() + seg_est_nterms);
+
                   // The objective here is to perform all term-by-term multiplications
                   // whose results end up in the current table (i.e., the table in retval
                   // at index seg_idx). Due to homomorphic hashing, we know that,
@@ -1458,6 +3371,13 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
                       const auto j = seg_idx >= i ? (seg_idx - i) : (nsegs - i + seg_idx);
                       assert(j < vseg2.size());
 
+                      // In squaring mode, compute only the
+                      // products of the ranges with i <= j
+                      // (see the sparse functor).
+                      if (Sqr && i > j) {
+                          continue;
+                      }
+
                       // Fetch the corresponding ranges.
                       const auto [r1_start, r1_end, bi1] = vseg1[i];
                       const auto &r2 = vseg2[j];
@@ -1489,9 +3409,24 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
                               break;
                           }
 
+                          // In squaring mode, when multiplying a range by itself,
+                          // start from the diagonal term, whose coefficient
+                          // must not be doubled.
+                          const auto begin2 = vptr2 + ((Sqr && bi1 == bi2) ? idx1 : r2_start);
+                          const auto diag2 = (Sqr && bi1 == bi2) ? begin2 : nullptr;
+
                           const auto end2 = vptr2 + idx_end2;
-                          for (auto ptr2 = vptr2 + r2_start; ptr2 != end2; ++ptr2) {
-                              const auto &[k2, c2] = *ptr2;
+                          for (auto ptr2 = begin2; ptr2 < end2; ++ptr2) {
+                              const auto &k2 = ptr2->first;
+                              const auto &c2 = [ptr1 = vptr1 + idx1, ptr2, diag2]() -> const auto & {
+                                  if constexpr (Sqr) {
+                                      return ptr2 == diag2 ? ptr1->second : ptr2->second;
+                                  } else {
+                                      ::obake::detail::ignore(ptr1, diag2);
+
+                                      return ptr2->second;
+                                  }
+                              }();
 
                               // Do the monomial multiplication.
                               ::obake::monomial_mul(tmp_key, k1, k2, ss);
@@ -1583,15 +3518,27 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
         // Verify the number of term multiplications we performed,
         // but only if we are in non-truncated mode.
         if constexpr (sizeof...(args) == 0u) {
-            assert(n_mults.load()
-                   == static_cast<unsigned long long>(x.size()) * static_cast<unsigned long long>(y.size()));
+            if constexpr (Sqr) {
+                assert(n_mults.load()
+                       == static_cast<unsigned long long>(x.size()) * (static_cast<unsigned long long>(x.size()) + 1u)
+                              / 2u);
+            } else {
+                assert(n_mults.load()
+                       == static_cast<unsigned long long>(x.size()) * static_cast<unsigned long long>(y.size()));
+            }
         }
 #endif
         // LCOV_EXCL_START
     } catch (...) {
         // In case of exceptions, clear retval before
         // rethrowing to ensure a known sane state.
-        retval.clear();
+        // NOTE: when accumulating, keep the symbol
+        // set and the tag of retval.
+        if constexpr (Acc) {
+            retval.clear_terms();
+        } else {
+            retval.clear();
+        }
         throw;
         // LCOV_EXCL_STOP
     }
@@ -1603,6 +3550,15 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
 
 #endif
 
+// Overload of poly_mul_impl_mt_hm() using the multiplication
+// policy in use in the calling thread.
+template <bool Acc = false, bool Sqr = false, typename Ret, typename T, typename U, typename... Args>
+requires(!::std::is_same_v<T, mul_policy>) inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y,
+                                                                            const Args &...args)
+{
+    detail::poly_mul_impl_mt_hm<Acc, Sqr>(retval, polynomials::get_mul_policy(), x, y, args...);
+}
+
 // Extract a pointer from a const reference.
 struct poly_mul_impl_ptr_extractor {
     template <typename T>
@@ -1615,7 +3571,12 @@ struct poly_mul_impl_ptr_extractor {
 // Simple poly mult implementation: just multiply
 // term by term, no parallelisation, no segmentation,
 // no copying of the operands, etc.
-template <typename Ret, typename T, typename U, typename... Args>
+// If Acc is true, the product will be accumulated into
+// retval (which may thus be non-empty, but it must
+// not be segmented and it must not overlap with x or y).
+// If Sqr is true, x and y must be the same object, and
+// the squaring mode will be used.
+template <bool Acc = false, bool Sqr = false, typename Ret, typename T, typename U, typename... Args>
 inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args &...args)
 {
     using ret_key_t = series_key_t<Ret>;
@@ -1630,8 +3591,16 @@ inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args
     assert(x.size() <= y.size());
     assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
     assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
-    assert(retval.empty());
+    assert(Acc || retval.empty());
     assert(retval._get_s_table().size() == 1u);
+    if constexpr (Acc) {
+        assert(static_cast<const void *>(&retval) != static_cast<const void *>(&x));
+        assert(static_cast<const void *>(&retval) != static_cast<const void *>(&y));
+    }
+    static_assert(!Sqr || (::std::is_same_v<T, U> && detail::poly_mul_sqr_algo<T>));
+    if constexpr (Sqr) {
+        assert(static_cast<const void *>(&x) == static_cast<const void *>(&y));
+    }
 
     // Cache the symbol set.
     const auto &ss = retval.get_symbol_set();
@@ -1811,6 +3780,31 @@ inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args
         }
     }();
 
+    // In squaring mode, the second operand is v1 itself, and
+    // the off-diagonal products will use the doubled coefficients
+    // of the terms in v1, which we precompute here.
+    // NOTE: v1 and v2 have been sorted in the same
+    // way by compute_j_end, thus the truncation limits
+    // computed on v2 are valid also for v1.
+    const auto &vv2 = [&v1, &v2]() -> const auto & {
+        if constexpr (Sqr) {
+            ::obake::detail::ignore(v2);
+
+            return v1;
+        } else {
+            ::obake::detail::ignore(v1);
+
+            return v2;
+        }
+    }();
+    ::std::vector<cf1_t> v1_dbl;
+    if constexpr (Sqr) {
+        v1_dbl.reserve(v1.size());
+        for (const auto &t : v1) {
+            v1_dbl.push_back(t->second + t->second);
+        }
+    }
+
     // Proceed with the multiplication.
     auto &tab = retval._get_s_table()[0];
 
@@ -1834,9 +3828,18 @@ inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args
                 break;
             }
 
-            for (decltype(v2.size()) j = 0; j < j_end; ++j) {
-                const auto &t2 = v2[j];
-                const auto &c2 = t2->second;
+            // In squaring mode, compute only the products with j >= i.
+            for (decltype(v2.size()) j = Sqr ? i : 0u; j < j_end; ++j) {
+                const auto &t2 = vv2[j];
+                const auto &c2 = [&v1_dbl, &t2, i, j]() -> const auto & {
+                    if constexpr (Sqr) {
+                        return i == j ? t2->second : v1_dbl[j];
+                    } else {
+                        ::obake::detail::ignore(v1_dbl, i, j);
+
+                        return t2->second;
+                    }
+                }();
 
                 // Multiply the monomial.
                 ::obake::monomial_mul(tmp_key, k1, t2->first, ss);
@@ -1878,16 +3881,448 @@ inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args
             }
         }
 
-        // NOTE: no need to check the table size, as retval
-        // is not segmented.
+        // NOTE: no need to check the table size, as retval
+        // is not segmented.
+        // LCOV_EXCL_START
+    } catch (...) {
+        // retval may now contain zero coefficients.
+        // Make sure to clear it before rethrowing.
+        tab.clear();
+        throw;
+        // LCOV_EXCL_STOP
+    }
+}
+
+// Poly multiplication by a single term. x must consist of a single term,
+// and the key type must be homomorphically hashable. Because of homomorphic
+// hashing, all the terms in the i-th table of y end up, after multiplication
+// by the single term of x, in the table (i + hash(k1)) mod n_tables of retval
+// (where k1 is the key of x). Thus, the tables of retval can be computed
+// independently (and in parallel) from the tables of y. Because multiplying
+// by a single monomial preserves the uniqueness of the keys, no probing
+// of existing terms is needed on insertion. retval will have the same
+// number of segments as y.
+template <typename Ret, typename T, typename U>
+inline void poly_mul_impl_monomial(Ret &retval, const T &x, const U &y)
+{
+    using ret_key_t = series_key_t<Ret>;
+    using s_size_t = typename remove_cvref_t<decltype(retval._get_s_table())>::size_type;
+
+    // Preconditions.
+    static_assert(is_homomorphically_hashable_monomial_v<ret_key_t>);
+    assert(x.size() == 1u);
+    assert(!y.empty());
+    assert(retval.empty());
+    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
+    assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
+
+    // Cache the symbol set.
+    const auto &ss = retval.get_symbol_set();
+
+    // Do the monomial overflow checking, if possible.
+    const auto r1
+        = ::obake::detail::make_range(::boost::make_transform_iterator(x.begin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(x.end(), poly_term_key_ref_extractor{}));
+    const auto r2
+        = ::obake::detail::make_range(::boost::make_transform_iterator(y.begin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(y.end(), poly_term_key_ref_extractor{}));
+    if constexpr (are_overflow_testable_monomial_ranges_v<decltype(r1) &, decltype(r2) &>) {
+        if (obake_unlikely(!::obake::monomial_range_overflow_check(r1, r2, ss))) {
+            obake_throw(
+                ::std::overflow_error,
+                "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+        }
+    }
+
+    // Fetch the single term of x.
+    const auto &k1 = x.begin()->first;
+    const auto &c1 = x.begin()->second;
+
+    // Setup the segmentation of retval.
+    retval.set_n_segments(y.get_s_size());
+
+    const auto &in_s_table = y._get_s_table();
+    auto &out_s_table = retval._get_s_table();
+    const auto n_tables = in_s_table.size();
+    assert(out_s_table.size() == n_tables);
+
+    // The table index shift induced by k1.
+    const auto shift = static_cast<s_size_t>(::obake::hash(k1) & (n_tables - 1u));
+
+    // Multiply the terms in the i-th table of y.
+    auto mul_table = [&](s_size_t i) {
+        const auto &in_table = in_s_table[i];
+        auto &out_table = out_s_table[(i + shift) & (n_tables - 1u)];
+
+        out_table.reserve(in_table.size());
+
+        // Temporary variable used in monomial multiplication.
+        ret_key_t tmp_key(ss);
+
+        for (const auto &t : in_table) {
+            ::obake::monomial_mul(tmp_key, k1, t.first, ss);
+            assert(::obake::hash(tmp_key) == ::obake::hash(k1) + ::obake::hash(t.first));
+
+            // NOTE: the coefficient may become zero
+            // after the multiplication, thus keep the
+            // zero check. The table size check is not needed,
+            // as out_table will contain at most as many terms
+            // as in_table.
+            detail::series_add_term_table<true, sat_check_zero::on, sat_check_compat_key::off,
+                                          sat_check_table_size::off, sat_assume_unique::on>(
+                retval, out_table, ::std::as_const(tmp_key), c1 * t.second);
+        }
+    };
+
+    try {
+        if (n_tables > 1u) {
+            ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, n_tables), [&mul_table](const auto &range) {
+                for (auto i = range.begin(); i != range.end(); ++i) {
+                    mul_table(i);
+                }
+            });
+        } else {
+            mul_table(0);
+        }
+        // LCOV_EXCL_START
+    } catch (...) {
+        // NOTE: retval may now be only partially
+        // filled. Clear it before rethrowing.
+        retval.clear();
+        throw;
+    }
+    // LCOV_EXCL_STOP
+}
+
+// Helper to establish which symbols do not appear
+// in the keys of the polynomial x, via key_trim_identify().
+// In the returned vector, a nonzero value at index i means that
+// the i-th symbol does not appear in any key of x.
+template <typename T>
+inline ::std::vector<int> poly_mul_trim_identify(const T &x)
+{
+    const auto &ss = x.get_symbol_set();
+
+    ::std::vector<int> retval(::obake::safe_cast<::std::vector<int>::size_type>(ss.size()), 1);
+    for (const auto &t : x) {
+        ::obake::key_trim_identify(retval, t.first, ss);
+    }
+
+    return retval;
+}
+
+// Helper to establish if the polynomials x and y
+// depend on disjoint subsets of their (common) symbol set.
+// The keys of x are scanned in full, while the scan of the keys
+// of y stops as soon as a symbol appearing also in x is found.
+// NOTE: it is convenient to pass as x the operand
+// with fewer terms.
+template <typename T, typename U>
+inline bool poly_mul_disjoint(const T &x, const U &y)
+{
+    assert(x.get_symbol_set_fw() == y.get_symbol_set_fw());
+
+    const auto &ss = x.get_symbol_set();
+
+    // Determine the indices of the symbols appearing in x.
+    const auto tx = detail::poly_mul_trim_identify(x);
+    ::std::vector<decltype(tx.size())> x_idx;
+    for (decltype(tx.size()) i = 0; i < tx.size(); ++i) {
+        if (tx[i] == 0) {
+            x_idx.push_back(i);
+        }
+    }
+
+    if (x_idx.empty()) {
+        return true;
+    }
+
+    // Scan y, checking after each key if any
+    // of the symbols of x appeared.
+    // NOTE: key_trim_identify() only ever clears
+    // the values in ty, thus it is enough to check
+    // the values at the indices x_idx.
+    ::std::vector<int> ty(tx.size(), 1);
+    for (const auto &t : y) {
+        ::obake::key_trim_identify(ty, t.first, ss);
+
+        for (const auto i : x_idx) {
+            if (ty[i] == 0) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Poly multiplication for operands depending on disjoint
+// subsets of the symbol set. In this case, all the products
+// of the terms of x by the terms of y have distinct keys,
+// thus the terms can be inserted into retval without probing
+// for existing keys, and the size of retval is known exactly
+// in advance. If homomorphic hashing is available, the
+// term (k1, k2) ends up in the table (hash(k1) + hash(k2)) mod n_tables
+// of retval: the terms of x and y are bucketed according to
+// their hashes, and the tables of retval are then computed in
+// parallel without any synchronisation. The number of segments
+// is deduced, like in poly_mul_impl_mt_hm(), from the segment
+// sizes in the multiplication policy mp.
+template <typename Ret, typename T, typename U>
+inline void poly_mul_impl_tensor(Ret &retval, const T &x, const U &y, const mul_policy &mp)
+{
+    using ret_key_t = series_key_t<Ret>;
+    using ret_cf_t = series_cf_t<Ret>;
+    using s_size_t = typename remove_cvref_t<decltype(retval._get_s_table())>::size_type;
+
+    // Preconditions.
+    assert(!x.empty());
+    assert(!y.empty());
+    assert(retval.empty());
+    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
+    assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
+
+    // Cache the symbol set.
+    const auto &ss = retval.get_symbol_set();
+
+    // Do the monomial overflow checking, if possible.
+    const auto r1
+        = ::obake::detail::make_range(::boost::make_transform_iterator(x.begin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(x.end(), poly_term_key_ref_extractor{}));
+    const auto r2
+        = ::obake::detail::make_range(::boost::make_transform_iterator(y.begin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(y.end(), poly_term_key_ref_extractor{}));
+    if constexpr (are_overflow_testable_monomial_ranges_v<decltype(r1) &, decltype(r2) &>) {
+        if (obake_unlikely(!::obake::monomial_range_overflow_check(r1, r2, ss))) {
+            obake_throw(
+                ::std::overflow_error,
+                "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+        }
+    }
+
+    // Compute the total number of term-by-term multiplications,
+    // which is also the final size of retval.
+    const auto n_mults = ::obake::safe_cast<::std::size_t>(::mppp::integer<1>(x.size()) * y.size());
+
+    // Determine the number of segments of retval.
+    unsigned log2_nsegs = 0;
+    if constexpr (is_homomorphically_hashable_monomial_v<ret_key_t>) {
+        // Estimate the average term size from a sample
+        // of the terms of x and y.
+        // NOTE: the iteration order of the tables is
+        // unrelated to the keys, thus the first few terms
+        // are as good a sample as any.
+        constexpr auto n_sample = 16u;
+        auto sample = [](const auto &s) {
+            ::std::vector<::std::pair<series_key_t<remove_cvref_t<decltype(s)>>,
+                                      series_cf_t<remove_cvref_t<decltype(s)>>>>
+                ret;
+
+            for (auto it = s.begin(); it != s.end() && ret.size() < n_sample; ++it) {
+                ret.emplace_back(it->first, it->second);
+            }
+
+            return ret;
+        };
+        const auto avg_term_size
+            = detail::poly_mul_impl_estimate_average_term_size<ret_cf_t>(sample(x), sample(y), ss);
+
+        // NOTE: each term-by-term multiplication produces
+        // a distinct term, that is, the sparsity is 1 and the product
+        // is considered highly sparse.
+        const auto est_nsegs = (::mppp::integer<1>(n_mults) * avg_term_size) / mp.sparse_seg_size;
+        log2_nsegs = ::std::min(::obake::safe_cast<unsigned>(est_nsegs.nbits()),
+                                polynomial<ret_key_t, ret_cf_t>::get_max_s_size());
+    }
+    retval.set_n_segments(log2_nsegs);
+
+    auto &out_s_table = retval._get_s_table();
+    const auto nsegs = out_s_table.size();
+    const auto mask = nsegs - 1u;
+
+    // Bucket the terms of x and y according to
+    // the low bits of the hashes of their keys.
+    auto bucket = [nsegs, mask](const auto &s) {
+        ::std::vector<::std::vector<const series_term_t<remove_cvref_t<decltype(s)>> *>> ret(nsegs);
+
+        for (const auto &t : s) {
+            ret[(nsegs == 1u) ? s_size_t(0) : static_cast<s_size_t>(::obake::hash(t.first) & mask)].push_back(&t);
+        }
+
+        return ret;
+    };
+    const auto xb = bucket(x), yb = bucket(y);
+
+    // Compute the i-th table of retval.
+    auto mul_table = [&](s_size_t i) {
+        auto &tab = out_s_table[i];
+
+        // Reserve the exact number of terms.
+        ::std::size_t n_terms = 0;
+        for (s_size_t a = 0; a < nsegs; ++a) {
+            n_terms += xb[a].size() * yb[(i - a) & mask].size();
+        }
+        tab.reserve(n_terms);
+
+        // Temporary variable used in monomial multiplication.
+        ret_key_t tmp_key(ss);
+
+        for (s_size_t a = 0; a < nsegs; ++a) {
+            const auto &yv = yb[(i - a) & mask];
+
+            for (const auto &t1 : xb[a]) {
+                const auto &k1 = t1->first;
+                const auto &c1 = t1->second;
+
+                for (const auto &t2 : yv) {
+                    ::obake::monomial_mul(tmp_key, k1, t2->first, ss);
+
+                    // NOTE: keep the zero check, as the coefficient
+                    // product could be zero for some coefficient types,
+                    // and the table size check (which is just a comparison).
+                    detail::series_add_term_table<true, sat_check_zero::on, sat_check_compat_key::off,
+                                                  sat_check_table_size::on, sat_assume_unique::on>(
+                        retval, tab, ::std::as_const(tmp_key), c1 * t2->second);
+                }
+            }
+        }
+    };
+
+    try {
+        if (nsegs > 1u) {
+            ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, nsegs), [&mul_table](const auto &range) {
+                for (auto i = range.begin(); i != range.end(); ++i) {
+                    mul_table(i);
+                }
+            });
+        } else {
+            mul_table(0);
+        }
+        // LCOV_EXCL_START
+    } catch (...) {
+        // NOTE: retval may now be only partially
+        // filled. Clear it before rethrowing.
+        retval.clear();
+        throw;
+    }
+    // LCOV_EXCL_STOP
+
+    assert(retval.size() <= n_mults);
+}
+
+// Establish if x can be multiplied in place by a single-term
+// polynomial of type U via poly_mul_impl_monomial_inplace(),
+// with Ret being the type of the product. We need:
+// - the product to be of the same type as x,
+// - homomorphic hashing for the key type,
+// - the ability to multiply in place the coefficients of
+//   x by the coefficient of the single term.
+template <typename Ret, typename T, typename U>
+inline constexpr bool poly_mul_inplace_algo
+    = ::std::conjunction_v<::std::is_same<Ret, T>, is_homomorphically_hashable_monomial<series_key_t<T>>,
+                           is_in_place_multipliable<series_cf_t<T> &, const series_cf_t<U> &>>;
+
+// In-place version of poly_mul_impl_monomial(): multiply
+// x in place by the single term of y. The return value
+// signals whether the multiplication was performed: the
+// in-place multiplication is possible only if y has a single
+// term, x is not empty, x and y have identical symbol sets
+// and they are distinct objects. If false is returned, x
+// is left untouched. The segmentation of x is preserved.
+// If an exception is thrown during the multiplication of the
+// terms, x is left without terms (but it retains its symbol
+// set and tag).
+template <typename T, typename U>
+inline bool poly_mul_impl_monomial_inplace(T &x, const U &y)
+{
+    using key_t = series_key_t<T>;
+    using table_t = typename T::table_type;
+    using s_size_t = typename remove_cvref_t<decltype(x._get_s_table())>::size_type;
+
+    static_assert(is_homomorphically_hashable_monomial_v<key_t>);
+
+    if (y.size() != 1u || x.empty() || x.get_symbol_set_fw() != y.get_symbol_set_fw()
+        || static_cast<const void *>(&x) == static_cast<const void *>(&y)) {
+        return false;
+    }
+
+    // Cache the symbol set.
+    const auto &ss = x.get_symbol_set();
+
+    // Do the monomial overflow checking, if possible.
+    const auto r1
+        = ::obake::detail::make_range(::boost::make_transform_iterator(x.begin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(x.end(), poly_term_key_ref_extractor{}));
+    const auto r2
+        = ::obake::detail::make_range(::boost::make_transform_iterator(y.begin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(y.end(), poly_term_key_ref_extractor{}));
+    if constexpr (are_overflow_testable_monomial_ranges_v<decltype(r1) &, decltype(r2) &>) {
+        if (obake_unlikely(!::obake::monomial_range_overflow_check(r1, r2, ss))) {
+            obake_throw(
+                ::std::overflow_error,
+                "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+        }
+    }
+
+    // Fetch the single term of y.
+    const auto &k2 = y.begin()->first;
+    const auto &c2 = y.begin()->second;
+
+    auto &s_table = x._get_s_table();
+    const auto n_tables = s_table.size();
+
+    // Multiply the terms in the i-th table of x. The table
+    // is rebuilt with the new keys, and the coefficients are
+    // multiplied in place and then moved into the new table.
+    auto mul_table = [&](s_size_t i) {
+        auto &tab = s_table[i];
+
+        table_t new_tab;
+        new_tab.reserve(tab.size());
+
+        // Temporary variable used in monomial multiplication.
+        key_t tmp_key(ss);
+
+        for (auto &t : tab) {
+            ::obake::monomial_mul(tmp_key, t.first, k2, ss);
+            t.second *= c2;
+
+            detail::series_add_term_table<true, sat_check_zero::on, sat_check_compat_key::off,
+                                          sat_check_table_size::off, sat_assume_unique::on>(
+                x, new_tab, ::std::as_const(tmp_key), ::std::move(t.second));
+        }
+
+        tab = ::std::move(new_tab);
+    };
+
+    try {
+        if (n_tables > 1u) {
+            ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, n_tables), [&mul_table](const auto &range) {
+                for (auto i = range.begin(); i != range.end(); ++i) {
+                    mul_table(i);
+                }
+            });
+
+            // Because of homomorphic hashing, the terms originally
+            // in the i-th table now belong to the table
+            // (i + hash(k2)) mod n_tables: rotate the tables accordingly.
+            const auto shift = static_cast<s_size_t>(::obake::hash(k2) & (n_tables - 1u));
+            ::std::rotate(s_table.begin(), s_table.begin() + static_cast<decltype(s_table.end() - s_table.begin())>(
+                                                                 (n_tables - shift) & (n_tables - 1u)),
+                          s_table.end());
+        } else {
+            mul_table(0);
+        }
         // LCOV_EXCL_START
     } catch (...) {
-        // retval may now contain zero coefficients.
-        // Make sure to clear it before rethrowing.
-        tab.clear();
+        // NOTE: x may now be in an inconsistent state.
+        // Clear its terms before rethrowing.
+        x.clear_terms();
         throw;
-        // LCOV_EXCL_STOP
     }
+    // LCOV_EXCL_STOP
+
+    return true;
 }
 
 // Implementation of poly multiplication with identical symbol sets.
@@ -1911,6 +4346,79 @@ inline auto poly_mul_impl_identical_ss(const T &x, const U &y, const Args &...ar
         return retval;
     }
 
+    // Fetch the multiplication policy, which is
+    // then passed down to the multiplication algorithms.
+    [[maybe_unused]] const auto mp = polynomials::get_mul_policy();
+
+    if constexpr (sizeof...(Args) == 0u && is_homomorphically_hashable_monomial_v<ret_key_t>) {
+        // For untruncated products by a single term, each
+        // table of y can be mapped directly onto a table of retval.
+        if (x.size() == 1u) {
+            detail::poly_mul_impl_monomial(retval, x, y);
+
+            return retval;
+        }
+    }
+
+    if constexpr (sizeof...(Args) == 0u && is_trim_identifiable_key_v<const ret_key_t &>) {
+        // For untruncated products of operands which depend
+        // on disjoint subsets of the symbol set, all term
+        // products are distinct: use the tensor product
+        // implementation, which needs no collision handling.
+        // NOTE: when squaring, the operands cannot depend
+        // on disjoint subsets of the symbol set (a polynomial
+        // with more than one term contains at least one non-constant
+        // key), thus skip the check.
+        if (x.size() > 1u && static_cast<const void *>(&x) != static_cast<const void *>(&y)
+            && detail::poly_mul_disjoint(x, y)) {
+            detail::poly_mul_impl_tensor(retval, x, y, mp);
+
+            return retval;
+        }
+    }
+
+    if constexpr (sizeof...(Args) == 0u && detail::poly_mul_kbox_algo<ret_t>) {
+        // For untruncated products, run the heap-based
+        // implementation if the cost model says so.
+        if (detail::poly_mul_heap_cost_model(::obake::safe_cast<::std::size_t>(x.size()),
+                                             ::obake::safe_cast<::std::size_t>(y.size()), mp)
+            && detail::poly_mul_impl_heap(retval, x, y)) {
+            return retval;
+        }
+    }
+
+    if constexpr (sizeof...(Args) == 0u
+                  && detail::poly_mul_kronecker_algo<ret_t, series_cf_t<T>, series_cf_t<U>>) {
+        // For large untruncated products of polynomials with
+        // multiprecision integral coefficients, try the Kronecker
+        // substitution and multi-modular algorithms. Sparse products, for
+        // which the dense representation of the product would be mostly
+        // made of empty slots, are rejected by the cost model and left to
+        // the other algorithms.
+        if (x.size() >= mp.kronecker_min_size) {
+            bool done = false;
+            detail::poly_mul_sqr_dispatch(x, y, [&](auto sqr) {
+                done = detail::poly_mul_impl_int<decltype(sqr)::value>(retval, x, y,
+                                                                       poly_mul_int_algorithm::automatic, mp);
+            });
+
+            if (done) {
+                return retval;
+            }
+        }
+    }
+
+    if constexpr (sizeof...(Args) == 0u && detail::poly_mul_fft_algo<ret_t, series_cf_t<T>, series_cf_t<U>>) {
+        // For large untruncated products of polynomials with
+        // double coefficients, try the FFT algorithm. As above,
+        // sparse products are rejected by the cost model. The
+        // FFT algorithm is also rejected if its result would not be
+        // accurate enough (see poly_mul_fft()).
+        if (x.size() >= mp.fft_min_size && detail::poly_mul_impl_fft(retval, x, y, false, mp)) {
+            return retval;
+        }
+    }
+
     if constexpr (::std::conjunction_v<is_homomorphically_hashable_monomial<ret_key_t>,
                                        // Need also to be able to measure the byte size
                                        // of x, y, and the key/cf of ret_t, via const lvalue references.
@@ -1926,20 +4434,26 @@ inline auto poly_mul_impl_identical_ss(const T &x, const U &y, const Args &...ar
         // Establish the max byte size of the input series.
         const auto max_bs = ::std::max(::obake::byte_size(x), ::obake::byte_size(y));
 
-        if ((x.size() == 1u && y.size() == 1u) || max_bs < 30000ul || ::obake::detail::hc() == 1u) {
-            // Run the simple implementation if either:
-            // - both polys have only 1 term, or
-            // - the maximum operand size is less than a threshold value, or
-            // - we have just 1 core.
-            detail::poly_mul_impl_simple(retval, x, y, args...);
-        } else {
-            // Otherwise, run the MT implementation.
-            detail::poly_mul_impl_mt_hm(retval, x, y, args...);
-        }
+        // NOTE: if x and y are the same object, the
+        // squaring mode will be used.
+        detail::poly_mul_sqr_dispatch(x, y, [&](auto sqr) {
+            if ((x.size() == 1u && y.size() == 1u) || max_bs < 30000ul || ::obake::detail::hc() == 1u) {
+                // Run the simple implementation if either:
+                // - both polys have only 1 term, or
+                // - the maximum operand size is less than a threshold value, or
+                // - we have just 1 core.
+                detail::poly_mul_impl_simple<false, decltype(sqr)::value>(retval, x, y, args...);
+            } else {
+                // Otherwise, run the MT implementation.
+                detail::poly_mul_impl_mt_hm<false, decltype(sqr)::value>(retval, mp, x, y, args...);
+            }
+        });
     } else {
         // The monomial does not have homomorphic hashing,
         // just use the simple implementation.
-        detail::poly_mul_impl_simple(retval, x, y, args...);
+        detail::poly_mul_sqr_dispatch(x, y, [&](auto sqr) {
+            detail::poly_mul_impl_simple<false, decltype(sqr)::value>(retval, x, y, args...);
+        });
     }
 
     return retval;
@@ -1964,10 +4478,6 @@ inline auto poly_mul_impl_identical_ss(const T &x, const U &y, const Args &...ar
 // - in highly rectangular multiplications, the series size
 //   estimation is quite poor (see comments on top of the
 //   function). Not sure what we could do about it;
-// - when constructing vectors of indices, or when building
-//   vectors of degrees, we could improve performance by using
-//   a default-constructing allocator, in order to avoid zeroing
-//   out data which we will be overwriting anyway;
 // - perhaps vector permutations could be done in parallel?
 template <typename T, typename U, typename... Args>
 inline auto poly_mul_impl(const T &x, const U &y, const Args &...args)
@@ -2038,6 +4548,97 @@ inline auto poly_mul_impl_switch(const T &x, const U &y, const Args &...args)
     }
 }
 
+// Implementation of the fused multiply-accumulate
+// retval += x * y (possibly truncated according to args)
+// for polynomials with identical symbol sets.
+// Requires that x is not longer than y, and that
+// retval does not overlap with x or y. The return value
+// signals whether the product was accumulated into retval:
+// if false, nothing was done.
+template <typename Ret, typename T, typename U, typename... Args>
+inline bool poly_fma_impl_identical_ss(Ret &retval, const T &x, const U &y, const Args &...args)
+{
+    using ret_key_t = series_key_t<Ret>;
+
+    // Check the preconditions.
+    static_assert(::std::is_same_v<Ret, poly_mul_ret_t<T, U>>);
+    assert(x.size() <= y.size());
+    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
+    assert(x.get_symbol_set_fw() == y.get_symbol_set_fw());
+
+    if (x.empty() || y.empty()) {
+        // Nothing to accumulate.
+        return true;
+    }
+
+    if (retval.empty()) {
+        // If retval is empty, just run the plain
+        // multiplication, which can select among
+        // all the available algorithms.
+        // NOTE: preserve the tag of retval.
+        auto orig_tag = retval.tag();
+        retval = detail::poly_mul_impl_identical_ss(x, y, args...);
+        retval.tag() = ::std::move(orig_tag);
+
+        return true;
+    }
+
+    // NOTE: the algorithm selection mirrors
+    // poly_mul_impl_identical_ss().
+    if constexpr (::std::conjunction_v<is_homomorphically_hashable_monomial<ret_key_t>,
+                                       is_size_measurable<const T &>, is_size_measurable<const U &>,
+                                       is_size_measurable<const ret_key_t &>,
+                                       is_size_measurable<const series_cf_t<Ret> &>>) {
+        const auto max_bs = ::std::max(::obake::byte_size(x), ::obake::byte_size(y));
+
+        if (!((x.size() == 1u && y.size() == 1u) || max_bs < 30000ul || ::obake::detail::hc() == 1u)) {
+            // Run the MT implementation, accumulating
+            // directly into the segments of retval.
+            detail::poly_mul_sqr_dispatch(x, y, [&](auto sqr) {
+                detail::poly_mul_impl_mt_hm<true, decltype(sqr)::value>(retval, x, y, args...);
+            });
+
+            return true;
+        }
+    }
+
+    // The simple implementation can accumulate only
+    // into a non-segmented retval.
+    if (retval._get_s_table().size() == 1u) {
+        detail::poly_mul_sqr_dispatch(x, y, [&](auto sqr) {
+            detail::poly_mul_impl_simple<true, decltype(sqr)::value>(retval, x, y, args...);
+        });
+
+        return true;
+    }
+
+    return false;
+}
+
+// Top level function for the fused multiply-accumulate
+// retval += x * y (possibly truncated according to args). The return value
+// signals whether the product was accumulated into retval: if false,
+// nothing was done and the caller must fall back to the
+// usual multiplication + addition.
+// NOTE: the fused implementation is used only if the symbol sets
+// of retval, x and y are identical (i.e., no symbol merging is needed)
+// and if retval does not overlap with x or y.
+template <typename Ret, typename T, typename U, typename... Args>
+inline bool poly_fma_impl(Ret &retval, const T &x, const U &y, const Args &...args)
+{
+    if (static_cast<const void *>(&retval) == static_cast<const void *>(&x)
+        || static_cast<const void *>(&retval) == static_cast<const void *>(&y)
+        || retval.get_symbol_set_fw() != x.get_symbol_set_fw() || x.get_symbol_set_fw() != y.get_symbol_set_fw()) {
+        return false;
+    }
+
+    if (x.size() <= y.size()) {
+        return detail::poly_fma_impl_identical_ss(retval, x, y, args...);
+    } else {
+        return detail::poly_fma_impl_identical_ss(retval, y, x, args...);
+    }
+}
+
 } // namespace detail
 
 template <typename K, typename C0, typename C1>
@@ -2047,6 +4648,98 @@ requires(detail::poly_mul_algo<polynomial<K, C0>, polynomial<K, C1>> != 0) inlin
     return detail::poly_mul_impl_switch(x, y);
 }
 
+// Overloads for mutable rvalue operands: if the other operand
+// consists of a single term, the rvalue operand may be multiplied
+// in place.
+template <typename K, typename C0, typename C1>
+requires(detail::poly_mul_algo<polynomial<K, C0>, polynomial<K, C1>> != 0) inline detail::poly_mul_ret_t<
+    polynomial<K, C0>, polynomial<K, C1>> series_mul(polynomial<K, C0> &&x, const polynomial<K, C1> &y)
+{
+    using ret_t = detail::poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>>;
+
+    if constexpr (detail::poly_mul_inplace_algo<ret_t, polynomial<K, C0>, polynomial<K, C1>>) {
+        if (detail::poly_mul_impl_monomial_inplace(x, y)) {
+            return ::std::move(x);
+        }
+    }
+
+    return detail::poly_mul_impl_switch(x, y);
+}
+
+template <typename K, typename C0, typename C1>
+requires(detail::poly_mul_algo<polynomial<K, C0>, polynomial<K, C1>> != 0) inline detail::poly_mul_ret_t<
+    polynomial<K, C0>, polynomial<K, C1>> series_mul(const polynomial<K, C0> &x, polynomial<K, C1> &&y)
+{
+    using ret_t = detail::poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>>;
+
+    if constexpr (detail::poly_mul_inplace_algo<ret_t, polynomial<K, C1>, polynomial<K, C0>>) {
+        if (detail::poly_mul_impl_monomial_inplace(y, x)) {
+            return ::std::move(y);
+        }
+    }
+
+    return detail::poly_mul_impl_switch(x, y);
+}
+
+template <typename K, typename C0, typename C1>
+requires(detail::poly_mul_algo<polynomial<K, C0>, polynomial<K, C1>> != 0) inline detail::poly_mul_ret_t<
+    polynomial<K, C0>, polynomial<K, C1>> series_mul(polynomial<K, C0> &&x, polynomial<K, C1> &&y)
+{
+    using ret_t = detail::poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>>;
+
+    if constexpr (detail::poly_mul_inplace_algo<ret_t, polynomial<K, C0>, polynomial<K, C1>>) {
+        if (detail::poly_mul_impl_monomial_inplace(x, y)) {
+            return ::std::move(x);
+        }
+    }
+
+    if constexpr (detail::poly_mul_inplace_algo<ret_t, polynomial<K, C1>, polynomial<K, C0>>) {
+        if (detail::poly_mul_impl_monomial_inplace(y, x)) {
+            return ::std::move(y);
+        }
+    }
+
+    return detail::poly_mul_impl_switch(x, y);
+}
+
+namespace detail
+{
+
+// Establish if the fused multiply-accumulate is
+// available for the polynomial type T.
+template <typename T>
+constexpr bool poly_fma3_algorithm_impl()
+{
+    if constexpr (poly_mul_algo<T, T> != 0) {
+        // NOTE: the product must be of type T, and we need
+        // the in-place addition for the fallback implementation.
+        return ::std::conjunction_v<::std::is_same<poly_mul_ret_t<T, T>, T>, is_in_place_addable<T &, T>>;
+    } else {
+        return false;
+    }
+}
+
+template <typename T>
+inline constexpr bool poly_fma3_algo = detail::poly_fma3_algorithm_impl<T>();
+
+} // namespace detail
+
+// Fused multiply-accumulate: ret += x * y.
+// If possible, the product is accumulated directly into ret,
+// without creating a temporary polynomial. Otherwise, the
+// usual multiplication + addition will be performed.
+// NOTE: this is enabled only if the three polynomials are of the same type.
+// NOTE: if an exception is thrown, ret may be left in
+// a valid but unspecified state.
+template <typename K, typename C>
+requires(detail::poly_fma3_algo<polynomial<K, C>>) inline void fma3(polynomial<K, C> &ret, const polynomial<K, C> &x,
+                                                                  const polynomial<K, C> &y)
+{
+    if (!detail::poly_fma_impl(ret, x, y)) {
+        ret += x * y;
+    }
+}
+
 namespace detail
 {
 
@@ -2113,43 +4806,508 @@ constexpr auto poly_mul_truncated_degree_algorithm_impl()
     }
 }
 
-template <typename T, typename U, typename V>
-inline constexpr auto poly_mul_truncated_degree_algo
-    = detail::poly_mul_truncated_degree_algorithm_impl<T, U, V, true>();
+template <typename T, typename U, typename V>
+inline constexpr auto poly_mul_truncated_degree_algo
+    = detail::poly_mul_truncated_degree_algorithm_impl<T, U, V, true>();
+
+template <typename T, typename U, typename V>
+inline constexpr auto poly_mul_truncated_p_degree_algo
+    = detail::poly_mul_truncated_degree_algorithm_impl<T, U, V, false>();
+
+} // namespace detail
+
+// Truncated multiplication.
+// NOTE: do we need the type traits/concepts as well?
+// NOTE: should these be function objects?
+template <typename K, typename C0, typename C1, typename V>
+requires(detail::poly_mul_truncated_degree_algo<polynomial<K, C0>, polynomial<K, C1>, V> != 0) inline detail::
+    poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>> truncated_mul(const polynomial<K, C0> &x,
+                                                                       const polynomial<K, C1> &y, const V &max_degree)
+{
+    return detail::poly_mul_impl_switch(x, y, max_degree);
+}
+
+template <typename K, typename C0, typename C1, typename V>
+requires(detail::poly_mul_truncated_p_degree_algo<polynomial<K, C0>, polynomial<K, C1>, V> != 0) inline detail::
+    poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>> truncated_mul(const polynomial<K, C0> &x,
+                                                                       const polynomial<K, C1> &y, const V &max_degree,
+                                                                       const symbol_set &s)
+{
+    return detail::poly_mul_impl_switch(x, y, max_degree, s);
+}
+
+namespace detail
+{
+
+// The algorithms available for the exponentiation
+// of a multi-term polynomial to a natural power.
+enum class poly_pow_algorithm {
+    // Repeated multiplications by the base,
+    // backed by the global pow cache.
+    cache,
+    // Repeated multiplications by the base,
+    // without the pow cache.
+    repeated,
+    // Binary exponentiation (square-and-multiply).
+    binary,
+    // J.C.P. Miller's recurrence.
+    miller
+};
+
+// Metaprogramming to establish if the exponentiation of a polynomial
+// of type T to a natural power can be computed via the algorithms
+// of poly_pow_impl(). Both binary exponentiation and the pow cache
+// require that the product of two T is again a T.
+template <typename T>
+constexpr bool poly_pow_algorithm_impl()
+{
+    static_assert(::std::is_same_v<T, remove_cvref_t<T>>);
+
+    if constexpr (poly_mul_algo<T, T> == 0) {
+        return false;
+    } else {
+        return ::std::conjunction_v<
+            ::std::is_same<T, poly_mul_ret_t<T, T>>,
+            ::std::bool_constant<customisation::internal::series_default_pow_algo<const T &, const unsigned &> != 0>,
+            ::std::is_same<T, customisation::internal::series_default_pow_ret_t<const T &, const unsigned &>>>;
+    }
+}
+
+template <typename T>
+inline constexpr bool poly_pow_algo = detail::poly_pow_algorithm_impl<T>();
+
+// Helper to compute the (partial) degree of the key k of a polynomial
+// with symbol set ss, according to the truncation limits args (i.e.,
+// total degree if only the max degree is present, partial degree otherwise).
+// si is the set of indices of the symbols, in ss, of the partial degree truncation.
+template <typename K, typename... Args>
+inline auto poly_pow_key_degree(const K &k, const symbol_set &ss, [[maybe_unused]] const symbol_idx_set &si,
+                                const Args &...)
+{
+    static_assert(sizeof...(Args) == 1u || sizeof...(Args) == 2u);
+
+    if constexpr (sizeof...(Args) == 1u) {
+        return ::obake::key_degree(k, ss);
+    } else {
+        return ::obake::key_p_degree(k, si, ss);
+    }
+}
+
+// Metaprogramming to establish if J.C.P. Miller's recurrence can be used
+// to compute the power of a polynomial of type T, truncated according to Args.
+// Writing x = P_0 + P_1 + ... , where P_k is the homogeneous component
+// of x of (partial) degree k and P_0 is a nonzero constant, the homogeneous
+// components of x**n can be computed via the recurrence
+//
+// Q_0 = P_0**n, Q_m = 1 / (m * P_0) * sum_{k=1}^m ((n + 1) * k - m) * P_k * Q_{m-k},
+//
+// which can be deduced from the identity x * E(x**n) = n * x**n * E(x), where
+// E is the Euler operator. We require that:
+// - the degree of the keys is integral, and the truncation limit is integral too,
+// - the coefficients do not have a degree (so that the degree of a term
+//   is the degree of its key),
+// - the coefficients can be constructed from long long, and they can be
+//   multiplied and exponentiated to unsigned powers, yielding the coefficient type,
+// - the polynomial can be multiplied and divided in-place by a coefficient, and it
+//   can be added in-place to another polynomial.
+template <typename T, typename... Args>
+constexpr bool poly_pow_miller_algorithm_impl()
+{
+    if constexpr (sizeof...(Args) == 0u || sizeof...(Args) > 2u || !detail::poly_pow_algo<T>) {
+        return false;
+    } else {
+        using cf_t = series_cf_t<T>;
+        using key_t = series_key_t<T>;
+        using deg_t = ::std::conditional_t<sizeof...(Args) == 1u,
+                                           detected_t<::obake::detail::key_degree_t, const key_t &>,
+                                           detected_t<::obake::detail::key_p_degree_t, const key_t &>>;
+        using lim_t = remove_cvref_t<::std::tuple_element_t<0, ::std::tuple<Args...>>>;
+
+        return ::std::conjunction_v<
+            ::std::is_integral<deg_t>, ::std::is_integral<lim_t>,
+            ::std::negation<is_with_degree<const cf_t &>>, ::std::negation<is_with_p_degree<const cf_t &>>,
+            ::std::is_constructible<cf_t, long long>,
+            ::std::is_same<cf_t, detected_t<::obake::detail::mul_t, const cf_t &, const cf_t &>>,
+            ::std::is_same<cf_t, detected_t<::obake::detail::pow_t, const cf_t &, const unsigned &>>,
+            is_in_place_multipliable<T &, const cf_t &>, is_in_place_divisible<T &, const cf_t &>,
+            is_in_place_addable<T &, T>>;
+    }
+}
+
+template <typename T, typename... Args>
+inline constexpr bool poly_pow_miller_algo = detail::poly_pow_miller_algorithm_impl<T, Args...>();
+
+// Check if J.C.P. Miller's recurrence can be used to compute
+// a power of x truncated according to args. This requires that
+// the truncation limit is not negative, that x has a constant term and
+// that all the other terms of x have positive (partial) degree.
+template <typename T, typename... Args>
+inline bool poly_pow_miller_check(const T &x, const Args &...args)
+{
+    static_assert(detail::poly_pow_miller_algo<T, Args...>);
+
+    if constexpr (::std::is_signed_v<remove_cvref_t<decltype(::std::get<0>(::std::forward_as_tuple(args...)))>>) {
+        if (::std::get<0>(::std::forward_as_tuple(args...)) < 0) {
+            return false;
+        }
+    }
+
+    const auto &ss = x.get_symbol_set();
+    const auto si = [&]() {
+        if constexpr (sizeof...(Args) == 2u) {
+            return ::obake::detail::ss_intersect_idx(::std::get<1>(::std::forward_as_tuple(args...)), ss);
+        } else {
+            return symbol_idx_set{};
+        }
+    }();
+
+    bool has_cterm = false;
+    for (const auto &t : x) {
+        const auto d = detail::poly_pow_key_degree(t.first, ss, si, args...);
+
+        if constexpr (::std::is_signed_v<decltype(d)>) {
+            if (d < 0) {
+                return false;
+            }
+        }
+
+        if (d == 0) {
+            if (has_cterm || !::obake::key_is_one(t.first, ss)) {
+                // NOTE: with negative exponents, more than
+                // one term may have zero (partial) degree.
+                return false;
+            }
+            has_cterm = true;
+        }
+    }
+
+    return has_cterm;
+}
+
+// Exponentiation of the polynomial x to the natural power n
+// via J.C.P. Miller's recurrence (see above), truncated
+// according to args.
+// NOTE: the number of term-by-term multiplications is roughly
+// the same as in the product of x by the result. The cost is thus
+// a fraction of the cost of binary exponentiation when x is much
+// shorter than the result (e.g., in dense truncated cases).
+template <typename T, typename... Args>
+inline T poly_pow_miller(const T &x, unsigned n, const Args &...args)
+{
+    using cf_t = series_cf_t<T>;
+    using key_t = series_key_t<T>;
+    using s_sat = ::obake::detail::sat_check_zero;
+    using s_sac = ::obake::detail::sat_check_compat_key;
+    using s_sats = ::obake::detail::sat_check_table_size;
+    using s_sau = ::obake::detail::sat_assume_unique;
+
+    assert(n >= 2u);
+    assert(detail::poly_pow_miller_check(x, args...));
+
+    const auto &ss = x.get_symbol_set();
+    const auto si = [&]() {
+        if constexpr (sizeof...(Args) == 2u) {
+            return ::obake::detail::ss_intersect_idx(::std::get<1>(::std::forward_as_tuple(args...)), ss);
+        } else {
+            return symbol_idx_set{};
+        }
+    }();
+
+    // Helper to create an empty polynomial
+    // with the symbol set of x.
+    auto make_empty = [&x]() {
+        T retval;
+        retval.set_symbol_set_fw(x.get_symbol_set_fw());
+        return retval;
+    };
+
+    // Split x into its homogeneous components.
+    ::std::vector<T> vp;
+    for (const auto &t : x) {
+        const auto d = ::obake::safe_cast<typename ::std::vector<T>::size_type>(
+            detail::poly_pow_key_degree(t.first, ss, si, args...));
+
+        while (vp.size() <= d) {
+            vp.push_back(make_empty());
+        }
+
+        ::obake::detail::series_add_term<true, s_sat::off, s_sac::off, s_sats::on, s_sau::on>(vp[d], t.first,
+                                                                                             t.second);
+    }
+    assert(vp.size() >= 2u);
+    assert(vp[0].size() == 1u);
+
+    // The constant term of x.
+    const auto &c0 = vp[0].cbegin()->second;
+
+    // The maximum degree of the result: the truncation
+    // limit, or the degree of x**n if smaller.
+    const auto max_deg = ::obake::safe_cast<typename ::std::vector<T>::size_type>(
+        ::std::min(::mppp::integer<1>{::std::get<0>(::std::forward_as_tuple(args...))},
+                   ::mppp::integer<1>{n} * (vp.size() - 1u)));
+
+    // Compute the homogeneous components of the result.
+    ::std::vector<T> vq;
+    vq.reserve(max_deg + 1u);
+    vq.push_back(make_empty());
+    ::obake::detail::series_add_term<true, s_sat::on, s_sac::off, s_sats::off, s_sau::on>(
+        vq[0], key_t(ss), ::obake::pow(c0, ::std::as_const(n)));
+
+    for (decltype(vq.size()) m = 1; m <= max_deg; ++m) {
+        auto acc = make_empty();
+
+        for (decltype(vq.size()) k = 1; k <= ::std::min(m, vp.size() - 1u); ++k) {
+            const auto &pk = vp[k];
+            const auto &qmk = vq[m - k];
+
+            if (pk.empty() || qmk.empty()) {
+                continue;
+            }
+
+            const auto f = (::mppp::integer<1>{n} + 1) * k - m;
+            if (f.is_zero()) {
+                continue;
+            }
+
+            auto tmp = detail::poly_mul_impl_switch(pk, qmk);
+            tmp *= cf_t(::obake::safe_cast<long long>(f));
+            acc += ::std::move(tmp);
+        }
+
+        acc /= cf_t(::obake::safe_cast<long long>(m)) * c0;
+        vq.push_back(::std::move(acc));
+    }
+
+    // Assemble the result.
+    // NOTE: the homogeneous components have
+    // no keys in common.
+    auto retval = make_empty();
+    for (auto &q : vq) {
+        for (auto &t : q) {
+            ::obake::detail::series_add_term<true, s_sat::off, s_sac::off, s_sats::on, s_sau::on>(
+                retval, t.first, ::std::move(t.second));
+        }
+        // NOTE: q now contains moved-from coefficients,
+        // clear it in order to preserve the class invariants.
+        q.clear_terms();
+    }
+
+    return retval;
+}
+
+// Exponentiation of the polynomial x to the natural power n via
+// binary exponentiation (left-to-right square-and-multiply),
+// truncated according to args.
+template <typename T, typename... Args>
+inline T poly_pow_binary(const T &x, unsigned n, const Args &...args)
+{
+    assert(n >= 2u);
+
+    // NOTE: the first step is always a squaring. Here and
+    // below, the squaring mode of the multiplication is used.
+    auto retval = detail::poly_mul_impl_switch(x, x, args...);
+    if (n & (1u << (::std::bit_width(n) - 2))) {
+        retval = detail::poly_mul_impl_switch(retval, x, args...);
+    }
+
+    for (auto i = ::std::bit_width(n) - 2; i > 0; --i) {
+        retval = detail::poly_mul_impl_switch(retval, retval, args...);
+        if (n & (1u << (i - 1))) {
+            retval = detail::poly_mul_impl_switch(retval, x, args...);
+        }
+    }
+
+    return retval;
+}
+
+// Exponentiation of the polynomial x to the natural power n via
+// repeated multiplications by x, truncated according to args.
+// Contrary to the pow cache, the intermediate powers are not stored.
+template <typename T, typename... Args>
+inline T poly_pow_repeated(const T &x, unsigned n, const Args &...args)
+{
+    assert(n >= 2u);
 
-template <typename T, typename U, typename V>
-inline constexpr auto poly_mul_truncated_p_degree_algo
-    = detail::poly_mul_truncated_degree_algorithm_impl<T, U, V, false>();
+    auto retval = detail::poly_mul_impl_switch(x, x, args...);
+    for (auto i = 2u; i < n; ++i) {
+        retval = detail::poly_mul_impl_switch(retval, x, args...);
+    }
 
-} // namespace detail
+    return retval;
+}
 
-// Truncated multiplication.
-// NOTE: do we need the type traits/concepts as well?
-// NOTE: should these be function objects?
-template <typename K, typename C0, typename C1, typename V>
-requires(detail::poly_mul_truncated_degree_algo<polynomial<K, C0>, polynomial<K, C1>, V> != 0) inline detail::
-    poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>> truncated_mul(const polynomial<K, C0> &x,
-                                                                       const polynomial<K, C1> &y, const V &max_degree)
+// Helper to build a function object estimating the number of
+// terms in x**k, truncated according to args. The estimate is the minimum of:
+// - binomial(k + t - 1, t - 1), where t is the number of terms in x
+//   (i.e., the number of terms in x**k if no monomials combine);
+// - binomial(D + v, v), that is, the number of monomials in v variables
+//   with total degree up to D, where v is the number of symbols
+//   and D is the maximum total degree of the terms of x**k (i.e.,
+//   k times the degree of x, or the truncation limit if lower). This bound
+//   is used only if the keys have integral degrees and if the exponents
+//   of x are non-negative.
+template <typename T, typename... Args>
+inline auto poly_pow_size_estimator(const T &x, const Args &...args)
 {
-    return detail::poly_mul_impl_switch(x, y, max_degree);
+    using key_t = series_key_t<T>;
+
+    // Helper to compute binomial(a + b, b) in floating point.
+    auto bin = [](double a, double b) {
+        return ::std::exp(::std::lgamma(a + b + 1) - ::std::lgamma(a + 1) - ::std::lgamma(b + 1));
+    };
+
+    const auto t = static_cast<double>(x.size());
+    const auto v = static_cast<double>(x.get_symbol_set().size());
+
+    // The degree of x and the total degree truncation
+    // limit (negative values signal that they are not available).
+    double deg = -1, lim = -1;
+
+    if constexpr (::std::conjunction_v<
+                      ::std::is_integral<detected_t<::obake::detail::key_degree_t, const key_t &>>,
+                      ::std::is_integral<detected_t<::obake::detail::key_p_degree_t, const key_t &>>>) {
+        const auto &ss = x.get_symbol_set();
+
+        // Check that the exponents are non-negative,
+        // computing the degree of x along the way.
+        const auto nonneg = [&]() {
+            for (const auto &p : x) {
+                for (symbol_idx i = 0; i < ss.size(); ++i) {
+                    if (::obake::key_p_degree(p.first, symbol_idx_set{i}, ss) < 0) {
+                        return false;
+                    }
+                }
+                deg = ::std::max(deg, static_cast<double>(::obake::key_degree(p.first, ss)));
+            }
+            return true;
+        }();
+
+        if (!nonneg) {
+            deg = -1;
+        }
+
+        if constexpr (sizeof...(Args) == 1u) {
+            const auto &l = ::std::get<0>(::std::forward_as_tuple(args...));
+
+            if constexpr (::std::is_integral_v<remove_cvref_t<decltype(l)>>) {
+                if (deg >= 0) {
+                    lim = l < 0 ? 0. : static_cast<double>(l);
+                }
+            }
+        }
+    }
+
+    return [bin, t, v, deg, lim](unsigned k) {
+        auto retval = bin(k, t - 1);
+
+        if (deg >= 0) {
+            const auto d = lim >= 0 ? ::std::min(k * deg, lim) : k * deg;
+            retval = ::std::min(retval, bin(d, v));
+        }
+
+        return retval;
+    };
 }
 
-template <typename K, typename C0, typename C1, typename V>
-requires(detail::poly_mul_truncated_p_degree_algo<polynomial<K, C0>, polynomial<K, C1>, V> != 0) inline detail::
-    poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>> truncated_mul(const polynomial<K, C0> &x,
-                                                                       const polynomial<K, C1> &y, const V &max_degree,
-                                                                       const symbol_set &s)
+// Select the algorithm for the exponentiation of the multi-term
+// polynomial x to the natural power n, truncated according to args.
+// use_cache signals whether or not the global pow cache can be used,
+// which requires the truncation limits (if any) to be
+// encoded in the type of x.
+// NOTE: the selection rules are:
+// - if the power is already in the pow cache, use it;
+// - for truncated exponentiation, use Miller's recurrence if possible
+//   (its cost is comparable to a single multiplication of x by the result);
+// - otherwise, estimate the number of term-by-term multiplications
+//   of repeated multiplications and of binary exponentiation, and pick the cheaper
+//   option. Binary exponentiation pays off when the powers of x are sparse or
+//   saturate the truncation limit, while repeated multiplications are cheaper
+//   in the dense case (where squaring large powers dominates). Repeated
+//   multiplications go through the pow cache if possible.
+template <typename T, typename... Args>
+inline poly_pow_algorithm poly_pow_select_algorithm(const T &x, unsigned n, bool use_cache, const Args &...args)
 {
-    return detail::poly_mul_impl_switch(x, y, max_degree, s);
+    assert(n >= 2u);
+    assert(x.size() > 1u);
+
+    // Fetch the number of powers of x available in the cache.
+    const auto c_size = use_cache ? customisation::internal::series_pow_cache_size(x) : ::std::size_t(0);
+    if (n < c_size) {
+        return poly_pow_algorithm::cache;
+    }
+
+    if constexpr (detail::poly_pow_miller_algo<T, Args...>) {
+        if (n > 2u && detail::poly_pow_miller_check(x, args...)) {
+            return poly_pow_algorithm::miller;
+        }
+    }
+
+    const auto est = detail::poly_pow_size_estimator(x, args...);
+    const auto t = static_cast<double>(x.size());
+
+    // Cost of repeated multiplications, starting
+    // from the highest power available in the cache.
+    // NOTE: x**0 and x**1 are essentially free.
+    double c_rep = 0;
+    for (auto k = static_cast<unsigned>(::std::max(c_size, ::std::size_t(2))) - 1u; k < n; ++k) {
+        c_rep += k == 1u ? t * (t + 1) / 2 : t * est(k);
+    }
+
+    // Cost of binary exponentiation.
+    double c_bin = 0;
+    auto cur = 1u;
+    for (auto i = ::std::bit_width(n) - 1; i > 0; --i) {
+        const auto s = est(cur);
+        c_bin += s * (s + 1) / 2;
+        cur *= 2u;
+
+        if (n & (1u << (i - 1))) {
+            c_bin += t * est(cur);
+            ++cur;
+        }
+    }
+
+    if (c_rep <= c_bin) {
+        return use_cache ? poly_pow_algorithm::cache : poly_pow_algorithm::repeated;
+    }
+
+    return poly_pow_algorithm::binary;
 }
 
-namespace detail
+// Exponentiation of the multi-term polynomial x to the natural power n,
+// truncated according to args. See poly_pow_select_algorithm() for
+// the meaning of use_cache.
+template <typename T, typename... Args>
+inline T poly_pow_impl(const T &x, unsigned n, bool use_cache, const Args &...args)
 {
+    static_assert(detail::poly_pow_algo<T>);
+
+    switch (detail::poly_pow_select_algorithm(x, n, use_cache, args...)) {
+        case poly_pow_algorithm::cache:
+            return customisation::internal::series_pow_from_cache(x, n);
+        case poly_pow_algorithm::miller:
+            if constexpr (detail::poly_pow_miller_algo<T, Args...>) {
+                return detail::poly_pow_miller(x, n, args...);
+            } else {
+                // LCOV_EXCL_START
+                assert(false);
+                return T{};
+                // LCOV_EXCL_STOP
+            }
+        case poly_pow_algorithm::repeated:
+            return detail::poly_pow_repeated(x, n, args...);
+        default:
+            return detail::poly_pow_binary(x, n, args...);
+    }
+}
 
 // Implementation of the specialised pow() implementation
-// for polynomials.
-template <typename T, typename U>
-inline auto pow_poly_impl(T &&x, U &&y)
+// for polynomials. The optional args are the truncation
+// limits that will be used if the exponentiation is performed
+// via poly_pow_impl() (they must match the truncation limits encoded
+// in the type of x, if any).
+template <typename T, typename U, typename... Args>
+inline auto pow_poly_impl(T &&x, U &&y, const Args &...args)
 {
     using ret_t = customisation::internal::series_default_pow_ret_t<T &&, U &&>;
 
@@ -2157,6 +5315,18 @@ inline auto pow_poly_impl(T &&x, U &&y)
     using rU = remove_cvref_t<U>;
     using key_t = series_key_t<rT>;
 
+    if constexpr (::std::conjunction_v<::std::bool_constant<detail::poly_pow_algo<rT>>, ::std::is_same<rT, ret_t>,
+                                       is_safely_convertible<const rU &, unsigned &>>) {
+        // For multi-term polynomials and natural exponents
+        // greater than 1, use poly_pow_impl().
+        if (x.size() > 1u) {
+            unsigned un;
+            if (::obake::safe_convert(un, ::std::as_const(y)) && un > 1u) {
+                return detail::poly_pow_impl(::std::as_const(x), un, true, args...);
+            }
+        }
+    }
+
     if constexpr (is_exponentiable_monomial_v<const key_t &, const rU &>) {
         if (x.size() == 1u) {
             // The polynomial has a single term, we can proceed
@@ -2235,15 +5405,371 @@ constexpr auto poly_subs_algorithm_impl()
             // The candidate return type: rvalue subs_prod_t * const lvalue ref rT.
             using ret_t = detected_t<::obake::detail::mul_t, subs_prod_t, const rT &>;
 
-            // ret_t must be addable in place with an rvalue, and the original coefficient
-            // type must be constructible from int.
+            // ret_t must be addable in place with an rvalue, and the original coefficient
+            // type must be constructible from int.
+            if constexpr (::std::conjunction_v<
+                              // NOTE: verify the detection of subs_prod_t, as it is used
+                              // in ret_t.
+                              is_detected<::obake::detail::mul_t, key_subs_t, cf_subs_t>,
+                              is_in_place_addable<::std::add_lvalue_reference_t<ret_t>, ret_t>,
+                              ::std::is_constructible<cf_t, int>>) {
+                return ::std::make_pair(1, ::obake::detail::type_c<ret_t>{});
+            } else {
+                return failure;
+            }
+        } else {
+            return failure;
+        }
+    }
+}
+
+template <typename T, typename U>
+inline constexpr auto poly_subs_algorithm = detail::poly_subs_algorithm_impl<T, U>();
+
+template <typename T, typename U>
+inline constexpr int poly_subs_algo = poly_subs_algorithm<T, U>.first;
+
+template <typename T, typename U>
+using poly_subs_ret_t = typename decltype(poly_subs_algorithm<T, U>.second)::type;
+
+// Implementation of the polynomial subs algorithm.
+template <typename T, typename U>
+inline auto poly_subs_impl(T &&x_, const symbol_map<U> &sm)
+{
+    // Sanity check.
+    static_assert(poly_subs_algo<T &&, U> == 1);
+
+    // Need only const access to x.
+    const auto &x = ::std::as_const(x_);
+
+    // Cache a reference to the symbol set.
+    const auto &ss = x.get_symbol_set();
+
+    // Compute the intersection between sm and ss.
+    const auto si = ::obake::detail::sm_intersect_idx(sm, ss);
+
+    // Init a temp poly that we will use in the loop below.
+    remove_cvref_t<T> tmp_poly;
+    tmp_poly.set_symbol_set_fw(x.get_symbol_set_fw());
+    tmp_poly.tag() = x.tag();
+
+    // The return value (this will default-construct
+    // an empty polynomial).
+    poly_subs_ret_t<T &&, U> retval;
+
+    // NOTE: parallelisation opportunities here
+    // for segmented tables.
+    for (const auto &t : x) {
+        const auto &k = t.first;
+        const auto &c = t.second;
+
+        // Do the monomial substitution.
+        auto k_sub(::obake::monomial_subs(k, si, ss));
+
+        // Clear up tmp_poly, add a term with unitary
+        // coefficient containing the monomial result of the
+        // substitution above.
+        tmp_poly.clear_terms();
+        tmp_poly.add_term(::std::move(k_sub.second), 1);
+
+        // Compute the product of the substitutions and accumulate
+        // it into the return value.
+        // NOTE: if the type of retval coincides with the type
+        // of the original poly, we could probably optimise this
+        // to do term insertions rather than going through with
+        // the multiplications. E.g., substitution with integral
+        // values in a polynomial with integral coefficients.
+        // NOTE: another optimisation is possible if
+        // the type of subs(c, sm) is the coefficient type of
+        // tmp_poly. In that case we can avoid one multiplication
+        // and call tmp_poly.add_term() above directly with
+        // subs(c, sm) as a coefficient instead of 1.
+        // NOTE: if we implement the above suggestions, we will
+        // have to think about the implication wrt power series
+        // and truncation.
+        retval += ::std::move(k_sub.first) * ::obake::subs(c, sm) * ::std::as_const(tmp_poly);
+    }
+
+    return retval;
+}
+
+} // namespace detail
+
+// Polynomial subs.
+template <typename T, typename U>
+requires Polynomial<remove_cvref_t<T>> &&(
+    detail::poly_subs_algo<T &&, U> != 0) inline detail::poly_subs_ret_t<T &&, U> subs(T &&x, const symbol_map<U> &sm)
+{
+    return detail::poly_subs_impl(::std::forward<T>(x), sm);
+}
+
+namespace detail
+{
+
+// Meta-programming for the selection of the
+// polynomial evaluation algorithm. The return values are:
+// - 0: evaluation is not possible,
+// - 1: evaluation via the default series implementation,
+// - 2: evaluation via precomputed tables of the powers
+//      of the symbols' values.
+// The power tables require the key to be unpackable into
+// an array of integral exponents, and the type of the key evaluation
+// to be constructible from the exponentiation of U and from int,
+// and multipliable in-place by a const lvalue reference.
+template <typename T, typename U>
+constexpr int poly_evaluate_algorithm_impl()
+{
+    using rT = remove_cvref_t<T>;
+    using ev_impl = customisation::internal::series_default_evaluate_impl;
+
+    if constexpr (!Polynomial<rT>) {
+        return 0;
+    } else if constexpr (ev_impl::algo<T, U> == 0) {
+        return 0;
+    } else {
+        using key_t = series_key_t<rT>;
+        using expo_t = detected_t<poly_mul_kbox_expo_t, key_t>;
+
+        if constexpr (::std::conjunction_v<is_integral<expo_t>,
+                                           is_exponentiable<::std::add_lvalue_reference_t<const U>,
+                                                            ::std::add_lvalue_reference_t<const expo_t>>>) {
+            using key_eval_t = ::obake::detail::key_evaluate_t<const key_t &, U>;
+            using pow_ret_t = ::obake::detail::pow_t<const U &, const expo_t &>;
+
+            return ::std::conjunction_v<is_unpackable_monomial<expo_t *, const key_t &>,
+                                        ::std::is_constructible<key_eval_t, pow_ret_t>,
+                                        ::std::is_constructible<key_eval_t, int>,
+                                        is_in_place_multipliable<key_eval_t &, const key_eval_t &>,
+                                        is_semi_regular<key_eval_t>>
+                       ? 2
+                       : 1;
+        } else {
+            return 1;
+        }
+    }
+}
+
+template <typename T, typename U>
+inline constexpr int poly_evaluate_algo = detail::poly_evaluate_algorithm_impl<T, U>();
+
+// Implementation of polynomial evaluation.
+//
+// The powers of the values of the symbols are tabulated
+// once, for all the exponents between the minimum and the maximum
+// exponent of each symbol, so that the evaluation of each monomial
+// requires only table lookups and multiplications. The tables of a
+// segmented polynomial are evaluated in parallel.
+// If the exponents are too sparse (i.e., the power tables would
+// contain more elements than the polynomial has terms), the default
+// series evaluation will be used instead.
+template <typename T, typename U>
+inline auto poly_evaluate_impl(T &&x_, const symbol_map<U> &sm)
+{
+    using ev_impl = customisation::internal::series_default_evaluate_impl;
+
+    // Sanity check.
+    static_assert(poly_evaluate_algo<T &&, U> != 0);
+
+    if constexpr (poly_evaluate_algo<T &&, U> == 1) {
+        return ev_impl{}(::std::forward<T>(x_), sm);
+    } else {
+        using rT = remove_cvref_t<T>;
+        using key_t = series_key_t<rT>;
+        using expo_t = typename key_t::value_type;
+        using ret_t = ev_impl::ret_t<T &&, U>;
+        using key_eval_t = ::obake::detail::key_evaluate_t<const key_t &, U>;
+        using cf_eval_t = ::obake::detail::evaluate_t<const series_cf_t<rT> &, U>;
+        using vec_t = ::std::vector<expo_t>;
+
+        // Need only const access to x.
+        const auto &x = ::std::as_const(x_);
+
+        // Cache a reference to the symbol set.
+        const auto &ss = x.get_symbol_set();
+
+        // Compute the intersection between sm and ss.
+        const auto si = ::obake::detail::sm_intersect_idx(sm, ss);
+
+        if (si.size() != ss.size() || x.empty()) {
+            // Either elements of ss are missing from sm (in which
+            // case the default implementation will throw), or x is empty.
+            return ev_impl{}(::std::forward<T>(x_), sm);
+        }
+
+        // Cache the number of variables and the tables.
+        const auto n_vars = ss.size();
+        const auto &s_table = x._get_s_table();
+
+        // Determine the minimum/maximum exponents of each variable,
+        // first table by table, then over the whole polynomial.
+        ::std::vector<::std::pair<vec_t, vec_t>> t_lohi;
+        t_lohi.resize(::obake::safe_cast<decltype(t_lohi.size())>(s_table.size()));
+        ::tbb::parallel_for(
+            ::tbb::blocked_range<decltype(s_table.size())>(0, s_table.size()),
+            [&t_lohi, &s_table, &ss, n_vars](const auto &range) {
+                vec_t tmp;
+                tmp.resize(::obake::safe_cast<decltype(tmp.size())>(n_vars));
+
+                for (auto i = range.begin(); i != range.end(); ++i) {
+                    auto &lo = t_lohi[i].first;
+                    auto &hi = t_lohi[i].second;
+
+                    for (const auto &t : s_table[i]) {
+                        ::obake::monomial_unpack(tmp.data(), t.first, ss);
+
+                        if (lo.empty()) {
+                            lo = tmp;
+                            hi = tmp;
+                        } else {
+                            for (decltype(tmp.size()) j = 0; j < tmp.size(); ++j) {
+                                lo[j] = ::std::min(lo[j], tmp[j]);
+                                hi[j] = ::std::max(hi[j], tmp[j]);
+                            }
+                        }
+                    }
+                }
+            });
+
+        vec_t lo, hi;
+        for (const auto &p : t_lohi) {
+            if (p.first.empty()) {
+                continue;
+            }
+
+            if (lo.empty()) {
+                lo = p.first;
+                hi = p.second;
+            } else {
+                for (decltype(lo.size()) j = 0; j < lo.size(); ++j) {
+                    lo[j] = ::std::min(lo[j], p.first[j]);
+                    hi[j] = ::std::max(hi[j], p.second[j]);
+                }
+            }
+        }
+        assert(lo.size() == n_vars || (n_vars == 0u && lo.empty()));
+
+        // Compute the offsets of the power tables of
+        // each variable in the flat vector of powers.
+        ::std::vector<::std::size_t> offsets;
+        offsets.resize(::obake::safe_cast<decltype(offsets.size())>(n_vars + 1u));
+        ::mppp::integer<1> tot_size(0);
+        for (decltype(lo.size()) j = 0; j < lo.size(); ++j) {
+            tot_size += ::mppp::integer<1>(hi[j]) - lo[j] + 1;
+
+            if (tot_size > x.size()) {
+                // The power tables would be too large,
+                // use the default implementation.
+                return ev_impl{}(::std::forward<T>(x_), sm);
+            }
+
+            // NOTE: tot_size is not greater than x.size(),
+            // thus it fits in std::size_t.
+            offsets[j + 1u] = static_cast<::std::size_t>(tot_size);
+        }
+
+        // Build the power tables, one variable at a time.
+        // NOTE: the powers are computed exactly as in key_evaluate(),
+        // so that the results are identical to the default implementation
+        // (modulo the order of the accumulation).
+        ::std::vector<key_eval_t> pows;
+        pows.resize(::obake::safe_cast<decltype(pows.size())>(offsets.back()));
+        ::tbb::parallel_for(::tbb::blocked_range<decltype(lo.size())>(0, lo.size()),
+                            [&pows, &offsets, &lo, &si](const auto &range) {
+                                for (auto j = range.begin(); j != range.end(); ++j) {
+                                    // NOTE: si contains exactly the [0, n_vars) indices.
+                                    const auto &v = (si.cbegin() + static_cast<decltype(si.size())>(j))->second;
+
+                                    for (auto k = offsets[j]; k != offsets[j + 1u]; ++k) {
+                                        // NOTE: the exponent is in the [lo[j], hi[j]] range,
+                                        // thus the conversion back to expo_t is safe.
+                                        const auto e
+                                            = static_cast<expo_t>(::mppp::integer<1>(lo[j]) + (k - offsets[j]));
+                                        pows[k] = key_eval_t(::obake::pow(v, e));
+                                    }
+                                }
+                            });
+
+        return ev_impl::reduce<ret_t>(x, [&pows, &offsets, &lo, &ss, &sm, n_vars](ret_t &ret, const auto &tab) {
+            vec_t tmp;
+            tmp.resize(::obake::safe_cast<decltype(tmp.size())>(n_vars));
+
+            for (const auto &t : tab) {
+                ::obake::monomial_unpack(tmp.data(), t.first, ss);
+
+                // Evaluate the monomial via the power tables.
+                key_eval_t k_ev(1);
+                for (decltype(tmp.size()) j = 0; j < tmp.size(); ++j) {
+                    // NOTE: the difference tmp[j] - lo[j] is computed in unsigned
+                    // arithmetic, so that it cannot overflow.
+                    k_ev *= ::std::as_const(
+                        pows[offsets[j] + (static_cast<::std::size_t>(tmp[j]) - static_cast<::std::size_t>(lo[j]))]);
+                }
+
+                // Accumulate, using the fused multiply-accumulate if available.
+                if constexpr (is_mult_addable_v<ret_t &, key_eval_t, cf_eval_t>) {
+                    ::obake::fma3(ret, ::std::move(k_ev), ::obake::evaluate(t.second, sm));
+                } else {
+                    ret += ::std::move(k_ev) * ::obake::evaluate(t.second, sm);
+                }
+            }
+        });
+    }
+}
+
+} // namespace detail
+
+// Polynomial evaluation.
+template <typename T, typename U>
+requires Polynomial<remove_cvref_t<T>> &&(detail::poly_evaluate_algo<T &&, U> != 0) inline customisation::internal::
+    series_default_evaluate_impl::ret_t<T &&, U> evaluate(T &&x, const symbol_map<U> &sm)
+{
+    return detail::poly_evaluate_impl(::std::forward<T>(x), sm);
+}
+
+namespace detail
+{
+
+// Meta-programming for the batch evaluation of polynomials.
+// The requirements are:
+// - the coefficient type must have a rank of zero,
+// - the key must be unpackable into an array of integral exponents,
+// - U must be exponentiable to the exponent type (via const lvalue refs),
+//   and the result of the exponentiation must be semi-regular,
+//   constructible from int and multipliable in-place by
+//   const lvalue references and rvalues,
+// - the product of the result of the exponentiation by the coefficient
+//   (via const lvalue refs) must be semi-regular, constructible from int and
+//   addable in-place with an rvalue.
+template <typename T, typename U>
+constexpr auto poly_evaluate_batch_algorithm_impl()
+{
+    [[maybe_unused]] constexpr auto failure = ::std::make_pair(false, ::obake::detail::type_c<void>{});
+
+    using rT = remove_cvref_t<T>;
+
+    if constexpr (!Polynomial<rT>) {
+        return failure;
+    } else {
+        using key_t = series_key_t<rT>;
+        using cf_t = series_cf_t<rT>;
+        using expo_t = detected_t<poly_mul_kbox_expo_t, key_t>;
+
+        if constexpr (::std::conjunction_v<::std::bool_constant<series_rank<cf_t> == 0u>, is_integral<expo_t>,
+                                           is_semi_regular<U>,
+                                           is_exponentiable<::std::add_lvalue_reference_t<const U>,
+                                                            ::std::add_lvalue_reference_t<const expo_t>>>) {
+            using pow_ret_t = ::obake::detail::pow_t<const U &, const expo_t &>;
+            using ret_t = detected_t<::obake::detail::mul_t, const pow_ret_t &, const cf_t &>;
+
             if constexpr (::std::conjunction_v<
-                              // NOTE: verify the detection of subs_prod_t, as it is used
-                              // in ret_t.
-                              is_detected<::obake::detail::mul_t, key_subs_t, cf_subs_t>,
-                              is_in_place_addable<::std::add_lvalue_reference_t<ret_t>, ret_t>,
-                              ::std::is_constructible<cf_t, int>>) {
-                return ::std::make_pair(1, ::obake::detail::type_c<ret_t>{});
+                              is_unpackable_monomial<expo_t *, const key_t &>, is_semi_regular<pow_ret_t>,
+                              ::std::is_constructible<pow_ret_t, int>,
+                              is_in_place_multipliable<::std::add_lvalue_reference_t<pow_ret_t>, const pow_ret_t &>,
+                              is_in_place_multipliable<::std::add_lvalue_reference_t<pow_ret_t>, pow_ret_t>,
+                              // NOTE: these will also verify that ret_t is detected.
+                              is_semi_regular<ret_t>, ::std::is_constructible<ret_t, int>,
+                              is_in_place_addable<::std::add_lvalue_reference_t<ret_t>, ret_t>>) {
+                return ::std::make_pair(true, ::obake::detail::type_c<ret_t>{});
             } else {
                 return failure;
             }
@@ -2254,83 +5780,272 @@ constexpr auto poly_subs_algorithm_impl()
 }
 
 template <typename T, typename U>
-inline constexpr auto poly_subs_algorithm = detail::poly_subs_algorithm_impl<T, U>();
+inline constexpr auto poly_evaluate_batch_algorithm = detail::poly_evaluate_batch_algorithm_impl<T, U>();
 
 template <typename T, typename U>
-inline constexpr int poly_subs_algo = poly_subs_algorithm<T, U>.first;
+inline constexpr bool poly_evaluate_batch_algo = poly_evaluate_batch_algorithm<T, U>.first;
 
 template <typename T, typename U>
-using poly_subs_ret_t = typename decltype(poly_subs_algorithm<T, U>.second)::type;
+using poly_evaluate_batch_ret_t = typename decltype(poly_evaluate_batch_algorithm<T, U>.second)::type;
 
-// Implementation of the polynomial subs algorithm.
+// The number of points evaluated together
+// in the batch evaluation.
+inline constexpr ::std::size_t poly_evaluate_batch_block_size = 256;
+
+// The maximum size in bytes of the power tables
+// of a block in the batch evaluation. The tables
+// of several blocks are alive at the same time
+// (one per worker thread), hence the limit is
+// on a per-block basis.
+inline constexpr ::std::size_t poly_evaluate_batch_max_table_bytes = ::std::size_t(1) << 20;
+
+// The number of terms below which the accumulation
+// of the terms in a block of the batch evaluation
+// is not split further.
+inline constexpr ::std::size_t poly_evaluate_batch_term_grainsize = 64;
+
+// Implementation of the batch evaluation.
+//
+// The monomials are unpacked once, and the evaluation points are then
+// split in blocks which are processed in parallel. For each block, the
+// powers of the values of the symbols are tabulated (like in the
+// scalar evaluation), and the terms are accumulated (in parallel)
+// into per-block arrays. In the inner loops, the values of each term
+// are computed for all the points in the block via unit-stride loops
+// over contiguous arrays, which can be vectorised by the compiler
+// for the C++ arithmetic types. If the exponents are too sparse, or if
+// the power tables of a block would exceed poly_evaluate_batch_max_table_bytes,
+// the powers are computed on the fly instead of being tabulated.
+// The accumulation of the terms is split deterministically (i.e., independently
+// of the scheduling), so that the results are reproducible
+// also for floating-point types.
 template <typename T, typename U>
-inline auto poly_subs_impl(T &&x_, const symbol_map<U> &sm)
+inline auto poly_evaluate_batch_impl(const T &x, const symbol_map<::std::vector<U>> &sm)
 {
-    // Sanity check.
-    static_assert(poly_subs_algo<T &&, U> == 1);
+    using key_t = series_key_t<T>;
+    using cf_t = series_cf_t<T>;
+    using expo_t = typename key_t::value_type;
+    using pow_ret_t = ::obake::detail::pow_t<const U &, const expo_t &>;
+    using ret_t = poly_evaluate_batch_ret_t<T, U>;
+    using vec_t = ::std::vector<expo_t>;
+
+    // Cache the symbol set and the number of variables.
+    const auto &ss = x.get_symbol_set();
+    const auto n_vars = ss.size();
+
+    // Fetch pointers to the arrays of values of the
+    // symbols in ss, checking at the same time
+    // that the arrays all have the same size.
+    ::std::vector<const U *> vals;
+    vals.reserve(::obake::safe_cast<decltype(vals.size())>(n_vars));
+    const auto n_points = sm.empty() ? ::std::size_t(0)
+                                     : ::obake::safe_cast<::std::size_t>(sm.begin()->second.size());
+    for (const auto &p : sm) {
+        if (obake_unlikely(p.second.size() != n_points)) {
+            obake_throw(::std::invalid_argument,
+                        "Cannot evaluate a polynomial in batch mode: the array of values for the symbol '" + p.first
+                            + "' has a size of " + ::obake::detail::to_string(p.second.size())
+                            + ", but the array of values for the symbol '" + sm.begin()->first + "' has a size of "
+                            + ::obake::detail::to_string(n_points));
+        }
+    }
+    for (const auto &s : ss) {
+        const auto it = sm.find(s);
 
-    // Need only const access to x.
-    const auto &x = ::std::as_const(x_);
+        if (obake_unlikely(it == sm.end())) {
+            obake_throw(::std::invalid_argument, "Cannot evaluate a polynomial in batch mode: the symbol '" + s
+                                                     + "' is missing from the evaluation map");
+        }
 
-    // Cache a reference to the symbol set.
-    const auto &ss = x.get_symbol_set();
+        vals.push_back(it->second.data());
+    }
 
-    // Compute the intersection between sm and ss.
-    const auto si = ::obake::detail::sm_intersect_idx(sm, ss);
+    // Init the return value.
+    ::std::vector<ret_t> retval(::obake::safe_cast<typename ::std::vector<ret_t>::size_type>(n_points), ret_t(0));
 
-    // Init a temp poly that we will use in the loop below.
-    remove_cvref_t<T> tmp_poly;
-    tmp_poly.set_symbol_set_fw(x.get_symbol_set_fw());
-    tmp_poly.tag() = x.tag();
+    if (x.empty() || n_points == 0u) {
+        return retval;
+    }
 
-    // The return value (this will default-construct
-    // an empty polynomial).
-    poly_subs_ret_t<T &&, U> retval;
+    // Unpack the monomials into a flat vector of exponents,
+    // and store pointers to the coefficients. The tables
+    // are processed in parallel.
+    const auto n_terms = ::obake::safe_cast<::std::size_t>(x.size());
+    const auto &s_table = x._get_s_table();
+    ::std::vector<::std::size_t> t_offsets;
+    t_offsets.resize(::obake::safe_cast<decltype(t_offsets.size())>(s_table.size() + 1u));
+    for (decltype(s_table.size()) i = 0; i < s_table.size(); ++i) {
+        t_offsets[i + 1u] = t_offsets[i] + static_cast<::std::size_t>(s_table[i].size());
+    }
 
-    // NOTE: parallelisation opportunities here
-    // for segmented tables.
-    for (const auto &t : x) {
-        const auto &k = t.first;
-        const auto &c = t.second;
+    vec_t expos;
+    expos.resize(::obake::safe_cast<decltype(expos.size())>(::mppp::integer<1>(n_terms) * n_vars));
+    ::std::vector<const cf_t *> cfs;
+    cfs.resize(::obake::safe_cast<decltype(cfs.size())>(n_terms));
+    ::tbb::parallel_for(::tbb::blocked_range<decltype(s_table.size())>(0, s_table.size()),
+                        [&s_table, &t_offsets, &expos, &cfs, &ss, n_vars](const auto &range) {
+                            for (auto i = range.begin(); i != range.end(); ++i) {
+                                auto idx = t_offsets[i];
+
+                                for (const auto &t : s_table[i]) {
+                                    ::obake::monomial_unpack(expos.data() + idx * n_vars, t.first, ss);
+                                    cfs[idx] = &t.second;
+
+                                    ++idx;
+                                }
+                            }
+                        });
+
+    // Determine the minimum/maximum exponents of each variable.
+    vec_t lo(expos.begin(), expos.begin() + static_cast<typename vec_t::difference_type>(n_vars)), hi(lo);
+    for (::std::size_t i = 1; i < n_terms; ++i) {
+        for (decltype(lo.size()) j = 0; j < n_vars; ++j) {
+            lo[j] = ::std::min(lo[j], expos[i * n_vars + j]);
+            hi[j] = ::std::max(hi[j], expos[i * n_vars + j]);
+        }
+    }
 
-        // Do the monomial substitution.
-        auto k_sub(::obake::monomial_subs(k, si, ss));
+    // The block size.
+    const auto bs = poly_evaluate_batch_block_size;
+
+    // Establish if the powers can be tabulated (see the
+    // scalar evaluation), and compute the offsets of the power
+    // tables of each variable. In addition to the scalar
+    // evaluation criterion, the tables of a block (which contain
+    // the powers for all the points of the block) must
+    // not exceed the memory budget.
+    const auto max_table_size
+        = poly_evaluate_batch_max_table_bytes / (sizeof(pow_ret_t) * ::std::min(bs, n_points));
+    ::std::vector<::std::size_t> p_offsets;
+    p_offsets.resize(::obake::safe_cast<decltype(p_offsets.size())>(n_vars + 1u));
+    ::mppp::integer<1> tot_size(0);
+    bool use_tables = true;
+    for (decltype(lo.size()) j = 0; j < n_vars; ++j) {
+        tot_size += ::mppp::integer<1>(hi[j]) - lo[j] + 1;
+
+        if (tot_size > n_terms || tot_size > max_table_size) {
+            use_tables = false;
+            break;
+        }
 
-        // Clear up tmp_poly, add a term with unitary
-        // coefficient containing the monomial result of the
-        // substitution above.
-        tmp_poly.clear_terms();
-        tmp_poly.add_term(::std::move(k_sub.second), 1);
+        p_offsets[j + 1u] = static_cast<::std::size_t>(tot_size);
+    }
 
-        // Compute the product of the substitutions and accumulate
-        // it into the return value.
-        // NOTE: if the type of retval coincides with the type
-        // of the original poly, we could probably optimise this
-        // to do term insertions rather than going through with
-        // the multiplications. E.g., substitution with integral
-        // values in a polynomial with integral coefficients.
-        // NOTE: another optimisation is possible if
-        // the type of subs(c, sm) is the coefficient type of
-        // tmp_poly. In that case we can avoid one multiplication
-        // and call tmp_poly.add_term() above directly with
-        // subs(c, sm) as a coefficient instead of 1.
-        // NOTE: if we implement the above suggestions, we will
-        // have to think about the implication wrt power series
-        // and truncation.
-        retval += ::std::move(k_sub.first) * ::obake::subs(c, sm) * ::std::as_const(tmp_poly);
+    // If the powers are tabulated, replace the exponents
+    // with the indices in the power tables.
+    ::std::vector<::std::size_t> p_idx;
+    if (use_tables) {
+        p_idx.resize(::obake::safe_cast<decltype(p_idx.size())>(expos.size()));
+        for (::std::size_t i = 0; i < n_terms; ++i) {
+            for (decltype(lo.size()) j = 0; j < n_vars; ++j) {
+                // NOTE: compute the difference in unsigned
+                // arithmetic, so that it cannot overflow.
+                p_idx[i * n_vars + j] = p_offsets[j]
+                                        + (static_cast<::std::size_t>(expos[i * n_vars + j])
+                                           - static_cast<::std::size_t>(lo[j]));
+            }
+        }
     }
 
+    // Evaluate block by block.
+    const auto n_blocks = n_points / bs + static_cast<::std::size_t>(n_points % bs != 0u);
+    ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, n_blocks), [&](const auto &b_range) {
+        for (auto b = b_range.begin(); b != b_range.end(); ++b) {
+            // The range of points in the block.
+            const auto p_begin = b * bs;
+            const auto p_size = ::std::min(bs, n_points - p_begin);
+
+            // Tabulate the powers, if possible: the power
+            // of index k for the point p is stored at
+            // index k * p_size + p.
+            ::std::vector<pow_ret_t> pows;
+            if (use_tables) {
+                pows.resize(::obake::safe_cast<decltype(pows.size())>(::mppp::integer<1>(p_offsets.back()) * p_size));
+
+                for (decltype(lo.size()) j = 0; j < n_vars; ++j) {
+                    const auto v = vals[j] + p_begin;
+
+                    for (auto k = p_offsets[j]; k != p_offsets[j + 1u]; ++k) {
+                        // NOTE: the exponent is in the [lo[j], hi[j]] range,
+                        // thus the conversion back to expo_t is safe.
+                        const auto e = static_cast<expo_t>(::mppp::integer<1>(lo[j]) + (k - p_offsets[j]));
+                        const auto out = pows.data() + k * p_size;
+
+                        for (::std::size_t p = 0; p < p_size; ++p) {
+                            out[p] = ::obake::pow(v[p], e);
+                        }
+                    }
+                }
+            }
+
+            // Accumulate the contributions of the terms, in parallel.
+            // NOTE: the deterministic reduction splits the range
+            // of terms and combines the partial results always in the
+            // same way, independently of the scheduling.
+            auto block_ret = ::tbb::parallel_deterministic_reduce(
+                ::tbb::blocked_range<::std::size_t>(0, n_terms, poly_evaluate_batch_term_grainsize),
+                ::std::vector<ret_t>(p_size, ret_t(0)),
+                [&](const auto &t_range, ::std::vector<ret_t> cur) {
+                    ::std::vector<pow_ret_t> tmp;
+                    tmp.resize(p_size);
+
+                    for (auto i = t_range.begin(); i != t_range.end(); ++i) {
+                        ::std::fill(tmp.begin(), tmp.end(), pow_ret_t(1));
+
+                        for (decltype(lo.size()) j = 0; j < n_vars; ++j) {
+                            if (use_tables) {
+                                const auto pw = pows.data() + p_idx[i * n_vars + j] * p_size;
+
+                                for (::std::size_t p = 0; p < p_size; ++p) {
+                                    tmp[p] *= ::std::as_const(pw[p]);
+                                }
+                            } else {
+                                const auto &e = expos[i * n_vars + j];
+                                const auto v = vals[j] + p_begin;
+
+                                for (::std::size_t p = 0; p < p_size; ++p) {
+                                    tmp[p] *= ::obake::pow(v[p], e);
+                                }
+                            }
+                        }
+
+                        const auto &c = *cfs[i];
+                        for (::std::size_t p = 0; p < p_size; ++p) {
+                            cur[p] += ::std::as_const(tmp[p]) * c;
+                        }
+                    }
+
+                    return cur;
+                },
+                [p_size](::std::vector<ret_t> a, ::std::vector<ret_t> b) {
+                    for (::std::size_t p = 0; p < p_size; ++p) {
+                        a[p] += ::std::move(b[p]);
+                    }
+
+                    return a;
+                });
+
+            ::std::move(block_ret.begin(), block_ret.end(),
+                        retval.begin() + static_cast<typename ::std::vector<ret_t>::difference_type>(p_begin));
+        }
+    });
+
     return retval;
 }
 
 } // namespace detail
 
-// Polynomial subs.
+// Batch evaluation of a polynomial.
+//
+// The values of each symbol are passed in sm as contiguous arrays
+// (structure-of-arrays layout), all of the same size n. The return
+// value is an array of size n containing the evaluations of x at
+// each point.
 template <typename T, typename U>
-requires Polynomial<remove_cvref_t<T>> &&(
-    detail::poly_subs_algo<T &&, U> != 0) inline detail::poly_subs_ret_t<T &&, U> subs(T &&x, const symbol_map<U> &sm)
+requires(detail::poly_evaluate_batch_algo<T, U>) inline ::std::vector<detail::poly_evaluate_batch_ret_t<T, U>> evaluate_batch(
+    const T &x, const symbol_map<::std::vector<U>> &sm)
 {
-    return detail::poly_subs_impl(::std::forward<T>(x), sm);
+    return detail::poly_evaluate_batch_impl(x, sm);
 }
 
 namespace detail
@@ -2465,6 +6180,467 @@ inline void truncate_p_degree(T &x, U &&y_, const symbol_set &s)
 namespace detail
 {
 
+// Metaprogramming to establish if truncated_pow() is available: it must be possible
+// to exponentiate T via poly_pow_impl(), to compute truncated products and to truncate T
+// according to the limit V, and U must be safely convertible to unsigned.
+template <typename T, typename U, typename V, bool Total>
+constexpr bool poly_truncated_pow_algorithm_impl()
+{
+    if constexpr (!detail::poly_pow_algo<T> || !is_safely_convertible_v<const U &, unsigned &>) {
+        return false;
+    } else if constexpr (Total) {
+        return poly_mul_truncated_degree_algo<T, T, V> != 0 && poly_truncate_degree_algo<T &, const V &> != 0;
+    } else {
+        return poly_mul_truncated_p_degree_algo<T, T, V> != 0 && poly_truncate_p_degree_algo<T &, const V &> != 0;
+    }
+}
+
+template <typename T, typename U, typename V>
+inline constexpr bool poly_truncated_pow_algo = detail::poly_truncated_pow_algorithm_impl<T, U, V, true>();
+
+template <typename T, typename U, typename V>
+inline constexpr bool poly_truncated_p_pow_algo = detail::poly_truncated_pow_algorithm_impl<T, U, V, false>();
+
+// Implementation of truncated_pow().
+template <typename T, typename U, typename... Args>
+inline T poly_truncated_pow_impl(const T &x, const U &n, const Args &...args)
+{
+    unsigned un;
+    if (obake_unlikely(!::obake::safe_convert(un, n))) {
+        obake_throw(::std::invalid_argument, "Invalid exponent for truncated polynomial exponentiation: the exponent "
+                                             "cannot be converted into a non-negative integral value");
+    }
+
+    if (un > 1u && x.size() > 1u) {
+        // NOTE: the pow cache cannot be used, as the truncation
+        // limits are not encoded in the type of x.
+        return detail::poly_pow_impl(x, un, false, args...);
+    }
+
+    // In the other cases, run the untruncated exponentiation
+    // (which is cheap) and truncate the result.
+    auto retval = un == 1u ? x : T(::obake::pow(x, ::std::as_const(un)));
+    if constexpr (sizeof...(Args) == 1u) {
+        polynomials::truncate_degree(retval, args...);
+    } else {
+        polynomials::truncate_p_degree(retval, args...);
+    }
+
+    return retval;
+}
+
+} // namespace detail
+
+// Truncated exponentiation.
+// NOTE: x**n is computed with the same truncation
+// semantics as repeated truncated_mul() calls.
+template <typename K, typename C, typename U, typename V>
+requires(detail::poly_truncated_pow_algo<polynomial<K, C>, U, V>) inline polynomial<K, C> truncated_pow(
+    const polynomial<K, C> &x, const U &n, const V &max_degree)
+{
+    return detail::poly_truncated_pow_impl(x, n, max_degree);
+}
+
+template <typename K, typename C, typename U, typename V>
+requires(detail::poly_truncated_p_pow_algo<polynomial<K, C>, U, V>) inline polynomial<K, C> truncated_pow(
+    const polynomial<K, C> &x, const U &n, const V &max_degree, const symbol_set &s)
+{
+    return detail::poly_truncated_pow_impl(x, n, max_degree, s);
+}
+
+namespace detail
+{
+
+// Meta-programming to establish if polynomial division is available
+// for the polynomial type T. The requirements are:
+// - the key type must be a Kronecker-packed monomial, that is, it must expose
+//   a kpackable value_type, it must be possible to fetch its packed
+//   value and to construct a key from a packed value,
+// - the key must be unpackable into an array of exponents,
+// - the coefficient type must not be a series, it must be closed under
+//   multiplication and division via const lvalue refs, and it must support
+//   in-place subtraction, in-place negation and zero testing.
+template <typename T>
+using poly_div_key_value_t = decltype(::std::declval<const T &>().get_value());
+
+template <typename T>
+constexpr bool poly_div_algorithm_impl()
+{
+    using key_t = series_key_t<T>;
+    using cf_t = series_cf_t<T>;
+    using expo_t = detected_t<poly_mul_kbox_expo_t, key_t>;
+
+    if constexpr (is_kpackable_v<expo_t> && series_rank<cf_t> == 0u) {
+        return ::std::conjunction_v<
+            ::std::is_same<detected_t<poly_div_key_value_t, key_t>, const expo_t &>,
+            ::std::is_constructible<key_t, const expo_t &>, is_unpackable_monomial<expo_t *, const key_t &>,
+            ::std::is_same<detected_t<::obake::detail::mul_t, const cf_t &, const cf_t &>, cf_t>,
+            ::std::is_same<detected_t<::obake::detail::div_t, const cf_t &, const cf_t &>, cf_t>,
+            is_in_place_subtractable<cf_t &, cf_t>, is_negatable<cf_t &>, is_zero_testable<const cf_t &>>;
+    } else {
+        return false;
+    }
+}
+
+template <typename T>
+inline constexpr bool poly_div_algo = detail::poly_div_algorithm_impl<T>();
+
+// Sparse polynomial division via the heap-based algorithm of
+// Johnson (1974), in the formulation of Monagan and Pearce (2007).
+//
+// The terms of x and y are sorted in descending order according to the Kronecker
+// codes of their monomials. Because the Kronecker encoding is linear in the exponents,
+// the codes are ordered lexicographically (with the last variable being the most
+// significant one), and the code of the product of two monomials is the sum
+// of the codes of the factors. The terms of x - q*y are then generated in descending
+// order by merging the terms of x with the products q_i*y_j (j > 0) via a max-heap
+// which contains at most one product for each term of q. Each leading term
+// divisible by the leading term of y becomes a new term of the quotient, so that
+// the quotient is streamed out term by term and the products are never stored.
+//
+// If Exact is true, the division stops as soon as a term which is not divisible
+// by the leading term of y is produced, and false is returned. This includes the terms
+// whose quotient would have exponents outside the range implied by the exponents of
+// x and y. Otherwise, the terms which are not divisible are moved to the
+// remainder r, and true is returned.
+//
+// NOTE: q and r must be empty and not segmented, the monomials of x and y
+// must be compatible with the symbol set of q and r, and y must not be empty.
+template <bool Exact, typename T>
+inline bool poly_div_impl(T &q, T &r, const T &x, const T &y)
+{
+    using key_t = series_key_t<T>;
+    using cf_t = series_cf_t<T>;
+    using expo_t = typename key_t::value_type;
+
+    assert(q.empty());
+    assert(r.empty());
+    assert(q._get_s_table().size() == 1u);
+    assert(r._get_s_table().size() == 1u);
+    assert(!y.empty());
+
+    const auto &ss = q.get_symbol_set();
+    const auto n_vars = ss.size();
+
+    // Create the vectors of (code, pointer to coefficient) pairs
+    // for the terms of x and y, sorted in descending order.
+    auto make_tvec = [](const T &p, auto &v) {
+        v.reserve(::obake::safe_cast<decltype(v.size())>(p.size()));
+        for (const auto &t : p) {
+            v.emplace_back(t.first.get_value(), &t.second);
+        }
+        ::tbb::parallel_sort(v.begin(), v.end(), [](const auto &p1, const auto &p2) { return p1.first > p2.first; });
+    };
+    ::std::vector<::std::pair<expo_t, const cf_t *>> vx, vy;
+    ::tbb::parallel_invoke([&make_tvec, &x, &vx]() { make_tvec(x, vx); },
+                           [&make_tvec, &y, &vy]() { make_tvec(y, vy); });
+
+    // Compute the minimum/maximum exponent for each variable in p.
+    auto expo_range = [&ss, n_vars](const T &p, auto &lo, auto &hi) {
+        ::std::vector<expo_t> tmp(::obake::safe_cast<typename ::std::vector<expo_t>::size_type>(n_vars));
+        lo.resize(tmp.size());
+        hi.resize(tmp.size());
+
+        bool first = true;
+        for (const auto &t : p) {
+            ::obake::monomial_unpack(tmp.data(), t.first, ss);
+
+            for (decltype(tmp.size()) k = 0; k < tmp.size(); ++k) {
+                lo[k] = first ? tmp[k] : ::std::min(lo[k], tmp[k]);
+                hi[k] = first ? tmp[k] : ::std::max(hi[k], tmp[k]);
+            }
+
+            first = false;
+        }
+    };
+    ::std::vector<expo_t> lo_x, hi_x, lo_y, hi_y;
+    ::tbb::parallel_invoke([&expo_range, &x, &lo_x, &hi_x]() { expo_range(x, lo_x, hi_x); },
+                           [&expo_range, &y, &lo_y, &hi_y]() { expo_range(y, lo_y, hi_y); });
+
+    // The leading term of y.
+    const auto lm_code = vy.front().first;
+    const auto &lc = *vy.front().second;
+    ::std::vector<expo_t> lm_expo(lo_y.size()), tmp_expo(lo_y.size());
+    ::obake::monomial_unpack(lm_expo.data(), key_t(lm_code), ss);
+
+    // Establish the ranges of the exponents of the terms of the quotient.
+    // The exponents of a term of the quotient are always non-negative. In exact
+    // mode, they must also be in the [lo_x - lo_y, hi_x - hi_y] range, otherwise the
+    // division is not exact. Exponents greater than q_max would lead to
+    // overflows in the exponents of the quotient or of the products q_i*y_j.
+    // NOTE: in exact mode, the products q_i*y_j are guaranteed to be
+    // in the range of the exponents of x.
+    ::std::vector<::mppp::integer<1>> q_lo(lo_y.size()), q_hi(lo_y.size()), q_max(lo_y.size());
+    const auto lim_max = n_vars == 0u
+                             ? ::mppp::integer<1>{}
+                             : ::mppp::integer<1>(
+                                 ::obake::detail::kpack_get_lims<expo_t>(static_cast<unsigned>(n_vars)).second);
+    for (decltype(q_lo.size()) k = 0; k < q_lo.size(); ++k) {
+        if constexpr (Exact) {
+            q_lo[k] = ::std::max(::mppp::integer<1>{}, ::mppp::integer<1>(lo_x[k]) - lo_y[k]);
+            q_hi[k] = ::mppp::integer<1>(hi_x[k]) - hi_y[k];
+            q_max[k] = lim_max;
+        } else {
+            q_max[k] = ::std::min(lim_max, lim_max - hi_y[k]);
+        }
+    }
+
+    // Check if the term with code m and coefficient c of x - q*y
+    // is divisible by the leading term of y. If it is, the coefficient
+    // of the corresponding term of the quotient will be returned.
+    ::std::vector<::mppp::integer<1>> q_expo(lo_y.size());
+    auto div_term = [&](expo_t m, const cf_t &c) {
+        ::std::optional<cf_t> retval;
+
+        ::obake::monomial_unpack(tmp_expo.data(), key_t(m), ss);
+        for (decltype(q_expo.size()) k = 0; k < q_expo.size(); ++k) {
+            q_expo[k] = ::mppp::integer<1>(tmp_expo[k]) - lm_expo[k];
+
+            if (q_expo[k].sgn() < 0) {
+                return retval;
+            }
+            if constexpr (Exact) {
+                if (q_expo[k] < q_lo[k] || q_expo[k] > q_hi[k]) {
+                    return retval;
+                }
+            }
+        }
+
+        retval.emplace(c / lc);
+        if constexpr (is_integral_v<cf_t> || ::obake::detail::is_mppp_integer_v<cf_t>) {
+            // NOTE: with integral coefficients, c must be
+            // a multiple of the leading coefficient of y.
+            if (*retval * lc != c) {
+                retval.reset();
+                return retval;
+            }
+        }
+        if (::obake::is_zero(::std::as_const(*retval))) {
+            // NOTE: this can happen, e.g., with floating-point
+            // coefficients in case of underflow.
+            retval.reset();
+            return retval;
+        }
+
+        for (decltype(q_expo.size()) k = 0; k < q_expo.size(); ++k) {
+            if (obake_unlikely(q_expo[k] > q_max[k])) {
+                obake_throw(::std::overflow_error, "An overflow in the monomial exponents was detected while "
+                                                   "attempting to divide two polynomials");
+            }
+        }
+
+        return retval;
+    };
+
+    // The terms of the quotient and of the remainder,
+    // in descending order.
+    ::std::vector<::std::pair<expo_t, cf_t>> vq, vr;
+
+    // The max-heap of the products q_i*y_j, represented
+    // as (code, i, j) tuples.
+    using idx_t = typename ::std::vector<::std::pair<expo_t, cf_t>>::size_type;
+    ::std::vector<::std::tuple<expo_t, idx_t, idx_t>> heap;
+    auto heap_cmp = [](const auto &t1, const auto &t2) { return ::std::get<0>(t1) < ::std::get<0>(t2); };
+
+    // Helper to restore the heap property after the
+    // replacement of the item at the top of the heap.
+    auto sift_down = [&heap]() {
+        const auto size = heap.size();
+        const auto item = heap.front();
+
+        decltype(heap.size()) c = 0;
+        while (true) {
+            auto child = 2u * c + 1u;
+            if (child >= size) {
+                break;
+            }
+            if (child + 1u < size && ::std::get<0>(heap[child + 1u]) > ::std::get<0>(heap[child])) {
+                ++child;
+            }
+            if (::std::get<0>(heap[child]) <= ::std::get<0>(item)) {
+                break;
+            }
+            heap[c] = heap[child];
+            c = child;
+        }
+        heap[c] = item;
+    };
+
+    decltype(vx.size()) ix = 0;
+    while (ix != vx.size() || !heap.empty()) {
+        // Determine the largest monomial of x - q*y which
+        // has not been processed yet.
+        expo_t cur;
+        if (heap.empty()) {
+            cur = vx[ix].first;
+        } else if (ix == vx.size()) {
+            cur = ::std::get<0>(heap.front());
+        } else {
+            cur = ::std::max(vx[ix].first, ::std::get<0>(heap.front()));
+        }
+
+        // Compute its coefficient.
+        ::std::optional<cf_t> acc;
+        if (ix != vx.size() && vx[ix].first == cur) {
+            acc.emplace(*vx[ix].second);
+            ++ix;
+        }
+        while (!heap.empty() && ::std::get<0>(heap.front()) == cur) {
+            const auto i = ::std::get<1>(heap.front()), j = ::std::get<2>(heap.front());
+
+            auto prod = vq[i].second * *vy[j].second;
+            if (acc) {
+                *acc -= ::std::move(prod);
+            } else {
+                ::obake::negate(prod);
+                acc.emplace(::std::move(prod));
+            }
+
+            // Replace the top item with the next product
+            // in the same row, if any, otherwise remove it.
+            if (j + 1u != vy.size()) {
+                heap.front() = ::std::make_tuple(static_cast<expo_t>(vq[i].first + vy[j + 1u].first), i, j + 1u);
+            } else {
+                heap.front() = heap.back();
+                heap.pop_back();
+            }
+            if (!heap.empty()) {
+                sift_down();
+            }
+        }
+        assert(acc);
+
+        if (::obake::is_zero(::std::as_const(*acc))) {
+            continue;
+        }
+
+        auto qc = div_term(cur, *acc);
+        if (!qc) {
+            if constexpr (Exact) {
+                return false;
+            } else {
+                vr.emplace_back(cur, ::std::move(*acc));
+                continue;
+            }
+        }
+
+        // Add the new term to the quotient, and the
+        // first of its products to the heap.
+        // NOTE: the overflow checks in div_term() ensure
+        // that all the codes below are valid.
+        const auto q_code = static_cast<expo_t>(cur - lm_code);
+        vq.emplace_back(q_code, ::std::move(*qc));
+        if (vy.size() > 1u) {
+            heap.emplace_back(static_cast<expo_t>(q_code + vy[1].first), static_cast<idx_t>(vq.size() - 1u),
+                              idx_t(1));
+            ::std::push_heap(heap.begin(), heap.end(), heap_cmp);
+        }
+    }
+
+    // Insert the terms into q and r.
+    auto insert_terms = [](T &out, auto &v) {
+        auto &tab = out._get_s_table()[0];
+        tab.reserve(::obake::safe_cast<decltype(tab.size())>(v.size()));
+
+        for (auto &p : v) {
+            // NOTE: the monomials are unique
+            // and out is not segmented.
+            ::obake::detail::series_add_term_table<true, ::obake::detail::sat_check_zero::off,
+                                                   ::obake::detail::sat_check_compat_key::off,
+                                                   ::obake::detail::sat_check_table_size::off,
+                                                   ::obake::detail::sat_assume_unique::on>(
+                out, tab, key_t(::std::as_const(p.first)), ::std::move(p.second));
+        }
+    };
+
+    try {
+        insert_terms(q, vq);
+        insert_terms(r, vr);
+        // LCOV_EXCL_START
+    } catch (...) {
+        // In case of exceptions, clear q and r before
+        // rethrowing to ensure a known sane state.
+        q.clear();
+        r.clear();
+        throw;
+        // LCOV_EXCL_STOP
+    }
+
+    return true;
+}
+
+// Helper to run poly_div_impl() after merging
+// the symbol sets of x and y.
+template <bool Exact, typename T>
+inline bool poly_div_impl_switch(T &q, T &r, const T &x, const T &y)
+{
+    if (obake_unlikely(y.empty())) {
+        obake_throw(::std::domain_error, "Cannot divide a polynomial by zero");
+    }
+
+    if (x.get_symbol_set_fw() == y.get_symbol_set_fw()) {
+        q.set_symbol_set_fw(x.get_symbol_set_fw());
+        r.set_symbol_set_fw(x.get_symbol_set_fw());
+
+        return detail::poly_div_impl<Exact>(q, r, x, y);
+    }
+
+    const auto &[merged_ss, ins_map_x, ins_map_y]
+        = ::obake::detail::merge_symbol_sets(x.get_symbol_set(), y.get_symbol_set());
+
+    // Extend x and/or y, if needed.
+    T a, b;
+    if (!ins_map_x.empty()) {
+        a.set_symbol_set(merged_ss);
+        ::obake::detail::series_sym_extender(a, x, ins_map_x);
+    }
+    if (!ins_map_y.empty()) {
+        b.set_symbol_set(merged_ss);
+        ::obake::detail::series_sym_extender(b, y, ins_map_y);
+    }
+
+    q.set_symbol_set(merged_ss);
+    r.set_symbol_set(merged_ss);
+
+    return detail::poly_div_impl<Exact>(q, r, ins_map_x.empty() ? x : a, ins_map_y.empty() ? y : b);
+}
+
+} // namespace detail
+
+// Exact polynomial division: if y divides x, the quotient
+// is returned, otherwise an empty optional is returned.
+template <typename K, typename C>
+requires(detail::poly_div_algo<polynomial<K, C>>) inline ::std::optional<polynomial<K, C>> div_exact(
+    const polynomial<K, C> &x, const polynomial<K, C> &y)
+{
+    polynomial<K, C> q, r;
+
+    if (detail::poly_div_impl_switch<true>(q, r, x, y)) {
+        return q;
+    } else {
+        return {};
+    }
+}
+
+// Polynomial division with remainder: the returned pair (q, r) is such
+// that x = q*y + r, and no term of r is divisible by the leading term of y.
+// NOTE: the leading term is determined according to the lexicographic
+// order of the exponents, with the last variable being the most significant one.
+template <typename K, typename C>
+requires(detail::poly_div_algo<polynomial<K, C>>) inline ::std::pair<polynomial<K, C>, polynomial<K, C>> divrem(
+    const polynomial<K, C> &x, const polynomial<K, C> &y)
+{
+    polynomial<K, C> q, r;
+
+    [[maybe_unused]] const auto flag = detail::poly_div_impl_switch<false>(q, r, x, y);
+    assert(flag);
+
+    return ::std::make_pair(::std::move(q), ::std::move(r));
+}
+
+namespace detail
+{
+
 // Meta-programming for the selection of the
 // diff() algorithm.
 template <typename T>
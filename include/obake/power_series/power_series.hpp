@@ -1366,17 +1366,72 @@ inline ::obake::polynomials::detail::poly_mul_ret_t<p_series<K, C0>, p_series<K,
         ::obake::get_truncation(ps0), ::obake::get_truncation(ps1));
 }
 
+// Fused multiply-accumulate: ret += x * y.
+// If ret, x and y have identical truncation settings, the (truncated)
+// product is accumulated directly into ret, if possible. Otherwise, the
+// usual multiplication + addition will be performed.
+// NOTE: if an exception is thrown, ret may be left in
+// a valid but unspecified state.
+template <typename K, typename C>
+    requires(detail::ps_mul_algo<p_series<K, C>, p_series<K, C>>() == true)
+            && polynomials::detail::poly_fma3_algo<p_series<K, C>>
+inline void fma3(p_series<K, C> &ret, const p_series<K, C> &x, const p_series<K, C> &y)
+{
+    // Fetch the (partial) degree type.
+    using deg_t [[maybe_unused]] = decltype(::obake::degree(x));
+
+    const auto done = ret.tag() == x.tag() && x.tag() == y.tag()
+                      && ::std::visit(
+                          [&ret, &x, &y](const auto &v) {
+                              using type = remove_cvref_t<decltype(v)>;
+
+                              if constexpr (::std::is_same_v<type, detail::no_truncation>) {
+                                  // Untruncated multiplication.
+                                  return polynomials::detail::poly_fma_impl(ret, x, y);
+                              } else if constexpr (::std::is_same_v<type, deg_t>) {
+                                  // Total degree truncation.
+                                  return polynomials::detail::poly_fma_impl(ret, x, y, v);
+                              } else {
+                                  // Partial degree truncation.
+                                  return polynomials::detail::poly_fma_impl(ret, x, y, v.first, v.second);
+                              }
+                          },
+                          ::obake::get_truncation(x));
+
+    if (!done) {
+        ret += x * y;
+    }
+}
+
 // Exponentiation: we re-use the poly implementation, ensuring
 // that the output is properly truncated.
 template <typename T, typename U>
     requires any_p_series<remove_cvref_t<T>> && (customisation::internal::series_default_pow_algo<T &&, U &&> != 0)
 inline customisation::internal::series_default_pow_ret_t<T &&, U &&> pow(T &&x, U &&y)
 {
+    // Fetch the (partial) degree type.
+    using deg_t [[maybe_unused]] = decltype(::obake::degree(x));
+
     // Store x's tag.
     auto orig_tag = x.tag();
 
-    // Perform the operation.
-    auto ret = polynomials::detail::pow_poly_impl(::std::forward<T>(x), ::std::forward<U>(y));
+    // Perform the operation, passing along the truncation limits.
+    // NOTE: take a copy of the truncation limits, as x
+    // might be moved-from in pow_poly_impl().
+    auto ret = ::std::visit(
+        [&x, &y](auto v) {
+            using type = remove_cvref_t<decltype(v)>;
+
+            if constexpr (::std::is_same_v<type, detail::no_truncation>) {
+                return polynomials::detail::pow_poly_impl(::std::forward<T>(x), ::std::forward<U>(y));
+            } else if constexpr (::std::is_same_v<type, deg_t>) {
+                return polynomials::detail::pow_poly_impl(::std::forward<T>(x), ::std::forward<U>(y), v);
+            } else {
+                return polynomials::detail::pow_poly_impl(::std::forward<T>(x), ::std::forward<U>(y), v.first,
+                                                          v.second);
+            }
+        },
+        ::obake::get_truncation(x));
 
     // Re-assign the tag and truncate.
     ret.tag() = ::std::move(orig_tag);
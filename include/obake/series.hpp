@@ -11,13 +11,16 @@
 
 #include <algorithm>
 #include <any>
+#include <atomic>
+#include <bit>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
-#include <functional>
 #include <iterator>
+#include <memory>
 #include <mutex>
 #include <numeric>
+#include <optional>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -26,7 +29,6 @@
 #include <type_traits>
 #include <typeindex>
 #include <typeinfo>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -53,6 +55,7 @@
 #include <obake/detail/abseil.hpp>
 #include <obake/detail/fcast.hpp>
 #include <obake/detail/fmt_compat.hpp>
+#include <obake/detail/hc.hpp>
 #include <obake/detail/ignore.hpp>
 #include <obake/detail/limits.hpp>
 #include <obake/detail/not_implemented.hpp>
@@ -77,6 +80,7 @@
 #include <obake/key/key_trim_identify.hpp>
 #include <obake/math/degree.hpp>
 #include <obake/math/evaluate.hpp>
+#include <obake/math/fma3.hpp>
 #include <obake/math/is_zero.hpp>
 #include <obake/math/negate.hpp>
 #include <obake/math/p_degree.hpp>
@@ -84,6 +88,7 @@
 #include <obake/math/safe_cast.hpp>
 #include <obake/math/safe_convert.hpp>
 #include <obake/math/trim.hpp>
+#include <obake/ranges.hpp>
 #include <obake/s11n.hpp>
 #include <obake/symbols.hpp>
 #include <obake/tex_stream_insert.hpp>
@@ -405,6 +410,151 @@ inline void series_add_term(S &s, T &&key, Args &&...args)
     }
 }
 
+// Requirements for the range type R in the bulk insertion
+// of terms into a series with key K and coefficient C:
+// R must be a random-access range whose values are
+// pair-like objects consisting of a key and of
+// an object from which a coefficient can be constructed.
+template <typename R, typename K, typename C>
+concept SeriesTermRange = RandomAccessRange<R> && requires(range_begin_t<R> it)
+{
+    requires SameCvr<decltype(::std::get<0>(*it)), K>;
+    requires Constructible<C, decltype(::std::get<1>(*it))>;
+};
+
+// Minimum number of terms for the automatic
+// segmentation in series_add_terms().
+inline constexpr ::std::size_t series_add_terms_mt_threshold = 100000u;
+
+// Target number of terms per table for the automatic
+// segmentation in series_add_terms().
+inline constexpr ::std::size_t series_add_terms_seg_size = 4096u;
+
+// Bulk insertion of the terms in the range r into the series s.
+// If s is empty and not segmented, its segmentation is chosen
+// according to the size of r. In the segmented case, the terms
+// are first partitioned, in parallel, according to the table
+// they belong to, and then the tables are filled in parallel.
+// All the checks on insertion are run, apart from the uniqueness
+// check if AssumeUnique is true. If r is a mutable rvalue, its
+// keys and coefficients will be moved. If an exception is thrown,
+// all the terms in s will be removed.
+template <bool AssumeUnique, typename S, typename R>
+inline void series_add_terms(S &s, R &&r)
+{
+    using s_size_t = typename remove_cvref_t<decltype(s._get_s_table())>::size_type;
+    using it_diff_t = typename ::std::iterator_traits<range_begin_t<R &>>::difference_type;
+
+    constexpr auto assume_unique = AssumeUnique ? sat_assume_unique::on : sat_assume_unique::off;
+
+    const auto b = ::obake::begin(r);
+    const auto n = ::obake::safe_cast<::std::size_t>(::obake::end(r) - b);
+
+    if (n == 0u) {
+        return;
+    }
+
+    // Pick the segmentation, if possible.
+    if (s.empty() && s.get_s_size() == 0u && n >= series_add_terms_mt_threshold && ::obake::detail::hc() > 1u) {
+        // NOTE: aim for series_add_terms_seg_size terms per table,
+        // but with at least a few tables per core.
+        const auto n_seg = ::std::max(n / series_add_terms_seg_size,
+                                      static_cast<::std::size_t>(::obake::detail::hc()) * 4u);
+        s.set_n_segments(::std::min(static_cast<unsigned>(::std::bit_width(n_seg - 1u)), S::get_max_s_size()));
+    }
+    if (s.empty()) {
+        s.reserve(::obake::safe_cast<decltype(s.size())>(n));
+    }
+
+    // Helper to insert the i-th element of r into the table tab.
+    auto insert = [&s, &b](auto &tab, ::std::size_t i) {
+        auto &&elem = *(b + static_cast<it_diff_t>(i));
+
+        using elem_t = ::std::remove_reference_t<decltype(elem)>;
+
+        if constexpr (::std::conjunction_v<is_mutable_rvalue_reference<R &&>,
+                                           ::std::negation<::std::is_const<elem_t>>>) {
+            detail::series_add_term_table<true, sat_check_zero::on, sat_check_compat_key::on, sat_check_table_size::on,
+                                          assume_unique>(s, tab, ::std::move(::std::get<0>(elem)),
+                                                         ::std::move(::std::get<1>(elem)));
+        } else {
+            detail::series_add_term_table<true, sat_check_zero::on, sat_check_compat_key::on, sat_check_table_size::on,
+                                          assume_unique>(s, tab, ::std::as_const(::std::get<0>(elem)),
+                                                         ::std::as_const(::std::get<1>(elem)));
+        }
+    };
+
+    auto &s_table = s._get_s_table();
+    const auto log2_size = s.get_s_size();
+
+    try {
+        if (log2_size == 0u) {
+            for (::std::size_t i = 0; i < n; ++i) {
+                insert(s_table[0], i);
+            }
+        } else {
+            // NOTE: as in series_segmented_rebuild(), the
+            // destination tables are split in n_groups groups
+            // and r is split in n_groups chunks. In the first phase,
+            // the indices of the terms in each chunk are bucketed according
+            // to the group of destination tables they belong to. In the second
+            // phase, the buckets are inserted into the destination tables,
+            // group by group, with no need for synchronisation.
+            using bucket_t = ::std::vector<::std::pair<s_size_t, ::std::size_t>>;
+
+            const auto log2_n_groups = ::std::min(log2_size, 6u);
+            const auto group_shift = log2_size - log2_n_groups;
+            const auto n_groups = s_size_t(1) << log2_n_groups;
+            const auto table_mask = (s_size_t(1) << log2_size) - 1u;
+            const auto chunk_size = n / n_groups + static_cast<::std::size_t>(n % n_groups != 0u);
+
+            // The buckets: the bucket for the chunk c and
+            // the group of destination tables g is at
+            // index c * n_groups + g.
+            ::std::vector<bucket_t> buckets(
+                ::obake::safe_cast<typename ::std::vector<bucket_t>::size_type>(n_groups * n_groups));
+
+            // Phase 1.
+            ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, n_groups), [&](const auto &range) {
+                for (auto c = range.begin(); c != range.end(); ++c) {
+                    const auto c_begin = ::std::min(static_cast<::std::size_t>(c) * chunk_size, n);
+                    const auto c_end = ::std::min(c_begin + chunk_size, n);
+
+                    for (auto i = c_begin; i < c_end; ++i) {
+                        // NOTE: elem may be bound to a temporary.
+                        auto &&elem = *(b + static_cast<it_diff_t>(i));
+                        const auto idx
+                            = static_cast<s_size_t>(::obake::hash(::std::as_const(::std::get<0>(elem))) & table_mask);
+
+                        buckets[c * n_groups + (idx >> group_shift)].emplace_back(idx, i);
+                    }
+                }
+            });
+
+            // Phase 2.
+            ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, n_groups), [&](const auto &range) {
+                for (auto g = range.begin(); g != range.end(); ++g) {
+                    for (s_size_t c = 0; c < n_groups; ++c) {
+                        for (const auto &p : buckets[c * n_groups + g]) {
+                            insert(s_table[p.first], p.second);
+                        }
+
+                        // NOTE: free the memory of the bucket as soon
+                        // as we are done with it.
+                        bucket_t{}.swap(buckets[c * n_groups + g]);
+                    }
+                }
+            });
+        }
+    } catch (...) {
+        // NOTE: s may now contain only a part
+        // of the terms in r. Remove all terms
+        // before rethrowing.
+        s.clear_terms();
+        throw;
+    }
+}
+
 // Machinery for series' generic constructor.
 template <typename T, typename K, typename C, typename Tag>
 constexpr int series_generic_ctor_algorithm_impl()
@@ -519,6 +669,72 @@ struct series_key_hasher {
     }
 };
 
+// Helper to cache the content hash of a series.
+// NOTE: the cached value may be fetched/updated concurrently
+// via const member functions of series, hence the atomics. The value
+// is always stored before the validity flag, so that
+// a valid flag implies a consistent value.
+class series_hash_cache
+{
+public:
+    series_hash_cache() = default;
+    series_hash_cache(const series_hash_cache &other) noexcept
+    {
+        copy_from(other);
+    }
+    series_hash_cache &operator=(const series_hash_cache &other) noexcept
+    {
+        if (this != &other) {
+            copy_from(other);
+        }
+
+        return *this;
+    }
+    ~series_hash_cache() = default;
+
+    // Fetch the cached value, computing
+    // it via f() if the cache is not valid.
+    template <typename F>
+    ::std::size_t get(const F &f) const
+    {
+        if (m_valid.load(::std::memory_order_acquire)) {
+            return m_value.load(::std::memory_order_relaxed);
+        }
+
+        const ::std::size_t retval = f();
+
+        m_value.store(retval, ::std::memory_order_relaxed);
+        m_valid.store(true, ::std::memory_order_release);
+
+        return retval;
+    }
+
+    // Invalidate the cache.
+    void invalidate() noexcept
+    {
+        // NOTE: check first, so that we don't write to memory
+        // if the cache is already invalid (the invalidation is done
+        // in hot paths, potentially from multiple threads).
+        if (m_valid.load(::std::memory_order_relaxed)) {
+            m_valid.store(false, ::std::memory_order_relaxed);
+        }
+    }
+
+private:
+    void copy_from(const series_hash_cache &other) noexcept
+    {
+        if (other.m_valid.load(::std::memory_order_acquire)) {
+            m_value.store(other.m_value.load(::std::memory_order_relaxed), ::std::memory_order_relaxed);
+            m_valid.store(true, ::std::memory_order_release);
+        } else {
+            m_valid.store(false, ::std::memory_order_relaxed);
+        }
+    }
+
+    mutable ::std::atomic<bool> m_valid = false;
+    mutable ::std::atomic<::std::size_t> m_value = 0;
+};
+
 // Wrapper to force key comparison via const lvalue refs.
 struct series_key_comparer {
     template <typename K>
@@ -556,6 +772,93 @@ struct series_rref_clearer {
     T &&m_ref;
 };
 
+// Helper to rebuild into the series "to" the terms of the segmented
+// table from_s_table, consisting of 2**log2_size > 1 tables. "to" must be empty
+// and have the same number of segments as from_s_table. Each key of from_s_table
+// is transformed via kf, and then ins(to_table, new_key, cf) is invoked to insert
+// the new key and the original coefficient cf into the destination table to_table.
+// Because the transformed keys may end up in tables different from the original
+// ones, we proceed in two parallel phases:
+// - first, the source tables are split in n_groups blocks, and
+//   the transformed keys of each block are computed and bucketed
+//   according to the group of destination tables they belong to;
+// - second, the buckets are inserted into the destination tables,
+//   group by group.
+// The groups of destination tables are disjoint, hence no
+// synchronisation is needed in the second phase. The number of
+// groups is capped in order to limit the number of buckets.
+// If an exception is thrown, "to" will be cleared.
+template <typename To, typename FromSTable, typename KF, typename Ins>
+inline void series_segmented_rebuild(To &to, FromSTable &from_s_table, unsigned log2_size, const KF &kf,
+                                     const Ins &ins)
+{
+    assert(log2_size > 0u);
+    assert(to.empty());
+    assert(to.get_s_size() == log2_size);
+
+    using s_size_t = typename remove_cvref_t<decltype(to._get_s_table())>::size_type;
+    using key_t = series_key_t<remove_cvref_t<To>>;
+    using cf_ptr_t = decltype(&(from_s_table[0].begin()->second));
+    using bucket_t = ::std::vector<::std::tuple<s_size_t, key_t, cf_ptr_t>>;
+
+    const auto log2_n_groups = ::std::min(log2_size, 6u);
+    const auto group_shift = log2_size - log2_n_groups;
+    const auto n_groups = s_size_t(1) << log2_n_groups;
+    const auto table_mask = (s_size_t(1) << log2_size) - 1u;
+
+    auto &to_s_table = to._get_s_table();
+
+    try {
+        // The buckets: the bucket for the block of
+        // source tables b and the group of destination
+        // tables g is at index b * n_groups + g.
+        ::std::vector<bucket_t> buckets(
+            ::obake::safe_cast<typename ::std::vector<bucket_t>::size_type>(n_groups * n_groups));
+
+        // Phase 1.
+        ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, n_groups), [&](const auto &range) {
+            for (auto b = range.begin(); b != range.end(); ++b) {
+                for (auto i = b << group_shift; i != ((b + 1u) << group_shift); ++i) {
+                    for (auto &term : from_s_table[i]) {
+                        // Compute the new key and the index
+                        // of its destination table.
+                        key_t new_key(kf(::std::as_const(term.first)));
+                        const auto idx = static_cast<s_size_t>(::obake::hash(::std::as_const(new_key)) & table_mask);
+
+                        buckets[b * n_groups + (idx >> group_shift)].emplace_back(idx, ::std::move(new_key),
+                                                                                  &term.second);
+                    }
+                }
+            }
+        });
+
+        // Phase 2.
+        ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, n_groups), [&](const auto &range) {
+            for (auto g = range.begin(); g != range.end(); ++g) {
+                for (s_size_t b = 0; b < n_groups; ++b) {
+                    for (auto &tup : buckets[b * n_groups + g]) {
+                        // NOTE: old clang does not like structured
+                        // bindings in the for loop.
+                        ins(to_s_table[::std::get<0>(tup)], ::std::move(::std::get<1>(tup)), *::std::get<2>(tup));
+                    }
+
+                    // NOTE: free the memory of the bucket as soon
+                    // as we are done with it.
+                    bucket_t{}.swap(buckets[b * n_groups + g]);
+                }
+            }
+        });
+        // LCOV_EXCL_START
+    } catch (...) {
+        // NOTE: make sure to clear out "to" before
+        // rethrowing, as its tables may have been
+        // only partially filled.
+        to.clear();
+        throw;
+    }
+    // LCOV_EXCL_STOP
+}
+
 // Helper to extend the keys of "from" with the symbol insertion map ins_map.
 // The new series will be written to "to". The coefficient type of "to"
 // may be different from the coefficient type of "from", in which case a coefficient
@@ -598,18 +901,24 @@ inline void series_sym_extender(To &to, From &&from, const symbol_idx_map<symbol
     constexpr auto check_zero
         = static_cast<sat_check_zero>(::std::is_same_v<series_cf_t<To>, series_cf_t<remove_cvref_t<From>>>);
 
+    // NOTE: fetch the mutable segmented table of from only if from
+    // is a mutable rvalue (so that the coefficients can be moved from).
+    // Otherwise, go through the const overload, which does not
+    // invalidate the cached content hash of from.
+    auto &from_s_table = [&from]() -> auto & {
+        if constexpr (is_mutable_rvalue_reference_v<From &&>) {
+            return from._get_s_table();
+        } else {
+            return ::std::as_const(from)._get_s_table();
+        }
+    }();
+
     // Merge the terms, distinguishing the segmented vs non-segmented case.
     if (from_log2_size) {
-        for (auto &t : from._get_s_table()) {
-            for (auto &term : t) {
-                // NOTE: old clang does not like structured
-                // bindings in the for loop.
-                auto &k = term.first;
-                auto &c = term.second;
-
-                // Compute the merged key.
-                auto merged_key = ::obake::key_merge_symbols(k, ins_map, orig_ss);
-
+        detail::series_segmented_rebuild(
+            to, from_s_table, from_log2_size,
+            [&ins_map, &orig_ss](const auto &k) { return ::obake::key_merge_symbols(k, ins_map, orig_ss); },
+            [&to](auto &to_table, auto &&merged_key, auto &c) {
                 // Insert the term. We need the following checks:
                 // - zero check, in case the coefficient type changes,
                 // - table size check, because even if we know the
@@ -620,18 +929,19 @@ inline void series_sym_extender(To &to, From &&from, const symbol_idx_map<symbol
                 // that symbol merging does not affect is_zero(), compatibility and
                 // uniqueness.
                 if constexpr (is_mutable_rvalue_reference_v<From &&>) {
-                    detail::series_add_term<true, check_zero, sat_check_compat_key::off, sat_check_table_size::on,
-                                            sat_assume_unique::on>(to, ::std::move(merged_key), ::std::move(c));
+                    detail::series_add_term_table<true, check_zero, sat_check_compat_key::off,
+                                                  sat_check_table_size::on, sat_assume_unique::on>(
+                        to, to_table, ::std::move(merged_key), ::std::move(c));
                 } else {
-                    detail::series_add_term<true, check_zero, sat_check_compat_key::off, sat_check_table_size::on,
-                                            sat_assume_unique::on>(to, ::std::move(merged_key), ::std::as_const(c));
+                    detail::series_add_term_table<true, check_zero, sat_check_compat_key::off,
+                                                  sat_check_table_size::on, sat_assume_unique::on>(
+                        to, to_table, ::std::move(merged_key), ::std::as_const(c));
                 }
-            }
-        }
+            });
     } else {
         auto &to_table = to._get_s_table()[0];
 
-        for (const auto &[k, c] : from._get_s_table()[0]) {
+        for (auto &[k, c] : from_s_table[0]) {
             // Compute the merged key.
             auto merged_key = ::obake::key_merge_symbols(k, ins_map, orig_ss);
 
@@ -686,8 +996,11 @@ public:
     series(const series &) = default;
     series(series &&other) noexcept
         : m_s_table(::std::move(other.m_s_table)), m_log2_size(::std::move(other.m_log2_size)),
-          m_tag(::std::move(other.m_tag)), m_symbol_set(::std::move(other.m_symbol_set))
+          m_tag(::std::move(other.m_tag)), m_symbol_set(::std::move(other.m_symbol_set)),
+          m_hash_cache(other.m_hash_cache)
     {
+        other.m_hash_cache.invalidate();
+
 #if !defined(NDEBUG)
         // In debug mode, clear the other segmented table
         // in order to flag that other was moved from.
@@ -757,10 +1070,21 @@ public:
             // change, the keys remain identical, so we can do the insertion
             // table by table, relying on the fact that the new keys
             // will hash to the same table indices as the original ones.
-            // NOTE: this could be parallelised, if needed.
-            for (s_size_type i = 0; i < (s_size_type(1) << x_log2_size); ++i) {
+            // NOTE: fetch the segmented table of x once, outside the
+            // parallel region. The mutable overload, which invalidates the
+            // cached content hash of x, is used only if x is a mutable rvalue
+            // (so that the coefficients can be moved from).
+            auto &x_s_table = [&x]() -> auto & {
+                if constexpr (is_mutable_rvalue_reference_v<T &&>) {
+                    return x._get_s_table();
+                } else {
+                    return ::std::as_const(x)._get_s_table();
+                }
+            }();
+
+            auto convert_table = [this, &x_s_table](s_size_type i) {
                 // Extract references to the tables in x and this.
-                auto &xt = x._get_s_table()[i];
+                auto &xt = x_s_table[i];
                 auto &tab = m_s_table[i];
 
                 // Reserve space in the current table.
@@ -791,6 +1115,30 @@ public:
                             *this, tab, k, ::std::as_const(c));
                     }
                 }
+
+                if constexpr (is_mutable_rvalue_reference_v<T &&>) {
+                    // NOTE: if x is an rvalue, we can free the memory
+                    // of the current table as soon as we are done with it
+                    // (all its coefficients have been moved out anyway),
+                    // so that the peak memory usage of the conversion
+                    // does not amount to two full copies of the series.
+                    xt = remove_cvref_t<decltype(xt)>{};
+                }
+            };
+
+            // NOTE: the tables are independent from each other,
+            // thus they can be converted in parallel. If an exception
+            // is thrown, it will be propagated out of the constructor
+            // and the partially-constructed series will be destroyed.
+            if (x_log2_size > 0u) {
+                ::tbb::parallel_for(::tbb::blocked_range<s_size_type>(0, s_size_type(1) << x_log2_size),
+                                    [&convert_table](const auto &range) {
+                                        for (auto i = range.begin(); i != range.end(); ++i) {
+                                            convert_table(i);
+                                        }
+                                    });
+            } else {
+                convert_table(0);
             }
         } else {
             // Case 3: the series rank of T is higher than the series
@@ -847,6 +1195,10 @@ public:
         m_log2_size = ::std::move(other.m_log2_size);
         m_tag = ::std::move(other.m_tag);
         m_symbol_set = ::std::move(other.m_symbol_set);
+        m_hash_cache = other.m_hash_cache;
+        if (this != &other) {
+            other.m_hash_cache.invalidate();
+        }
 
 #if !defined(NDEBUG)
         // NOTE: see above.
@@ -956,6 +1308,10 @@ public:
         swap(m_log2_size, other.m_log2_size);
         swap(m_tag, other.m_tag);
         swap(m_symbol_set, other.m_symbol_set);
+
+        const auto tmp(m_hash_cache);
+        m_hash_cache = other.m_hash_cache;
+        other.m_hash_cache = tmp;
     }
 
     bool empty() const noexcept
@@ -1284,8 +1640,12 @@ public:
     }
 
     // Extract a reference to the internal segmented table.
+    // NOTE: the mutable overload invalidates the cached content
+    // hash, as the table may be used to alter the keys.
     auto &_get_s_table()
     {
+        m_hash_cache.invalidate();
+
         return m_s_table;
     }
     const auto &_get_s_table() const
@@ -1316,6 +1676,32 @@ public:
             *this, ::std::forward<T>(key), ::std::forward<Args>(args)...);
     }
 
+    // Bulk insertion of terms from a random-access range
+    // of key/coefficient pairs. If AssumeUnique is true, the
+    // keys in r are assumed to be distinct from each other and
+    // from the keys already in the series.
+    // NOTE: this method requires that the terms
+    // being inserted are not from this series.
+    template <bool AssumeUnique = false, typename R>
+        requires detail::SeriesTermRange<R, K, C>
+    void add_terms(R &&r)
+    {
+        detail::series_add_terms<AssumeUnique>(*this, ::std::forward<R>(r));
+    }
+
+    // Construct a series with symbol set ss from a range
+    // of key/coefficient pairs (see add_terms()).
+    template <bool AssumeUnique = false, typename R>
+        requires detail::SeriesTermRange<R, K, C>
+    static series from_terms(const symbol_set &ss, R &&r)
+    {
+        series retval;
+        retval.set_symbol_set(ss);
+        retval.template add_terms<AssumeUnique>(::std::forward<R>(r));
+
+        return retval;
+    }
+
     // Set the number of segments (in log2 units).
     void set_n_segments(unsigned l)
     {
@@ -1328,6 +1714,7 @@ public:
         // NOTE: construct + move assign for exception safety.
         m_s_table = s_table_type(s_size_type(1) << l);
         m_log2_size = l;
+        m_hash_cache.invalidate();
     }
 
     // Remove all the terms in the series.
@@ -1338,6 +1725,8 @@ public:
         for (auto &t : m_s_table) {
             t.clear();
         }
+
+        m_hash_cache.invalidate();
     }
 
     // Clear the series.
@@ -1435,10 +1824,64 @@ public:
     }
 
     // Tag access.
+    // NOTE: the mutable overload invalidates
+    // the cached content hash.
     Tag &tag() &
     {
+        m_hash_cache.invalidate();
+
         return m_tag;
     }
+
+    // Content hash. This is computed by combining (via addition,
+    // so that the order of the terms does not matter) the hashes
+    // of the keys, and the hash of the tag (if available). The coefficients
+    // and the symbol set are not taken into account.
+    // NOTE: the hash is computed lazily (in parallel over the segments, if the table
+    // is segmented) and cached. The cache is invalidated by the member functions which
+    // may alter the keys or the tag (in particular, by the mutable overloads of _get_s_table()
+    // and tag()).
+    ::std::size_t content_hash() const
+    {
+        return m_hash_cache.get([this]() {
+            // Init retval with the hash of the tag, if available,
+            // zero otherwise.
+            auto retval = [this]() -> ::std::size_t {
+                if constexpr (is_hashable_v<const Tag &>) {
+                    return ::obake::hash(m_tag);
+                } else {
+                    return 0;
+                }
+            }();
+
+            auto table_hash = [](const table_type &tab) {
+                ::std::size_t ret = 0;
+
+                for (const auto &t : tab) {
+                    // NOTE: use the same hasher used in the tables.
+                    ret += detail::series_key_hasher{}(t.first);
+                }
+
+                return ret;
+            };
+
+            if (m_s_table.size() > 1u) {
+                retval += ::tbb::parallel_reduce(
+                    ::tbb::blocked_range(m_s_table.begin(), m_s_table.end()), ::std::size_t(0),
+                    [&table_hash](const auto &range, ::std::size_t cur) {
+                        for (const auto &tab : range) {
+                            cur += table_hash(tab);
+                        }
+                        return cur;
+                    },
+                    [](::std::size_t a, ::std::size_t b) { return a + b; });
+            } else {
+                retval += table_hash(m_s_table[0]);
+            }
+
+            return retval;
+        });
+    }
     const Tag &tag() const &
     {
         return m_tag;
@@ -1548,6 +1991,7 @@ private:
     unsigned m_log2_size;
     Tag m_tag;
     detail::ss_fw m_symbol_set;
+    detail::series_hash_cache m_hash_cache;
 };
 
 } // namespace obake
@@ -1628,29 +2072,137 @@ inline bool series_are_identical(const S &s1, const S &s2)
     return s1.get_symbol_set_fw() == s2.get_symbol_set_fw() && internal::series_cmp_identical_ss(s1, s2);
 }
 
-// The series pow cache for a specific series type.
-// It maps a series instance x to a vector of natural
-// powers of x. Everything is type-erased as we need
-// to store instances of this type as elements of another map.
-// NOTE: the key in this map is the base, the vectors
-// are the base raised to its natural powers. All these
-// std::any will contain instances of the base type.
-using series_te_pow_map_t = ::std::unordered_map<::std::any, ::std::vector<::std::any>,
-                                                 // Hashing functor.
-                                                 ::std::function<::std::size_t(const ::std::any &)>,
-                                                 // Equality comparator.
-                                                 ::std::function<bool(const ::std::any &, const ::std::any &)>>;
-
-// Series pow cache. It maps a C++ series type, represented
-// as a type_index, to a series_te_pow_map_t map.
-using series_pow_map_t = ::std::unordered_map<::std::type_index, series_te_pow_map_t>;
-
-// Function to fetch the global series pow cache and associated mutex.
-OBAKE_DLL_PUBLIC ::std::tuple<series_pow_map_t &, ::std::mutex &> get_series_pow_map();
+// An entry in the global series pow cache: a type-erased
+// series (the base) and the natural powers of the base computed
+// so far (also type-erased).
+struct series_pow_cache_entry {
+    explicit series_pow_cache_entry(const ::std::type_index &t, ::std::size_t h, ::std::any b)
+        : t_idx(t), hash(h), base(::std::move(b))
+    {
+    }
+
+    // The type of the base, its hash and the base itself.
+    const ::std::type_index t_idx;
+    const ::std::size_t hash;
+    const ::std::any base;
+    // The mutex protecting the powers.
+    ::std::mutex mutex;
+    // The powers of the base.
+    ::std::vector<::std::any> powers;
+    // Bookkeeping data managed by the cache: the memory footprint of
+    // the entry (in bytes), a flag signalling whether or not the entry
+    // is still in the cache (i.e., it has not been evicted) and the
+    // time of the last use of the entry (in arbitrary units).
+    ::std::size_t n_bytes = 0;
+    bool cached = true;
+    unsigned long long last_use = 0;
+};
+
+// Statistics about the global series pow cache.
+struct series_pow_cache_stats {
+    // Number of power requests that were satisfied
+    // by the cache, that required the computation
+    // of new powers, and number of evicted entries.
+    unsigned long long hits = 0, misses = 0, evictions = 0;
+    // Number of entries and total memory footprint of the cache.
+    ::std::size_t n_entries = 0, n_bytes = 0;
+    // The memory budget of the cache.
+    ::std::size_t max_bytes = 0;
+};
+
+// Type-erased functions to test the base of an entry
+// for equality with a series, and to copy a series
+// into a std::any.
+using series_pow_cache_eq_t = bool (*)(const ::std::any &, const void *);
+using series_pow_cache_copy_t = ::std::any (*)(const void *);
+
+// Look up in the global series pow cache the entry for the
+// series of type t_idx pointed to by ptr and with hash h, marking it
+// as the most recently used entry. If the entry does not exist, it will be
+// created via copy (if copy is not null), otherwise a null pointer is returned.
+OBAKE_DLL_PUBLIC ::std::shared_ptr<series_pow_cache_entry>
+series_pow_cache_lookup(const ::std::type_index &, ::std::size_t, const void *, series_pow_cache_eq_t,
+                        series_pow_cache_copy_t);
+
+// Add n bytes to the memory footprint of a cache entry,
+// evicting the least recently used entries if the memory
+// budget of the cache is exceeded.
+OBAKE_DLL_PUBLIC void series_pow_cache_account(const ::std::shared_ptr<series_pow_cache_entry> &, ::std::size_t);
+
+// Record a cache hit or miss.
+OBAKE_DLL_PUBLIC void series_pow_cache_record(bool);
+
+// Fetch the statistics of the global series pow cache.
+OBAKE_DLL_PUBLIC series_pow_cache_stats get_series_pow_cache_stats();
+
+// Get/set the memory budget (in bytes) of the global series pow cache.
+OBAKE_DLL_PUBLIC ::std::size_t get_series_pow_cache_max_bytes();
+OBAKE_DLL_PUBLIC void set_series_pow_cache_max_bytes(::std::size_t);
 
 // Function to clear the global series pow cache.
 OBAKE_DLL_PUBLIC void clear_series_pow_map();
 
+template <typename Base>
+inline bool series_pow_cache_eq(const ::std::any &x, const void *y)
+{
+    // NOTE: need to use series_are_identical() (and not the comparison operator)
+    // because the comparison operator does symbol merging, and thus it is
+    // not consistent with content_hash() (i.e., two series may
+    // compare equal according to operator==() and have different hashes).
+    // NOTE: with these choices of hasher/comparer, the requirement that
+    // cmp(a, b) == true -> hash(a) == hash(b) is always satisfied (even if, say,
+    // the user customises series_equal_to()).
+    return internal::series_are_identical(::std::any_cast<const Base &>(x), *static_cast<const Base *>(y));
+}
+
+template <typename Base>
+inline ::std::any series_pow_cache_copy(const void *x)
+{
+    return ::std::any(*static_cast<const Base *>(x));
+}
+
+// Estimate the memory footprint of a series
+// stored in the global series pow cache.
+template <typename Base>
+inline ::std::size_t series_pow_cache_byte_size(const Base &x)
+{
+    if constexpr (is_size_measurable_v<const Base &>) {
+        return ::obake::byte_size(x);
+    } else {
+        return sizeof(Base);
+    }
+}
+
+// Fetch the cache entry for the input series 'base',
+// creating it if it does not exist and create is true.
+template <typename Base>
+inline ::std::shared_ptr<series_pow_cache_entry> series_pow_cache_fetch(const Base &base, bool create)
+{
+    // NOTE: the hash is computed outside the critical
+    // sections of the cache (and it is cached in base).
+    return internal::series_pow_cache_lookup(::std::type_index(typeid(Base)), base.content_hash(),
+                                             &base, &internal::series_pow_cache_eq<Base>,
+                                             create ? &internal::series_pow_cache_copy<Base> : nullptr);
+}
+
+// Fetch the number of natural powers of the input
+// series 'base' currently stored in the global cache.
+// That is, if this function returns n > 0, the powers
+// base**0, base**1, ..., base**(n-1) can be fetched
+// from the cache without computing them.
+template <typename Base>
+inline ::std::size_t series_pow_cache_size(const Base &base)
+{
+    const auto e = internal::series_pow_cache_fetch(base, false);
+    if (!e) {
+        return 0;
+    }
+
+    ::std::lock_guard lock(e->mutex);
+
+    return e->powers.size();
+}
+
 // Fetch the n-th natural power of the input
 // series 'base' from the global cache. If the
 // power is not present in the cache already,
@@ -1658,72 +2210,26 @@ OBAKE_DLL_PUBLIC void clear_series_pow_map();
 template <typename Base>
 inline Base series_pow_from_cache(const Base &base, unsigned n)
 {
-    // Fetch the global data.
-    auto [map, mutex] = internal::get_series_pow_map();
-
-    // Turn the type into a type_index.
-    ::std::type_index t_idx(typeid(Base));
-
-    // The concrete hasher and equality comparator
-    // functors for use in series_te_pow_map_t.
-    // They will be wrapped in a std::function.
-    struct hasher {
-        ::std::size_t operator()(const ::std::any &x) const
-        {
-            const auto &bcast = ::std::any_cast<const Base &>(x);
-
-            // Init retval with the hash of the tag, if available,
-            // zero otherwise.
-            auto retval = [&bcast]() -> ::std::size_t {
-                if constexpr (is_hashable_v<const series_tag_t<Base> &>) {
-                    return ::obake::hash(bcast.tag());
-                } else {
-                    detail::ignore(bcast);
-                    return 0;
-                }
-            }();
+    // Fetch the entry.
+    // NOTE: the shared pointer keeps the entry alive
+    // even if it is evicted while we are using it.
+    const auto e = internal::series_pow_cache_fetch(base, true);
 
-            // Combine the hashes of all terms
-            // via addition, so that their order
-            // does not matter.
-            for (const auto &t : bcast) {
-                // NOTE: use the same hasher used in the implementation
-                // of series.
-                // NOTE: parallelisation opportunities here for
-                // segmented tables.
-                retval += detail::series_key_hasher{}(t.first);
-            }
-
-            return retval;
-        }
-    };
+    // Fetch a reference to the base.
+    const auto &b = ::std::any_cast<const Base &>(e->base);
 
-    struct comparer {
-        bool operator()(const ::std::any &x, const ::std::any &y) const
-        {
-            // NOTE: need to use series_are_identical() (and not the comparison operator)
-            // because the comparison operator does symbol merging, and thus it is
-            // not consistent with the hasher defined above (i.e., two series may
-            // compare equal according to operator==() and have different hashes).
-            // NOTE: with these choices of hasher/comparer, the requirement that
-            // cmp(a, b) == true -> hash(a) == hash(b) is always satisfied (even if, say,
-            // the user customises series_equal_to()).
-            return internal::series_are_identical(::std::any_cast<const Base &>(x), ::std::any_cast<const Base &>(y));
-        }
-    };
+    // The memory footprint of the newly-computed powers.
+    ::std::size_t n_bytes = 0;
 
-    // Lock down before accessing the cache.
-    ::std::lock_guard lock(mutex);
+    // NOTE: the entry's mutex is held while the powers are being
+    // computed: the powers of different bases are computed in parallel,
+    // while concurrent requests for the same base wait
+    // for each other, so that the powers are computed only once.
+    ::std::unique_lock lock(e->mutex);
 
-    // Try first to locate the series_te_pow_map_t for the current type,
-    // then, in that map, try to locate 'base'. Use try_emplace() so that
-    // table elements are created as needed.
-    auto it = map.try_emplace(t_idx, 0, hasher{}, comparer{}).first->second.try_emplace(base).first;
+    auto &v = e->powers;
 
-    // Fetch a reference to the base and the corresponding
-    // exponentiation vector.
-    const auto &b = ::std::any_cast<const Base &>(it->first);
-    auto &v = it->second;
+    internal::series_pow_cache_record(n < v.size());
 
     // If the exponentiation vector is empty, init it with
     // base**0 = 1.
@@ -1733,17 +2239,52 @@ inline Base series_pow_from_cache(const Base &base, unsigned n)
         // (and the return type is guaranteed to be the same as
         // the Base type in this function).
         v.emplace_back(Base(1));
+
+        n_bytes += internal::series_pow_cache_byte_size(b)
+                   + internal::series_pow_cache_byte_size(::std::any_cast<const Base &>(v.back()));
     }
 
     // Fill in the missing powers as needed.
     while (v.size() <= n) {
-        v.emplace_back(::std::any_cast<const Base &>(v.back()) * b);
+        const auto k = v.size();
+        const auto &prev = ::std::any_cast<const Base &>(v.back());
+
+        // For even k, b**k can be computed either as b**(k-1) * b
+        // or as the square of b**(k/2). Squaring a series
+        // with m terms requires roughly m**2/2 term-by-term multiplications
+        // (as the series multiplication will detect the squaring),
+        // thus we pick the cheaper of the two options.
+        // NOTE: do the cost computation in floating-point
+        // in order to avoid overflow issues.
+        if (k % 2u == 0u) {
+            const auto &half = ::std::any_cast<const Base &>(v[k / 2u]);
+            const auto hs = static_cast<double>(half.size());
+
+            if (hs * hs / 2. < static_cast<double>(prev.size()) * static_cast<double>(b.size())) {
+                v.emplace_back(half * half);
+                n_bytes += internal::series_pow_cache_byte_size(::std::any_cast<const Base &>(v.back()));
+                continue;
+            }
+        }
+
+        v.emplace_back(prev * b);
+        n_bytes += internal::series_pow_cache_byte_size(::std::any_cast<const Base &>(v.back()));
     }
 
-    // Return a copy of the desired power.
+    // Copy the desired power.
     // NOTE: returnability is guaranteed because
     // the return type is a series.
-    return ::std::any_cast<const Base &>(v[static_cast<decltype(v.size())>(n)]);
+    Base retval(::std::any_cast<const Base &>(v[static_cast<decltype(v.size())>(n)]));
+
+    lock.unlock();
+
+    // Update the memory footprint of the entry
+    // (this may trigger evictions).
+    if (n_bytes != 0u) {
+        internal::series_pow_cache_account(e, n_bytes);
+    }
+
+    return retval;
 }
 
 // Metaprogramming to establish the algorithm/return
@@ -3128,6 +3669,58 @@ inline constexpr int series_default_mul_algo = series_default_mul_algorithm<T, U
 template <typename T, typename U>
 using series_default_mul_ret_t = typename decltype(series_default_mul_algorithm<T, U>.second)::type;
 
+// Apply in-place the functor f to all the coefficients of the series s,
+// and remove the terms whose coefficients become zero. The tables
+// of a segmented series are processed in parallel. If an exception
+// is thrown, the terms of s are removed (while its symbol set, tag
+// and segmentation are preserved).
+template <typename S, typename F>
+inline void series_in_place_cf_transform(S &s, const F &f)
+{
+    auto &s_table = s._get_s_table();
+
+    auto process_table = [&f](auto &t) {
+        const auto end = t.end();
+        for (auto it = t.begin(); it != end;) {
+            auto &c = it->second;
+
+            f(c);
+
+            if (obake_unlikely(::obake::is_zero(::std::as_const(c)))) {
+                // NOTE: abseil's flat_hash_map returns void on erase(),
+                // thus we need to increase 'it' before possibly erasing.
+                // erase() does not cause rehash and thus will not invalidate
+                // any other iterator apart from the one being erased.
+                t.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+    };
+
+    try {
+        if (s_table.size() > 1u) {
+            ::tbb::parallel_for(::tbb::blocked_range<decltype(s_table.size())>(0, s_table.size()),
+                                [&process_table, &s_table](const auto &range) {
+                                    for (auto i = range.begin(); i != range.end(); ++i) {
+                                        process_table(s_table[i]);
+                                    }
+                                });
+        } else {
+            process_table(s_table[0]);
+        }
+        // LCOV_EXCL_START
+    } catch (...) {
+        // If something goes wrong, make sure to clear
+        // out the terms of s before rethrowing, in order to avoid
+        // a possibly inconsistent state and thus assertion
+        // failures in debug mode.
+        s.clear_terms();
+        throw;
+    }
+    // LCOV_EXCL_STOP
+}
+
 // Default implementation of the mul primitive for series.
 template <typename T, typename U>
 inline series_default_mul_ret_t<T &&, U &&> series_default_mul_impl(T &&x, U &&y)
@@ -3157,49 +3750,29 @@ inline series_default_mul_ret_t<T &&, U &&> series_default_mul_impl(T &&x, U &&y
             return retval;
         }
 
-        // Init the return value from the higher-rank series.
-        ret_t retval(::std::forward<decltype(a)>(a));
-
-        // Multiply in-place all coefficients of retval by b.
-        // Store in a vector the keys of the terms
-        // whose coefficients become zero after
-        // the multiplication, so that we can remove them.
-        // NOTE: this can be parallelised for a segmented table.
-        auto &s_table = retval._get_s_table();
-        ::std::vector<series_key_t<ret_t>> v_keys;
-        try {
-            for (auto &t : s_table) {
-                // Reset the vector of keys to be removed.
-                v_keys.clear();
-
-                // Perform the multiplications for this table.
-                for (auto &[k, c] : t) {
-                    c *= ::std::as_const(b);
-                    // Check if the coefficient became zero
-                    // after the multiplication.
-                    if (obake_unlikely(::obake::is_zero(::std::as_const(c)))) {
-                        v_keys.push_back(k);
-                    }
-                }
+        if constexpr (::std::conjunction_v<::std::is_same<ret_t, ra_t>,
+                                           is_mutable_rvalue_reference<decltype(a) &&>>) {
+            // If a is an rvalue of type ret_t, multiply in-place its
+            // coefficients by b (removing the terms whose coefficients
+            // become zero), and then move it into the return value. In case
+            // of exceptions, a is left without terms, but it retains its
+            // symbol set and tag.
+            // NOTE: b may be a reference to one of the coefficients of a:
+            // make a copy of b before modifying the coefficients.
+            const rb_t b_copy(::std::as_const(b));
+            detail::series_in_place_cf_transform(a, [&b_copy](auto &c) { c *= b_copy; });
+
+            return ret_t(::std::move(a));
+        } else {
+            // Init the return value from the higher-rank series.
+            ret_t retval(::std::forward<decltype(a)>(a));
 
-                // Erase any term whose coefficient became zero.
-                for (const auto &k : v_keys) {
-                    assert(t.find(k) != t.end());
-                    t.erase(k);
-                }
-            }
+            // Multiply in-place all coefficients of retval by b,
+            // removing the terms whose coefficients become zero.
+            detail::series_in_place_cf_transform(retval, [&b](auto &c) { c *= ::std::as_const(b); });
 
             return retval;
-            // LCOV_EXCL_START
-        } catch (...) {
-            // If something goes wrong, make sure to clear
-            // out retval before rethrowing, in order to avoid
-            // a possibly inconsistent state and thus assertion
-            // failures in debug mode.
-            retval.clear();
-            throw;
         }
-        // LCOV_EXCL_STOP
     };
 
     if constexpr (algo == 2) {
@@ -3231,9 +3804,19 @@ constexpr auto operator*(T &&x, U &&y)
 // NOTE: if this gets optimised for performance, we will probably
 // need to add specialisations for, e.g., power_series.
 template <typename T, typename U>
-    requires CvrSeries<T>
+    requires CvrSeries<T> && (series_rank<remove_cvref_t<U>> >= series_rank<remove_cvref_t<T>>)
 constexpr auto operator*=(T &&x, U &&y) OBAKE_SS_FORWARD_FUNCTION(x = ::std::forward<T>(x) * ::std::forward<U>(y));
 
+// NOTE: when multiplying by an object of lower rank, x
+// is passed as an rvalue to operator*(), so that the default
+// implementation can operate in-place on the coefficients
+// of x without copying it first. As a consequence, if an exception
+// is thrown, x may be left without terms (its symbol set and tag
+// are preserved), rather than being left untouched.
+template <typename T, typename U>
+    requires CvrSeries<T> && (series_rank<remove_cvref_t<U>> < series_rank<remove_cvref_t<T>>)
+constexpr auto operator*=(T &&x, U &&y) OBAKE_SS_FORWARD_FUNCTION(x = ::std::move(x) * ::std::forward<U>(y));
+
 template <typename T, typename U>
     requires(!CvrSeries<T>) && CvrSeries<U>
 constexpr auto operator*=(T &&x, U &&y)
@@ -3330,41 +3913,22 @@ inline series_default_div_ret_t<T &&, U &&> series_default_div_impl(T &&x, U &&y
     // Shortcut to the return type.
     using ret_t = series_default_div_ret_t<T &&, U &&>;
 
-    // Init the return value from the higher-rank series.
-    ret_t retval(::std::forward<T>(x));
+    if constexpr (::std::conjunction_v<::std::is_same<ret_t, remove_cvref_t<T>>,
+                                       is_mutable_rvalue_reference<T &&>>) {
+        // NOTE: see the explanation in series_default_mul_impl().
+        const remove_cvref_t<U> y_copy(::std::as_const(y));
+        detail::series_in_place_cf_transform(x, [&y_copy](auto &c) { c /= y_copy; });
 
-    // Divide in-place all coefficients of retval by y.
-    // NOTE: this can be parallelised for a segmented table.
-    auto &s_table = retval._get_s_table();
-    try {
-        for (auto &t : s_table) {
-            // Perform the divisions for this table.
-            const auto end = t.end();
-            for (auto it = t.begin(); it != end;) {
-                auto &c = it->second;
-
-                c /= ::std::as_const(y);
-
-                if (obake_unlikely(::obake::is_zero(::std::as_const(c)))) {
-                    // NOTE: abseil's flat_hash_map returns void on erase(),
-                    // thus we need to increase 'it' before possibly erasing.
-                    // erase() does not cause rehash and thus will not invalidate
-                    // any other iterator apart from the one being erased.
-                    t.erase(it++);
-                } else {
-                    ++it;
-                }
-            }
-        }
+        return ret_t(::std::move(x));
+    } else {
+        // Init the return value from the higher-rank series.
+        ret_t retval(::std::forward<T>(x));
+
+        // Divide in-place all coefficients of retval by y,
+        // removing the terms whose coefficients become zero.
+        detail::series_in_place_cf_transform(retval, [&y](auto &c) { c /= ::std::as_const(y); });
 
         return retval;
-    } catch (...) {
-        // If something goes wrong, make sure to clear
-        // out retval before rethrowing, in order to avoid
-        // a possibly inconsistent state and thus assertion
-        // failures in debug mode.
-        retval.clear();
-        throw;
     }
 }
 
@@ -3388,9 +3952,16 @@ constexpr auto operator/(T &&x, U &&y)
 // NOTE: for now, implement operator/=() in terms of operator/().
 // This can be optimised later performance-wise.
 template <typename T, typename U>
-    requires CvrSeries<T>
+    requires CvrSeries<T> && (series_rank<remove_cvref_t<U>> >= series_rank<remove_cvref_t<T>>)
 constexpr auto operator/=(T &&x, U &&y) OBAKE_SS_FORWARD_FUNCTION(x = ::std::forward<T>(x) / ::std::forward<U>(y));
 
+// NOTE: when dividing by an object of lower rank, pass x
+// as an rvalue to operator/() (see operator*=(), including
+// the remarks about exception safety).
+template <typename T, typename U>
+    requires CvrSeries<T> && (series_rank<remove_cvref_t<U>> < series_rank<remove_cvref_t<T>>)
+constexpr auto operator/=(T &&x, U &&y) OBAKE_SS_FORWARD_FUNCTION(x = ::std::move(x) / ::std::forward<U>(y));
+
 template <typename T, typename U>
     requires(!CvrSeries<T>) && CvrSeries<U>
 constexpr auto operator/=(T &&x, U &&y)
@@ -3683,6 +4254,61 @@ constexpr auto series_default_degree_algorithm_impl()
     }
 }
 
+// Helper to compute the maximum degree of the terms
+// of a nonempty series x via the degree extractor d_extract.
+// R is the degree type. In case of segmented tables, the
+// maximum degrees of the individual tables are computed
+// in parallel.
+template <typename R, typename T, typename F>
+inline R series_max_degree(const T &x, const F &d_extract)
+{
+    assert(!x.empty());
+
+    // Maximum degree in a single table.
+    // NOTE: return an empty optional if
+    // the table is empty.
+    auto table_max = [&d_extract](const auto &tab) {
+        ::std::optional<R> ret;
+
+        for (const auto &t : tab) {
+            R cur(d_extract(t));
+            if (!ret || ::std::as_const(*ret) < ::std::as_const(cur)) {
+                ret = ::std::move(cur);
+            }
+        }
+
+        return ret;
+    };
+
+    const auto &s_table = x._get_s_table();
+
+    if (s_table.size() == 1u) {
+        return *table_max(s_table[0]);
+    }
+
+    ::std::vector<::std::optional<R>> maxs;
+    maxs.resize(::obake::safe_cast<decltype(maxs.size())>(s_table.size()));
+
+    ::tbb::parallel_for(::tbb::blocked_range<decltype(s_table.size())>(0, s_table.size()),
+                        [&s_table, &maxs, &table_max](const auto &range) {
+                            for (auto i = range.begin(); i != range.end(); ++i) {
+                                maxs[static_cast<decltype(maxs.size())>(i)] = table_max(s_table[i]);
+                            }
+                        });
+
+    // Combine the maximum degrees of the tables.
+    // NOTE: at least one table is not empty, as x is not empty.
+    ::std::optional<R> max_deg;
+    for (auto &m : maxs) {
+        if (m && (!max_deg || ::std::as_const(*max_deg) < ::std::as_const(*m))) {
+            max_deg = ::std::move(m);
+        }
+    }
+    assert(max_deg);
+
+    return ::std::move(*max_deg);
+}
+
 struct series_default_degree_impl {
     // A couple of handy shortcuts.
     template <typename T>
@@ -3762,19 +4388,7 @@ struct series_default_degree_impl {
         d_extractor<T &&> d_extract{&x.get_symbol_set()};
 
         // Find the maximum degree.
-        // NOTE: parallelisation opportunities here for
-        // segmented tables.
-        auto it = x.cbegin();
-        const auto end = x.cend();
-        ret_t<T &&> max_deg(d_extract(*it));
-        for (++it; it != end; ++it) {
-            ret_t<T &&> cur(d_extract(*it));
-            if (::std::as_const(max_deg) < ::std::as_const(cur)) {
-                max_deg = ::std::move(cur);
-            }
-        }
-
-        return max_deg;
+        return internal::series_max_degree<ret_t<T &&>>(x, d_extract);
     }
 };
 
@@ -3916,19 +4530,7 @@ struct series_default_p_degree_impl {
         d_extractor<T &&> d_extract{&s, &si, &ss};
 
         // Find the maximum degree.
-        // NOTE: parallelisation opportunities here for
-        // segmented tables.
-        auto it = x.cbegin();
-        const auto end = x.cend();
-        ret_t<T &&> max_deg(d_extract(*it));
-        for (++it; it != end; ++it) {
-            ret_t<T &&> cur(d_extract(*it));
-            if (::std::as_const(max_deg) < ::std::as_const(cur)) {
-                max_deg = ::std::move(cur);
-            }
-        }
-
-        return max_deg;
+        return internal::series_max_degree<ret_t<T &&>>(x, d_extract);
     }
 };
 
@@ -4036,6 +4638,48 @@ struct series_default_evaluate_impl {
     template <typename T, typename U>
     using ret_t = typename decltype(series_default_evaluate_impl::algo_ret<T, U>.second)::type;
 
+    // Helper to accumulate into a value of type R,
+    // via f(ret, tab), the contributions of all the
+    // tables of the series s. The tables of a segmented
+    // series are processed in parallel, each into its own
+    // partial result. The partial results are then added up
+    // serially in table order, so that the result does not
+    // depend on the scheduling (which matters for floating-point
+    // types, where addition is not associative).
+    // NOTE: R must be a semi-regular type constructible from
+    // int and in-place addable with an rvalue.
+    template <typename R, typename S, typename F>
+    static R reduce(const S &s, const F &f)
+    {
+        const auto &s_table = s._get_s_table();
+
+        if (s_table.size() > 1u) {
+            using s_size_t = remove_cvref_t<decltype(s_table.size())>;
+
+            ::std::vector<R> partials;
+            partials.resize(::obake::safe_cast<typename ::std::vector<R>::size_type>(s_table.size()), R(0));
+
+            ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, s_table.size()), [&f, &s_table,
+                                                                                     &partials](const auto &range) {
+                for (auto i = range.begin(); i != range.end(); ++i) {
+                    f(partials[static_cast<typename ::std::vector<R>::size_type>(i)], s_table[i]);
+                }
+            });
+
+            R ret(0);
+            for (auto &p : partials) {
+                ret += ::std::move(p);
+            }
+
+            return ret;
+        } else {
+            R ret(0);
+            f(ret, s_table[0]);
+
+            return ret;
+        }
+    }
+
     // Implementation.
     template <typename T, typename U>
     ret_t<T &&, U> operator()(T &&s_, const symbol_map<U> &sm) const
@@ -4076,20 +4720,23 @@ struct series_default_evaluate_impl {
         // Thus, si must contain the [0, ss.size()) sequence.
         assert(si.empty() || (si.cend() - 1)->first == (ss.size() - 1u));
 
-        // NOTE: parallelisation opportunities here.
-        ret_t<T &&, U> retval(0);
-        for (const auto &tab : s._get_s_table()) {
+        using r_t = ret_t<T &&, U>;
+        using key_eval_t = detail::key_evaluate_t<const series_key_t<remove_cvref_t<T>> &, U>;
+        using cf_eval_t = detail::evaluate_t<const series_cf_t<remove_cvref_t<T>> &, U>;
+
+        return series_default_evaluate_impl::reduce<r_t>(s, [&si, &ss, &sm](r_t &ret, const auto &tab) {
             for (const auto &t : tab) {
                 const auto &k = t.first;
                 const auto &c = t.second;
 
-                // NOTE: there's an opportunity for fma3 here,
-                // but I am not sure it's worth the hassle.
-                retval += ::obake::key_evaluate(k, si, ss) * ::obake::evaluate(c, sm);
+                // NOTE: use the fused multiply-accumulate, if available.
+                if constexpr (is_mult_addable_v<r_t &, key_eval_t, cf_eval_t>) {
+                    ::obake::fma3(ret, ::obake::key_evaluate(k, si, ss), ::obake::evaluate(c, sm));
+                } else {
+                    ret += ::obake::key_evaluate(k, si, ss) * ::obake::evaluate(c, sm);
+                }
             }
-        }
-
-        return retval;
+        });
     }
 };
 
@@ -4145,6 +4792,19 @@ struct series_default_trim_impl {
     template <typename T>
     using ret_t = typename decltype(series_default_trim_impl::algo_ret<T>.second)::type;
 
+    // Helper to trim a coefficient, moving
+    // from it if possible.
+    template <typename T, typename C>
+    static auto trim_cf(C &c)
+    {
+        if constexpr (::std::conjunction_v<is_mutable_rvalue_reference<T &&>, ::std::negation<::std::is_const<C>>,
+                                           is_trimmable<C &&>>) {
+            return ::obake::trim(::std::move(c));
+        } else {
+            return ::obake::trim(::std::as_const(c));
+        }
+    }
+
     // Implementation.
     template <typename T>
     ret_t<T &&> operator()(T &&x_) const
@@ -4153,16 +4813,51 @@ struct series_default_trim_impl {
         static_assert(algo<T &&> != 0);
         static_assert(::std::is_same_v<ret_t<T &&>, remove_cvref_t<T>>);
 
-        // Need only const access to x.
+        // We may end up moving coefficients from x_.
+        // Make sure we will clear it out properly.
+        detail::series_rref_clearer<T> x_c(::std::forward<T>(x_));
+
+        // Need only const access to x in the identification phase.
         const auto &x = ::std::as_const(x_);
 
         // Cache x's original symbol set.
         const auto &ss = x.get_symbol_set();
 
-        // Run trim_identify() on all the keys.
-        ::std::vector<int> trim_v(::obake::safe_cast<::std::vector<int>::size_type>(ss.size()), 1);
-        for (const auto &t : x) {
-            ::obake::key_trim_identify(trim_v, t.first, ss);
+        // Run trim_identify() on all the keys. In the segmented
+        // case, each table is processed independently and
+        // the results are then combined: a symbol can be trimmed
+        // only if it can be trimmed from all the tables.
+        using trim_v_t = ::std::vector<int>;
+        const auto &x_s_table = x._get_s_table();
+        auto table_trim_identify = [&ss](trim_v_t v, const auto &tab) {
+            for (const auto &t : tab) {
+                ::obake::key_trim_identify(v, t.first, ss);
+            }
+
+            return v;
+        };
+        trim_v_t trim_v(::obake::safe_cast<trim_v_t::size_type>(ss.size()), 1);
+        if (x_s_table.size() > 1u) {
+            trim_v = ::tbb::parallel_reduce(
+                ::tbb::blocked_range(x_s_table.begin(), x_s_table.end()), trim_v,
+                [&table_trim_identify](const auto &range, trim_v_t cur) {
+                    for (const auto &tab : range) {
+                        cur = table_trim_identify(::std::move(cur), tab);
+                    }
+
+                    return cur;
+                },
+                [](trim_v_t a, const trim_v_t &b) {
+                    assert(a.size() == b.size());
+
+                    for (decltype(a.size()) i = 0; i < a.size(); ++i) {
+                        a[i] = static_cast<int>(a[i] != 0 && b[i] != 0);
+                    }
+
+                    return a;
+                });
+        } else {
+            trim_v = table_trim_identify(::std::move(trim_v), x_s_table[0]);
         }
 
         // Create the set of symbol indices for trimming,
@@ -4189,27 +4884,52 @@ struct series_default_trim_impl {
         retval.tag() = x.tag();
         // NOTE: use the same number of segments as x
         // and reserve space for the same number of terms.
-        retval.set_n_segments(retval.get_s_size());
+        const auto log2_size = x.get_s_size();
+        retval.set_n_segments(log2_size);
         retval.reserve(x.size());
 
-        for (const auto &t : x) {
-            // NOTE: run all checks on insertion:
-            // - we don't know if something becomes zero after
-            //   trimming,
-            // - we don't know if a key loses compatibility after
-            //   trimming (this is difficult to impose as a runtime
-            //   requirement on key_trim()),
-            // - we don't know if keys are not unique any more after
-            //   trimming (same problem as above),
-            // - we don't know if we are going to go over the table
-            //   size limit (as terms will be shuffled around after
-            //   trimming).
-            // We can always think about removing some checks at
-            // a later stage.
-            // NOTE: in the series_sym_extender() helper, we distinguish
-            // the segmented vs non-segmented case. Perhaps we can do it
-            // here as well in the future, if it makes sense for performance.
-            retval.add_term(::obake::key_trim(t.first, si, ss), ::obake::trim(t.second));
+        // NOTE: if x_ is a mutable rvalue, fetch its mutable
+        // segmented table, so that the coefficients can be moved from.
+        auto &in_s_table = [&x_, &x]() -> auto & {
+            if constexpr (is_mutable_rvalue_reference_v<T &&>) {
+                return x_._get_s_table();
+            } else {
+                return x._get_s_table();
+            }
+        }();
+
+        // NOTE: on insertion, we assume that:
+        // - trimming a nonzero coefficient does not produce zero,
+        // - the trimmed keys are compatible with the new symbol set,
+        // - the trimmed keys are still unique, because we are removing
+        //   only symbols which key_trim_identify() flagged as
+        //   removable from all the keys.
+        // These are runtime requirements on trim(), key_trim()
+        // and key_trim_identify().
+        auto trim_key = [&si, &ss](const auto &k) { return ::obake::key_trim(k, si, ss); };
+
+        if (log2_size) {
+            // NOTE: the trimmed keys may end up in a table
+            // different from the original one, thus we need the
+            // table size check.
+            detail::series_segmented_rebuild(retval, in_s_table, log2_size, trim_key,
+                                             [&retval](auto &out_table, auto &&k, auto &c) {
+                                                 detail::series_add_term_table<
+                                                     true, detail::sat_check_zero::off,
+                                                     detail::sat_check_compat_key::off,
+                                                     detail::sat_check_table_size::on,
+                                                     detail::sat_assume_unique::on>(
+                                                     retval, out_table, ::std::move(k),
+                                                     series_default_trim_impl::trim_cf<T>(c));
+                                             });
+        } else {
+            auto &out_table = retval._get_s_table()[0];
+
+            for (auto &t : in_s_table[0]) {
+                detail::series_add_term_table<true, detail::sat_check_zero::off, detail::sat_check_compat_key::off,
+                                              detail::sat_check_table_size::off, detail::sat_assume_unique::on>(
+                    retval, out_table, trim_key(t.first), series_default_trim_impl::trim_cf<T>(t.second));
+            }
         }
 
         return retval;
@@ -4232,9 +4952,6 @@ template <typename F, typename K, typename C, typename Tag>
 using term_filter_return_t
     = decltype(::std::declval<const F &>()(::std::declval<const series_term_t<series<K, C, Tag>> &>()));
 
-// NOTE: for now, pass the series with a const reference. In the future,
-// we may want to allow for perfect forwarding to exploit move-construction
-// of the coefficients, as done elsewhere (see rref cleaner).
 template <typename K, typename C, typename Tag, typename F,
           ::std::enable_if_t<::std::is_convertible_v<detected_t<term_filter_return_t, F, K, C, Tag>, bool>, int> = 0>
 inline series<K, C, Tag> filtered_impl(const series<K, C, Tag> &s, const F &f)
@@ -4246,13 +4963,16 @@ inline series<K, C, Tag> filtered_impl(const series<K, C, Tag> &s, const F &f)
     retval.tag() = s.tag();
     retval.set_n_segments(s.get_s_size());
 
-    // Do the filtering table by table.
-    // NOTE: this can easily be parallelised.
-    const auto n_tables = s._get_s_table().size();
-    for (decltype(s._get_s_table().size()) table_idx = 0; table_idx < n_tables; ++table_idx) {
+    // NOTE: fetch the segmented tables outside
+    // the (possibly parallel) filtering loop.
+    const auto &in_s_table = s._get_s_table();
+    auto &out_s_table = retval._get_s_table();
+
+    // Filter a single table.
+    auto filter_table = [&in_s_table, &out_s_table, &f](auto table_idx) {
         // Fetch references to the input/output tables.
-        const auto &in_table = s._get_s_table()[table_idx];
-        auto &out_table = retval._get_s_table()[table_idx];
+        const auto &in_table = in_s_table[table_idx];
+        auto &out_table = out_s_table[table_idx];
 
         for (const auto &t : in_table) {
             if (f(t)) {
@@ -4262,29 +4982,36 @@ inline series<K, C, Tag> filtered_impl(const series<K, C, Tag> &s, const F &f)
                 assert(res.second);
             }
         }
+    };
+
+    // Do the filtering table by table.
+    const auto n_tables = in_s_table.size();
+    if (n_tables > 1u) {
+        // NOTE: the tables are independent from each other,
+        // thus they can be filtered in parallel.
+        ::tbb::parallel_for(::tbb::blocked_range<decltype(in_s_table.size())>(0, n_tables),
+                            [&filter_table](const auto &range) {
+                                for (auto table_idx = range.begin(); table_idx != range.end(); ++table_idx) {
+                                    filter_table(table_idx);
+                                }
+                            });
+    } else {
+        filter_table(decltype(in_s_table.size())(0));
     }
 
     return retval;
 }
 
-} // namespace detail
-
-// NOTE: do we need a concept/type trait for this? See also the testing.
-// NOTE: force const reference passing for f as a hint
-// that the implementation may be parallel.
-inline constexpr auto filtered =
-    [](auto &&s, const auto &f) OBAKE_SS_FORWARD_LAMBDA(detail::filtered_impl(::std::forward<decltype(s)>(s), f));
-
-namespace detail
-{
-
 template <typename K, typename C, typename Tag, typename F,
           ::std::enable_if_t<::std::is_convertible_v<detected_t<term_filter_return_t, F, K, C, Tag>, bool>, int> = 0>
-inline void filter_impl(series<K, C, Tag> &s, const F &f)
+inline typename series<K, C, Tag>::size_type filter_impl(series<K, C, Tag> &s, const F &f)
 {
-    // Do the filtering table by table.
-    // NOTE: this can easily be parallelised.
-    for (auto &table : s._get_s_table()) {
+    using size_type = typename series<K, C, Tag>::size_type;
+
+    // Filter a single table, returning the
+    // number of terms removed.
+    auto filter_table = [&f](auto &table) {
+        const auto orig_size = table.size();
         const auto it_f = table.end();
 
         for (auto it = table.begin(); it != it_f;) {
@@ -4298,16 +5025,56 @@ inline void filter_impl(series<K, C, Tag> &s, const F &f)
                 table.erase(it++);
             }
         }
+
+        return static_cast<size_type>(orig_size - table.size());
+    };
+
+    // Do the filtering table by table.
+    // NOTE: if f throws, s will be left in a valid
+    // state with an unspecified subset of its terms.
+    auto &s_table = s._get_s_table();
+    if (s_table.size() > 1u) {
+        // NOTE: this will never overflow, as the total
+        // number of terms in a series is representable by size_type.
+        return ::tbb::parallel_reduce(
+            ::tbb::blocked_range(s_table.begin(), s_table.end()), size_type(0),
+            [&filter_table](const auto &range, size_type cur) {
+                for (auto &tab : range) {
+                    cur += filter_table(tab);
+                }
+                return cur;
+            },
+            [](size_type a, size_type b) { return a + b; });
+    } else {
+        return filter_table(s_table[0]);
     }
 }
 
+// Overload for rvalue series: filter in-place
+// and then move the result out, so that the
+// surviving terms are never copied.
+template <typename K, typename C, typename Tag, typename F,
+          ::std::enable_if_t<::std::is_convertible_v<detected_t<term_filter_return_t, F, K, C, Tag>, bool>, int> = 0>
+inline series<K, C, Tag> filtered_impl(series<K, C, Tag> &&s, const F &f)
+{
+    detail::filter_impl(s, f);
+
+    return ::std::move(s);
+}
+
 } // namespace detail
 
 // NOTE: do we need a concept/type trait for this? See also the testing.
 // NOTE: force const reference passing for f as a hint
 // that the implementation may be parallel.
-// NOTE: perhaps we could eventually change the implementation
-// to return a reference to s.
+inline constexpr auto filtered =
+    [](auto &&s, const auto &f) OBAKE_SS_FORWARD_LAMBDA(detail::filtered_impl(::std::forward<decltype(s)>(s), f));
+
+// NOTE: do we need a concept/type trait for this? See also the testing.
+// NOTE: force const reference passing for f as a hint
+// that the implementation may be parallel.
+// NOTE: filter() returns the number of terms
+// removed from the series.
 inline constexpr auto filter =
     [](auto &&s, const auto &f) OBAKE_SS_FORWARD_LAMBDA(detail::filter_impl(::std::forward<decltype(s)>(s), f));
 
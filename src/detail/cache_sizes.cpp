@@ -0,0 +1,166 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cctype>
+#include <fstream>
+#include <string>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+
+#include <cpuid.h>
+
+#define OBAKE_DETAIL_HAVE_CPUID
+
+#endif
+
+#include <obake/detail/cache_sizes.hpp>
+
+namespace obake::detail
+{
+
+namespace
+{
+
+// Read the first line of the file at path into out.
+// Returns false on failure.
+bool cache_sizes_read_line(const ::std::string &path, ::std::string &out)
+{
+    ::std::ifstream f(path);
+
+    return static_cast<bool>(::std::getline(f, out));
+}
+
+// Parse a cache size string in the format used by sysfs
+// (e.g., "32K", "8192K", "16M"). Returns zero on failure.
+unsigned long cache_sizes_parse_size(const ::std::string &str)
+{
+    unsigned long retval = 0;
+    auto it = str.begin();
+    for (; it != str.end() && ::std::isdigit(static_cast<unsigned char>(*it)); ++it) {
+        retval = retval * 10u + static_cast<unsigned long>(*it - '0');
+    }
+
+    if (it != str.end()) {
+        switch (*it) {
+            case 'K':
+                retval *= 1024ul;
+                break;
+            case 'M':
+                retval *= 1024ul * 1024ul;
+                break;
+            case 'G':
+                retval *= 1024ul * 1024ul * 1024ul;
+                break;
+            default:
+                retval = 0;
+        }
+    }
+
+    return retval;
+}
+
+// Detect the cache sizes via the sysfs interface
+// of the Linux kernel. The caches of the first CPU
+// are assumed to be representative of the whole system.
+void cache_sizes_sysfs(cache_sizes &cs)
+{
+    // NOTE: there are typically no more than 4-5 entries
+    // (L1 data, L1 instruction, L2, L3 and perhaps L4).
+    for (auto i = 0; i < 16; ++i) {
+        const auto base = "/sys/devices/system/cpu/cpu0/cache/index" + ::std::to_string(i) + "/";
+
+        ::std::string level, type, size;
+        if (!cache_sizes_read_line(base + "level", level)) {
+            // No more caches.
+            break;
+        }
+        if (!cache_sizes_read_line(base + "type", type) || !cache_sizes_read_line(base + "size", size)
+            || type == "Instruction") {
+            continue;
+        }
+
+        const auto s = cache_sizes_parse_size(size);
+        if (level == "1") {
+            cs.l1d = s;
+        } else if (level == "2") {
+            cs.l2 = s;
+        } else if (level == "3") {
+            cs.l3 = s;
+        }
+    }
+}
+
+#if defined(OBAKE_DETAIL_HAVE_CPUID)
+
+// Detect the cache sizes via the deterministic
+// cache parameters leaf of cpuid (leaf 4). Only the
+// sizes which are still unknown will be filled in.
+void cache_sizes_cpuid(cache_sizes &cs)
+{
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx) || eax < 4u) {
+        // Leaf 4 is not supported.
+        return;
+    }
+
+    for (unsigned i = 0; i < 16u; ++i) {
+        __cpuid_count(4, i, eax, ebx, ecx, edx);
+
+        // Cache type: 0 means no more caches,
+        // 2 is an instruction cache.
+        const auto type = eax & 0x1fu;
+        if (type == 0u) {
+            break;
+        }
+        if (type == 2u) {
+            continue;
+        }
+
+        const auto level = (eax >> 5) & 0x7u;
+        // size = ways * partitions * line size * sets.
+        const auto s = static_cast<unsigned long>((ebx >> 22) + 1u)
+                       * static_cast<unsigned long>(((ebx >> 12) & 0x3ffu) + 1u)
+                       * static_cast<unsigned long>((ebx & 0xfffu) + 1u) * (static_cast<unsigned long>(ecx) + 1u);
+
+        if (level == 1u && cs.l1d == 0u) {
+            cs.l1d = s;
+        } else if (level == 2u && cs.l2 == 0u) {
+            cs.l2 = s;
+        } else if (level == 3u && cs.l3 == 0u) {
+            cs.l3 = s;
+        }
+    }
+}
+
+#endif
+
+} // namespace
+
+// Return the cache sizes of the system, as
+// detected at runtime.
+const cache_sizes &get_cache_sizes()
+{
+    // NOTE: the detection is done only once,
+    // in a thread-safe manner.
+    static const cache_sizes retval = []() {
+        cache_sizes cs;
+
+        cache_sizes_sysfs(cs);
+#if defined(OBAKE_DETAIL_HAVE_CPUID)
+        cache_sizes_cpuid(cs);
+#endif
+
+        return cs;
+    }();
+
+    return retval;
+}
+
+} // namespace obake::detail
+
+#undef OBAKE_DETAIL_HAVE_CPUID
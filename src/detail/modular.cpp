@@ -0,0 +1,109 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include <obake/detail/abseil.hpp>
+#include <obake/detail/modular.hpp>
+
+namespace obake::detail
+{
+
+namespace
+{
+
+::std::uint64_t mulmod_u64(::std::uint64_t a, ::std::uint64_t b, ::std::uint64_t n)
+{
+    return static_cast<::std::uint64_t>((::absl::uint128(a) * b) % n);
+}
+
+::std::uint64_t powmod_u64(::std::uint64_t a, ::std::uint64_t e, ::std::uint64_t n)
+{
+    ::std::uint64_t retval = 1;
+
+    a %= n;
+    while (e != 0u) {
+        if (e % 2u == 1u) {
+            retval = mulmod_u64(retval, a, n);
+        }
+        a = mulmod_u64(a, a, n);
+        e /= 2u;
+    }
+
+    return retval;
+}
+
+} // namespace
+
+bool is_prime_u64(::std::uint64_t n)
+{
+    if (n < 2u) {
+        return false;
+    }
+
+    // Trial division by a few small primes.
+    for (::std::uint64_t p : {2u, 3u, 5u, 7u, 11u, 13u, 17u, 19u, 23u, 29u, 31u, 37u}) {
+        if (n % p == 0u) {
+            return n == p;
+        }
+    }
+
+    // Miller-Rabin. Write n - 1 as d * 2**s, with d odd.
+    auto d = n - 1u;
+    unsigned s = 0;
+    while (d % 2u == 0u) {
+        d /= 2u;
+        ++s;
+    }
+
+    // NOTE: testing against the first 12 primes as bases
+    // is deterministic for all 64-bit integers.
+    for (::std::uint64_t a : {2u, 3u, 5u, 7u, 11u, 13u, 17u, 19u, 23u, 29u, 31u, 37u}) {
+        auto x = powmod_u64(a, d, n);
+        if (x == 1u || x == n - 1u) {
+            continue;
+        }
+
+        bool composite = true;
+        for (unsigned r = 1; r < s; ++r) {
+            x = mulmod_u64(x, x, n);
+            if (x == n - 1u) {
+                composite = false;
+                break;
+            }
+        }
+
+        if (composite) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const ::std::vector<::std::uint64_t> &modular_primes()
+{
+    static const ::std::vector<::std::uint64_t> retval = []() {
+        ::std::vector<::std::uint64_t> ret;
+        ret.reserve(modular_primes_size);
+
+        for (auto n = (::std::uint64_t(1) << 62) - 1u; ret.size() < modular_primes_size; n -= 2u) {
+            if (detail::is_prime_u64(n)) {
+                ret.push_back(n);
+            }
+        }
+
+        return ret;
+    }();
+
+    return retval;
+}
+
+} // namespace obake::detail
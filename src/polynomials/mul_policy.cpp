@@ -0,0 +1,215 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+
+#include <obake/config.hpp>
+#include <obake/detail/cache_sizes.hpp>
+#include <obake/detail/to_string.hpp>
+#include <obake/exceptions.hpp>
+#include <obake/polynomials/mul_policy.hpp>
+
+namespace obake::polynomials
+{
+
+namespace detail
+{
+
+namespace
+{
+
+// Check the validity of a multiplication policy.
+void mul_policy_check(const mul_policy &p)
+{
+    if (obake_unlikely(p.sparse_seg_size == 0u || p.dense_seg_size == 0u)) {
+        obake_throw(::std::invalid_argument,
+                    "Invalid multiplication policy: the segment sizes must be nonzero, but a sparse segment size of "
+                        + ::obake::detail::to_string(p.sparse_seg_size) + " and a dense segment size of "
+                        + ::obake::detail::to_string(p.dense_seg_size) + " were specified instead");
+    }
+
+    // NOTE: infinite thresholds are fine, they
+    // can be used to force a specific behaviour.
+    if (obake_unlikely(::std::isnan(p.sp_threshold) || p.sp_threshold < 0 || ::std::isnan(p.dense_sp_threshold)
+                       || p.dense_sp_threshold < 0)) {
+        obake_throw(::std::invalid_argument,
+                    "Invalid multiplication policy: the sparsity thresholds must be non-negative, but a sparsity "
+                    "threshold of "
+                        + ::obake::detail::to_string(p.sp_threshold) + " and a dense sparsity threshold of "
+                        + ::obake::detail::to_string(p.dense_sp_threshold) + " were specified instead");
+    }
+
+    if (obake_unlikely(p.dense_max_box_ratio == 0u || p.dense_chunk_size == 0u)) {
+        obake_throw(::std::invalid_argument,
+                    "Invalid multiplication policy: the maximum box ratio and the chunk size of the dense "
+                    "multiplication algorithm must be nonzero, but values of "
+                        + ::obake::detail::to_string(p.dense_max_box_ratio) + " and "
+                        + ::obake::detail::to_string(p.dense_chunk_size) + " were specified instead");
+    }
+
+    if (obake_unlikely(!::std::isfinite(p.fft_tolerance) || p.fft_tolerance < 0)) {
+        obake_throw(::std::invalid_argument,
+                    "Invalid multiplication policy: the tolerance of the FFT algorithm must be finite and "
+                    "non-negative, but a value of "
+                        + ::obake::detail::to_string(p.fft_tolerance) + " was specified instead");
+    }
+}
+
+// The global multiplication policy.
+// NOTE: the policy is read at the beginning of every polynomial
+// multiplication (including the multiplications of the coefficients
+// performed in parallel from within other multiplications), and it is
+// modified very rarely. Hence, each thread keeps a snapshot of the policy,
+// which is refreshed only when the version number (which is
+// bumped at every modification) changes. This way, the mutex is
+// locked only after modifications of the global policy.
+struct global_mul_policy {
+    mul_policy policy;
+    ::std::mutex mutex;
+    ::std::atomic<unsigned long long> version{0};
+};
+
+// On-demand instantiation of the global multiplication policy.
+global_mul_policy &get_global_mul_policy()
+{
+    static global_mul_policy retval;
+    return retval;
+}
+
+// The snapshot of the global multiplication policy
+// in the current thread, and its version number.
+// NOTE: the global policy is initially the default-constructed
+// one, which the initial snapshot is thus consistent with.
+thread_local mul_policy tl_mul_policy_snapshot;
+thread_local unsigned long long tl_mul_policy_version = 0;
+
+// The multiplication policy set by the innermost
+// mul_policy_guard in the current thread (null
+// if no guard is active).
+thread_local const mul_policy *tl_mul_policy = nullptr;
+
+} // namespace
+
+} // namespace detail
+
+mul_policy cache_mul_policy()
+{
+    return polynomials::cache_mul_policy(::obake::detail::get_cache_sizes());
+}
+
+mul_policy cache_mul_policy(const ::obake::detail::cache_sizes &cs)
+{
+    mul_policy retval;
+
+    // NOTE: the historical values (which are used if the cache
+    // sizes cannot be detected) were tuned on a machine
+    // with a 32KB L1 data cache and a 256KB L2 cache. Thus:
+    //
+    // - for sparse products we pick a segment size
+    //   which fits in L2 (with some headroom for the
+    //   table metadata and the input terms),
+    // - for the other products we aim at staying
+    //   in L1 cache instead,
+    // - for the dense multiplication algorithm, we want
+    //   the accumulation chunks to fit in L2 cache.
+    if (cs.l1d != 0u) {
+        retval.dense_seg_size = (cs.l1d / 8u) * 5u;
+    }
+    if (cs.l2 != 0u) {
+        retval.sparse_seg_size = (cs.l2 / 32u) * 25u;
+        retval.dense_chunk_size = cs.l2;
+    }
+
+    // NOTE: guard against weird values.
+    if (retval.dense_seg_size == 0u) {
+        retval.dense_seg_size = mul_policy{}.dense_seg_size;
+    }
+    if (retval.sparse_seg_size == 0u) {
+        retval.sparse_seg_size = mul_policy{}.sparse_seg_size;
+    }
+
+    return retval;
+}
+
+mul_policy get_mul_policy()
+{
+    if (detail::tl_mul_policy != nullptr) {
+        return *detail::tl_mul_policy;
+    }
+
+    auto &g = detail::get_global_mul_policy();
+
+    if (obake_unlikely(g.version.load(::std::memory_order_acquire) != detail::tl_mul_policy_version)) {
+        // The global policy was modified since the
+        // last snapshot, refresh it.
+        ::std::lock_guard lock(g.mutex);
+
+        detail::tl_mul_policy_snapshot = g.policy;
+        detail::tl_mul_policy_version = g.version.load(::std::memory_order_relaxed);
+    }
+
+    return detail::tl_mul_policy_snapshot;
+}
+
+mul_policy_info get_mul_policy_info()
+{
+    return mul_policy_info{::obake::detail::get_cache_sizes(), polynomials::get_mul_policy()};
+}
+
+void set_mul_policy(const mul_policy &p)
+{
+    detail::mul_policy_check(p);
+
+    auto &g = detail::get_global_mul_policy();
+
+    ::std::lock_guard lock(g.mutex);
+
+    g.policy = p;
+    g.version.fetch_add(1, ::std::memory_order_release);
+}
+
+void reset_mul_policy()
+{
+    polynomials::set_mul_policy(mul_policy{});
+}
+
+mul_policy_guard::mul_policy_guard(const mul_policy &p) : m_policy(p), m_prev(detail::tl_mul_policy)
+{
+    detail::mul_policy_check(m_policy);
+
+    detail::tl_mul_policy = &m_policy;
+}
+
+mul_policy_guard::~mul_policy_guard()
+{
+    detail::tl_mul_policy = m_prev;
+}
+
+::std::ostream &operator<<(::std::ostream &os, const mul_policy &p)
+{
+    os << "Sparse segment size: " << p.sparse_seg_size << " bytes\n";
+    os << "Dense segment size: " << p.dense_seg_size << " bytes\n";
+    os << "Sparsity threshold: " << p.sp_threshold << '\n';
+    os << "Dense algorithm sparsity threshold: " << p.dense_sp_threshold << '\n';
+    os << "Dense algorithm max box ratio: " << p.dense_max_box_ratio << '\n';
+    os << "Dense algorithm chunk size: " << p.dense_chunk_size << " bytes\n";
+    os << "Heap algorithm max size: " << p.heap_max_size << '\n';
+    os << "Heap algorithm min size: " << p.heap_min_size << '\n';
+    os << "Heap algorithm min ratio: " << p.heap_min_ratio << '\n';
+    os << "Kronecker algorithm min size: " << p.kronecker_min_size << '\n';
+    os << "FFT algorithm min size: " << p.fft_min_size << '\n';
+    os << "FFT algorithm tolerance: " << p.fft_tolerance;
+
+    return os;
+}
+
+} // namespace obake::polynomials
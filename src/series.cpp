@@ -6,10 +6,19 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
-#include <functional>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <tuple>
+#include <typeindex>
+#include <unordered_map>
 
 #include <obake/series.hpp>
 
@@ -60,24 +69,256 @@ void series_stream_single_term(::std::string &ret, ::std::string &str_cf, const
 namespace customisation::internal
 {
 
-// On-demand instantiation of the global
-// objects used to implement the pow map.
-::std::tuple<series_pow_map_t &, ::std::mutex &> get_series_pow_map()
+namespace
 {
-    static series_pow_map_t retval;
-    static ::std::mutex mutex;
-    return ::std::make_tuple(::std::ref(retval), ::std::ref(mutex));
+
+// The number of shards in the global series pow cache.
+constexpr ::std::size_t series_pow_cache_n_shards = 16;
+
+// The default memory budget of the global series pow cache (1GB).
+constexpr ::std::size_t series_pow_cache_default_max_bytes = ::std::size_t(1) << 30;
+
+// A shard of the global series pow cache.
+struct series_pow_cache_shard {
+    using lru_t = ::std::list<::std::shared_ptr<series_pow_cache_entry>>;
+
+    ::std::mutex mutex;
+    // The entries, from the most recently used
+    // to the least recently used.
+    lru_t lru;
+    // The hashes of the bases, mapped to the
+    // positions of the entries in lru.
+    ::std::unordered_multimap<::std::size_t, lru_t::iterator> map;
+};
+
+// The global series pow cache.
+// NOTE: the entries are distributed among the shards according
+// to the hashes of the bases, so that lookups for different bases
+// contend on different locks. The memory budget, on the other hand,
+// applies to the cache as a whole: the time of the last use of each entry
+// is recorded via a global counter, so that the least recently used entry
+// of the whole cache is the least recently used entry of one of the shards.
+struct series_pow_cache_data {
+    ::std::array<series_pow_cache_shard, series_pow_cache_n_shards> shards;
+    ::std::atomic<::std::size_t> max_bytes{series_pow_cache_default_max_bytes};
+    // The memory footprint of the entries.
+    ::std::atomic<::std::size_t> n_bytes{0};
+    // The counter used to timestamp the uses of the entries.
+    ::std::atomic<unsigned long long> clock{0};
+    // The mutex serialising the evictions.
+    ::std::mutex evict_mutex;
+    ::std::atomic<unsigned long long> hits{0}, misses{0}, evictions{0};
+};
+
+// On-demand instantiation of the global series pow cache.
+series_pow_cache_data &get_series_pow_cache_data()
+{
+    static series_pow_cache_data retval;
+    return retval;
+}
+
+series_pow_cache_shard &series_pow_cache_get_shard(series_pow_cache_data &d, ::std::size_t h)
+{
+    return d.shards[h % series_pow_cache_n_shards];
+}
+
+// Evict the least recently used entry of the shard s.
+// NOTE: this must be called with the shard's mutex held,
+// and the shard must not be empty.
+void series_pow_cache_evict_lru(series_pow_cache_data &d, series_pow_cache_shard &s)
+{
+    assert(!s.lru.empty());
+
+    const auto it = ::std::prev(s.lru.end());
+    auto &e = **it;
+
+    // Remove the entry from the map.
+    const auto [m_begin, m_end] = s.map.equal_range(e.hash);
+    const auto m_it = ::std::find_if(m_begin, m_end, [&it](const auto &p) { return p.second == it; });
+    assert(m_it != m_end);
+    s.map.erase(m_it);
+
+    // Update the bookkeeping data.
+    assert(d.n_bytes.load(::std::memory_order_relaxed) >= e.n_bytes);
+    d.n_bytes.fetch_sub(e.n_bytes, ::std::memory_order_relaxed);
+    e.cached = false;
+
+    // NOTE: the entry will be destroyed when the
+    // last user (if any) releases it.
+    s.lru.erase(it);
+
+    d.evictions.fetch_add(1, ::std::memory_order_relaxed);
+}
+
+// Evict the least recently used entries of the cache
+// until the memory budget of the cache is respected.
+// NOTE: this must be called without holding
+// any shard's mutex.
+void series_pow_cache_evict(series_pow_cache_data &d)
+{
+    // NOTE: serialise the evictions, so that concurrent
+    // evictions do not remove more entries than necessary.
+    ::std::lock_guard e_lock(d.evict_mutex);
+
+    while (d.n_bytes.load(::std::memory_order_relaxed) > d.max_bytes.load(::std::memory_order_relaxed)) {
+        // Locate the shard containing the least
+        // recently used entry of the cache.
+        series_pow_cache_shard *lru_s = nullptr;
+        auto lru_time = ::std::numeric_limits<unsigned long long>::max();
+        for (auto &s : d.shards) {
+            ::std::lock_guard lock(s.mutex);
+
+            if (!s.lru.empty() && s.lru.back()->last_use <= lru_time) {
+                lru_s = &s;
+                lru_time = s.lru.back()->last_use;
+            }
+        }
+
+        if (lru_s == nullptr) {
+            // The cache is empty.
+            break;
+        }
+
+        ::std::lock_guard lock(lru_s->mutex);
+
+        // NOTE: the shard may have been modified after we
+        // released its mutex (e.g., its least recently used entry
+        // may have been used again). In such a case, we just evict
+        // the current least recently used entry of the shard.
+        if (!lru_s->lru.empty()) {
+            series_pow_cache_evict_lru(d, *lru_s);
+        }
+    }
+}
+
+} // namespace
+
+::std::shared_ptr<series_pow_cache_entry> series_pow_cache_lookup(const ::std::type_index &t_idx, ::std::size_t h,
+                                                                  const void *ptr, series_pow_cache_eq_t eq,
+                                                                  series_pow_cache_copy_t copy)
+{
+    auto &d = get_series_pow_cache_data();
+
+    // Mix the type into the hash.
+    h ^= t_idx.hash_code() + ::std::size_t(0x9e3779b9ul) + (h << 6) + (h >> 2);
+
+    auto &s = series_pow_cache_get_shard(d, h);
+
+    ::std::lock_guard lock(s.mutex);
+
+    const auto [m_begin, m_end] = s.map.equal_range(h);
+    for (auto m_it = m_begin; m_it != m_end; ++m_it) {
+        const auto it = m_it->second;
+
+        if ((*it)->t_idx == t_idx && eq((*it)->base, ptr)) {
+            // Move the entry to the front of the LRU list.
+            // NOTE: splice() does not invalidate the iterators.
+            s.lru.splice(s.lru.begin(), s.lru, it);
+            // NOTE: the timestamps are fetched with the shard's
+            // mutex held, so that they are decreasing along the LRU list.
+            (*it)->last_use = d.clock.fetch_add(1, ::std::memory_order_relaxed);
+
+            return *it;
+        }
+    }
+
+    if (copy == nullptr) {
+        return {};
+    }
+
+    s.lru.push_front(::std::make_shared<series_pow_cache_entry>(t_idx, h, copy(ptr)));
+    try {
+        s.map.emplace(h, s.lru.begin());
+    } catch (...) {
+        // LCOV_EXCL_START
+        s.lru.pop_front();
+        throw;
+        // LCOV_EXCL_STOP
+    }
+    s.lru.front()->last_use = d.clock.fetch_add(1, ::std::memory_order_relaxed);
+
+    return s.lru.front();
+}
+
+void series_pow_cache_account(const ::std::shared_ptr<series_pow_cache_entry> &e, ::std::size_t n)
+{
+    auto &d = get_series_pow_cache_data();
+
+    {
+        auto &s = series_pow_cache_get_shard(d, e->hash);
+
+        ::std::lock_guard lock(s.mutex);
+
+        if (!e->cached) {
+            // The entry was evicted in the meantime.
+            return;
+        }
+
+        e->n_bytes += n;
+        d.n_bytes.fetch_add(n, ::std::memory_order_relaxed);
+    }
+
+    series_pow_cache_evict(d);
+}
+
+void series_pow_cache_record(bool hit)
+{
+    auto &d = get_series_pow_cache_data();
+
+    (hit ? d.hits : d.misses).fetch_add(1, ::std::memory_order_relaxed);
+}
+
+series_pow_cache_stats get_series_pow_cache_stats()
+{
+    auto &d = get_series_pow_cache_data();
+
+    series_pow_cache_stats retval;
+    retval.hits = d.hits.load(::std::memory_order_relaxed);
+    retval.misses = d.misses.load(::std::memory_order_relaxed);
+    retval.evictions = d.evictions.load(::std::memory_order_relaxed);
+    retval.max_bytes = d.max_bytes.load(::std::memory_order_relaxed);
+    retval.n_bytes = d.n_bytes.load(::std::memory_order_relaxed);
+
+    for (auto &s : d.shards) {
+        ::std::lock_guard lock(s.mutex);
+
+        retval.n_entries += s.lru.size();
+    }
+
+    return retval;
+}
+
+::std::size_t get_series_pow_cache_max_bytes()
+{
+    return get_series_pow_cache_data().max_bytes.load(::std::memory_order_relaxed);
+}
+
+void set_series_pow_cache_max_bytes(::std::size_t n)
+{
+    auto &d = get_series_pow_cache_data();
+
+    d.max_bytes.store(n, ::std::memory_order_relaxed);
+
+    // Enforce the new budget.
+    series_pow_cache_evict(d);
 }
 
 void clear_series_pow_map()
 {
-    // Fetch the global data.
-    auto [map, mutex] = internal::get_series_pow_map();
+    auto &d = get_series_pow_cache_data();
 
-    // Lock down before accessing the cache.
-    ::std::lock_guard lock(mutex);
+    for (auto &s : d.shards) {
+        // Lock down before accessing the shard.
+        ::std::lock_guard lock(s.mutex);
 
-    map.clear();
+        for (auto &e : s.lru) {
+            d.n_bytes.fetch_sub(e->n_bytes, ::std::memory_order_relaxed);
+            e->cached = false;
+        }
+
+        s.map.clear();
+        s.lru.clear();
+    }
 }
 
 } // namespace customisation::internal
@@ -0,0 +1,107 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdint>
+#include <random>
+
+#include <mp++/integer.hpp>
+
+#include <obake/detail/modular.hpp>
+
+#include "catch.hpp"
+
+using namespace obake;
+
+using int_t = mppp::integer<1>;
+
+TEST_CASE("is_prime_u64_test")
+{
+    REQUIRE(!detail::is_prime_u64(0));
+    REQUIRE(!detail::is_prime_u64(1));
+    REQUIRE(detail::is_prime_u64(2));
+    REQUIRE(detail::is_prime_u64(3));
+    REQUIRE(!detail::is_prime_u64(4));
+    REQUIRE(detail::is_prime_u64(37));
+    REQUIRE(!detail::is_prime_u64(41u * 43u));
+    REQUIRE(detail::is_prime_u64(1000000007ull));
+    REQUIRE(detail::is_prime_u64(18446744073709551557ull));
+    REQUIRE(!detail::is_prime_u64(18446744073709551615ull));
+    // Strong pseudoprimes to several bases.
+    REQUIRE(!detail::is_prime_u64(3215031751ull));
+    REQUIRE(!detail::is_prime_u64(3825123056546413051ull));
+
+    // Check against trial division for small values.
+    for (std::uint64_t n = 0; n < 2000u; ++n) {
+        bool prime = n >= 2u;
+        for (std::uint64_t d = 2; d * d <= n; ++d) {
+            if (n % d == 0u) {
+                prime = false;
+                break;
+            }
+        }
+
+        REQUIRE(detail::is_prime_u64(n) == prime);
+    }
+}
+
+TEST_CASE("modular_primes_test")
+{
+    const auto &primes = detail::modular_primes();
+
+    REQUIRE(primes.size() == detail::modular_primes_size);
+    REQUIRE(&primes == &detail::modular_primes());
+
+    for (decltype(primes.size()) i = 0; i < primes.size(); ++i) {
+        REQUIRE(primes[i] < (std::uint64_t(1) << 62));
+        REQUIRE(primes[i] > (std::uint64_t(1) << 61));
+        REQUIRE(detail::is_prime_u64(primes[i]));
+
+        if (i > 0u) {
+            REQUIRE(primes[i] < primes[i - 1u]);
+
+            // Check that no prime was skipped.
+            for (auto n = primes[i] + 2u; n < primes[i - 1u]; n += 2u) {
+                REQUIRE(!detail::is_prime_u64(n));
+            }
+        }
+    }
+}
+
+TEST_CASE("montgomery_modulus_test")
+{
+    std::mt19937_64 rng(42);
+
+    for (auto p : {std::uint64_t(3), std::uint64_t(1000000007ull), detail::modular_primes()[0],
+                   detail::modular_primes()[detail::modular_primes_size - 1u]}) {
+        const detail::montgomery_modulus mm(p);
+        REQUIRE(mm.get_p() == p);
+
+        for (auto i = 0; i < 1000; ++i) {
+            const auto a = rng() % p, b = rng() % p;
+
+            const auto am = mm.to_mont(a), bm = mm.to_mont(b);
+            REQUIRE(am < p);
+            REQUIRE(mm.from_mont(am) == a);
+
+            // The Montgomery product of a number in Montgomery
+            // representation and a number in standard representation
+            // yields the product in standard representation.
+            const auto prod = mm.mul(am, b);
+            REQUIRE(prod < p);
+            REQUIRE(int_t{prod} == int_t{a} * b % p);
+            REQUIRE(mm.from_mont(mm.mul(am, bm)) == prod);
+
+            REQUIRE(int_t{mm.add(a, b)} == (int_t{a} + b) % p);
+            REQUIRE(int_t{mm.sub(a, b)} == ((int_t{a} - b) % p + p) % p);
+
+            if (a != 0u) {
+                REQUIRE(int_t{mm.inv(a)} * a % p == 1);
+            }
+        }
+    }
+}
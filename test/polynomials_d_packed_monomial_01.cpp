@@ -20,6 +20,7 @@
 #include <mp++/rational.hpp>
 
 #include <obake/config.hpp>
+#include <obake/detail/limits.hpp>
 #include <obake/detail/tuple_for_each.hpp>
 #include <obake/hash.hpp>
 #include <obake/key/key_degree.hpp>
@@ -329,6 +330,73 @@ TEST_CASE("degree_test")
                     REQUIRE(key_degree(pm_t{-1, 2}, symbol_set{"x", "y"}) == int_t(1));
                     REQUIRE(key_degree(pm_t{-2, 5}, symbol_set{"x", "y"}) == int_t(3));
                 }
+
+                // Many variables, with the last packed word
+                // only partially filled.
+                REQUIRE(key_degree(pm_t{1, 2, 3, 4, 5, 6, 7, 8, 9, 10},
+                                   symbol_set{"a", "b", "c", "d", "e", "f", "g", "h", "i", "j"})
+                        == int_t(55));
+
+                if constexpr (is_signed_v<int_t>) {
+                    REQUIRE(key_degree(pm_t{1, -2, 3, -4, 5, -6, 7, -8, 9, -10, 11},
+                                       symbol_set{"a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k"})
+                            == int_t(6));
+                }
+            }
+
+            if constexpr (bw > 1u) {
+                // Many symbols, all with the maximum (or minimum)
+                // exponent allowed by the packing. For small numbers
+                // of symbols, this exercises the unchecked summation.
+                const auto lim = detail::kpack_get_lims<int_t>(bw).second;
+
+                for (auto n : {1u, bw, 3u * bw + 1u, 100u}) {
+                    symbol_set ss;
+                    for (auto i = 0u; i < n; ++i) {
+                        ss.insert(ss.end(), "x" + std::to_string(1000u + i));
+                    }
+
+                    const auto check = [&ss](int_t e, const mppp::integer<1> &expected) {
+                        const pm_t m(std::vector<int_t>(ss.size(), e));
+
+                        if (expected >= detail::limits_min<int_t> && expected <= detail::limits_max<int_t>) {
+                            REQUIRE(key_degree(m, ss) == static_cast<int_t>(expected));
+                        } else {
+                            OBAKE_REQUIRES_THROWS_CONTAINS(key_degree(m, ss), std::overflow_error, "");
+                        }
+                    };
+
+                    check(lim, mppp::integer<1>(lim) * n);
+                    if constexpr (is_signed_v<int_t>) {
+                        check(-lim, -mppp::integer<1>(lim) * n);
+                    }
+                }
+            }
+
+            if constexpr (bw == 1u) {
+                // Overflow checking.
+                REQUIRE(key_degree(pm_t{detail::limits_max<int_t>, int_t(0)}, symbol_set{"x", "y"})
+                        == detail::limits_max<int_t>);
+                OBAKE_REQUIRES_THROWS_CONTAINS(
+                    key_degree(pm_t{detail::limits_max<int_t>, int_t(1)}, symbol_set{"x", "y"}), std::overflow_error,
+                    "");
+
+                if constexpr (is_signed_v<int_t>) {
+                    REQUIRE(key_degree(pm_t{detail::limits_min<int_t>, detail::limits_max<int_t>}, symbol_set{"x", "y"})
+                            == int_t(-1));
+                    OBAKE_REQUIRES_THROWS_CONTAINS(
+                        key_degree(pm_t{detail::limits_min<int_t>, int_t(-1)}, symbol_set{"x", "y"}),
+                        std::overflow_error, "");
+
+                    // An intermediate overflow is an error, even
+                    // if the final result would be representable.
+                    OBAKE_REQUIRES_THROWS_CONTAINS(key_degree(pm_t{detail::limits_max<int_t>, int_t(1), int_t(-1)},
+                                                              symbol_set{"x", "y", "z"}),
+                                                   std::overflow_error, "");
+                    OBAKE_REQUIRES_THROWS_CONTAINS(key_degree(pm_t{detail::limits_min<int_t>, int_t(-1), int_t(1)},
+                                                              symbol_set{"x", "y", "z"}),
+                                                   std::overflow_error, "");
+                }
             }
 
             REQUIRE(is_key_with_degree_v<pm_t>);
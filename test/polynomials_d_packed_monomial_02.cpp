@@ -33,6 +33,7 @@
 #include <obake/polynomials/monomial_diff.hpp>
 #include <obake/polynomials/monomial_integrate.hpp>
 #include <obake/polynomials/monomial_subs.hpp>
+#include <obake/polynomials/monomial_unpack.hpp>
 #include <obake/s11n.hpp>
 #include <obake/symbols.hpp>
 #include <obake/type_traits.hpp>
@@ -478,3 +479,40 @@ TEST_CASE("s11n_test")
         });
     });
 }
+
+TEST_CASE("monomial_unpack_test")
+{
+    detail::tuple_for_each(int_types{}, [](const auto &n) {
+        using int_t = remove_cvref_t<decltype(n)>;
+
+        detail::tuple_for_each(psizes<int_t>{}, [](auto bs) {
+            constexpr auto bw = decltype(bs)::value;
+            using pm_t = d_packed_monomial<int_t, bw>;
+
+            REQUIRE(is_unpackable_monomial_v<int_t *, const pm_t &>);
+            REQUIRE(is_unpackable_monomial_v<int_t *, pm_t &>);
+            REQUIRE(is_unpackable_monomial_v<int_t *, pm_t>);
+            REQUIRE(!is_unpackable_monomial_v<const int_t *, const pm_t &>);
+            REQUIRE(!is_unpackable_monomial_v<int_t, const pm_t &>);
+
+            std::vector<int_t> out(5);
+
+            monomial_unpack(out.data(), pm_t{}, symbol_set{});
+            REQUIRE(out == std::vector<int_t>{0, 0, 0, 0, 0});
+
+            monomial_unpack(out.data(), pm_t{3}, symbol_set{"x"});
+            REQUIRE(out == std::vector<int_t>{3, 0, 0, 0, 0});
+
+            monomial_unpack(out.data(), pm_t{1, 2, 3}, symbol_set{"x", "y", "z"});
+            REQUIRE(out == std::vector<int_t>{1, 2, 3, 0, 0});
+
+            monomial_unpack(out.data(), pm_t{1, 2, 3, 2, 1}, symbol_set{"a", "b", "c", "d", "e"});
+            REQUIRE(out == std::vector<int_t>{1, 2, 3, 2, 1});
+
+            if constexpr (is_signed_v<int_t>) {
+                monomial_unpack(out.data(), pm_t{-1, 0, 3, -3, 2}, symbol_set{"a", "b", "c", "d", "e"});
+                REQUIRE(out == std::vector<int_t>{-1, 0, 3, -3, 2});
+            }
+        });
+    });
+}
@@ -0,0 +1,132 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/rational.hpp>
+
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/math/evaluate.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/eval_plan.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_traits.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using rat_t = mppp::rational<1>;
+
+using key_types = std::tuple<packed_monomial<std::int32_t>, d_packed_monomial<std::int32_t, 8>>;
+
+TEST_CASE("eval_plan_test")
+{
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+        using poly_t = polynomial<pm_t, rat_t>;
+        using plan_t = polynomials::eval_plan<pm_t, rat_t>;
+
+        REQUIRE(polynomials::detail::eval_plan_algo<pm_t, rat_t, rat_t>);
+        REQUIRE(polynomials::detail::eval_plan_algo<pm_t, rat_t, double>);
+        REQUIRE(!polynomials::detail::eval_plan_algo<pm_t, rat_t, void>);
+        REQUIRE(!polynomials::detail::eval_plan_algo<pm_t, rat_t, std::vector<double>>);
+        REQUIRE(std::is_same_v<decltype(plan_t{}(symbol_map<double>{})), double>);
+        REQUIRE(std::is_same_v<decltype(plan_t{}(symbol_map<rat_t>{})), rat_t>);
+        REQUIRE(std::is_same_v<decltype(plan_t{}(symbol_map<std::vector<rat_t>>{})), std::vector<rat_t>>);
+
+        auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+        // Simple cases.
+        REQUIRE(plan_t{}.size() == 0u);
+        REQUIRE(plan_t{}(symbol_map<rat_t>{}) == 0);
+        REQUIRE(plan_t{poly_t{}}(symbol_map<rat_t>{{"x", rat_t{1}}}) == 0);
+        REQUIRE(plan_t{poly_t{3}}(symbol_map<rat_t>{}) == 3);
+        REQUIRE(plan_t{poly_t{3}}.size() == 1u);
+
+        const auto sm_q = symbol_map<rat_t>{{"x", rat_t{1, 2}}, {"y", rat_t{-2, 3}}, {"z", rat_t{5}}};
+
+        plan_t p0{x * y - 4 * obake::pow(z, 3)};
+        REQUIRE(p0.get_symbol_set() == symbol_set{"x", "y", "z"});
+        REQUIRE(p0(sm_q) == rat_t{-1501, 3});
+        const std::vector<rat_t> vals{rat_t{1, 2}, rat_t{-2, 3}, rat_t{5}};
+        REQUIRE(p0(vals.data()) == rat_t{-1501, 3});
+
+        // Dense univariate polynomial: the plan is the
+        // classical Horner scheme, which needs a single power.
+        plan_t p1{obake::pow(1 + x, 10)};
+        REQUIRE(p1(symbol_map<rat_t>{{"x", rat_t{1, 3}}}) == obake::pow(rat_t{4, 3}, 10));
+        REQUIRE(p1.size() == 11u + 2u * 10u);
+
+        // Evaluation with a workspace, reused
+        // across evaluations of different plans.
+        typename plan_t::template workspace<rat_t> ws;
+        REQUIRE(p0(vals.data(), ws) == rat_t{-1501, 3});
+        REQUIRE(p1(vals.data(), ws) == obake::pow(rat_t{3, 2}, 10));
+        REQUIRE(p0(vals.data(), ws) == rat_t{-1501, 3});
+        REQUIRE(plan_t{}(vals.data(), ws) == 0);
+
+        // Missing symbols.
+        OBAKE_REQUIRES_THROWS_CONTAINS(p0(symbol_map<double>{{"x", 1.}}), std::invalid_argument,
+                                       "Cannot evaluate a polynomial evaluation plan: the symbol 'y' is missing "
+                                       "from the evaluation map");
+        OBAKE_REQUIRES_THROWS_CONTAINS(
+            p0(symbol_map<std::vector<double>>{{"x", {1.}}, {"y", {1., 2.}}, {"z", {1.}}}), std::invalid_argument,
+            "Cannot evaluate a polynomial evaluation plan in batch mode: the array of values for the symbol 'y' has "
+            "a size of 2, but the array of values for the symbol 'x' has a size of 1");
+
+        // Sparse polynomials with many terms
+        // and negative exponents.
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> edist(-10, 10), cdist(-5, 5), vdist(50, 100);
+
+        for (auto s_idx : {0u, 2u}) {
+            poly_t p;
+            p.set_symbol_set(symbol_set{"x", "y", "z"});
+            p.set_n_segments(s_idx);
+            for (int i = 0; i < 500; ++i) {
+                p.add_term(pm_t{edist(rng), edist(rng), edist(rng)}, cdist(rng));
+            }
+
+            const plan_t pl{p};
+            REQUIRE(pl(sm_q) == evaluate(p, sm_q));
+
+            // Batch evaluation.
+            symbol_map<std::vector<rat_t>> sm_b;
+            symbol_map<std::vector<double>> sm_bd;
+            for (const auto &s : {"t", "x", "y", "z"}) {
+                for (auto i = 0; i < 100; ++i) {
+                    const auto num = vdist(rng), den = vdist(rng);
+                    sm_b[s].emplace_back(num, den);
+                    sm_bd[s].push_back(static_cast<double>(num) / den);
+                }
+            }
+
+            const auto ret_b = pl(sm_b);
+            const auto ret_bd = pl(sm_bd);
+            REQUIRE(ret_b.size() == 100u);
+            REQUIRE(ret_bd.size() == 100u);
+            for (std::size_t i = 0; i < 100u; ++i) {
+                const auto sm_i = symbol_map<rat_t>{{"x", sm_b["x"][i]}, {"y", sm_b["y"][i]}, {"z", sm_b["z"][i]}};
+                REQUIRE(ret_b[i] == evaluate(p, sm_i));
+                const auto cmp = static_cast<double>(ret_b[i]);
+                REQUIRE(std::abs(ret_bd[i] - cmp) <= 1E-8 * std::abs(cmp));
+            }
+        }
+    });
+}
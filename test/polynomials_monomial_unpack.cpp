@@ -0,0 +1,93 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <obake/polynomials/monomial_unpack.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+
+using namespace obake;
+
+namespace ns
+{
+
+// ADL-based customisation.
+struct mu00 {
+};
+
+void monomial_unpack(int *, const mu00 &, const symbol_set &);
+
+struct nomu00 {
+};
+
+// Wrong prototype.
+void monomial_unpack(int *, const nomu00 &);
+
+} // namespace ns
+
+struct mu01 {
+};
+
+struct nomu01 {
+};
+
+// External customisation.
+namespace obake::customisation
+{
+
+template <>
+inline constexpr auto monomial_unpack<int *&&, const mu01 &> = [](int *, const auto &,
+                                                                   const symbol_set &) constexpr noexcept {};
+
+template <>
+inline constexpr auto monomial_unpack<int *&&, const nomu01 &> = [](int *, const auto &) constexpr noexcept {};
+
+} // namespace obake::customisation
+
+TEST_CASE("monomial_unpack_test")
+{
+    REQUIRE(!is_unpackable_monomial_v<void, void>);
+
+    REQUIRE(!is_unpackable_monomial_v<int *, void>);
+    REQUIRE(!is_unpackable_monomial_v<void, const ns::mu00 &>);
+
+    REQUIRE(is_unpackable_monomial_v<int *, const ns::mu00 &>);
+    REQUIRE(is_unpackable_monomial_v<int *, ns::mu00 &>);
+    REQUIRE(!is_unpackable_monomial_v<const int *, const ns::mu00 &>);
+    REQUIRE(!is_unpackable_monomial_v<double *, const ns::mu00 &>);
+
+    REQUIRE(!is_unpackable_monomial_v<int *, const ns::nomu00 &>);
+    REQUIRE(!is_unpackable_monomial_v<int *, ns::nomu00 &>);
+
+    REQUIRE(is_unpackable_monomial_v<int *, const mu01 &>);
+    REQUIRE(!is_unpackable_monomial_v<int *, mu01 &>);
+    REQUIRE(!is_unpackable_monomial_v<const int *, const mu01 &>);
+
+    REQUIRE(!is_unpackable_monomial_v<int *, const nomu01 &>);
+    REQUIRE(!is_unpackable_monomial_v<int *, nomu01 &>);
+
+    REQUIRE(!UnpackableMonomial<void, void>);
+
+    REQUIRE(!UnpackableMonomial<int *, void>);
+    REQUIRE(!UnpackableMonomial<void, const ns::mu00 &>);
+
+    REQUIRE(UnpackableMonomial<int *, const ns::mu00 &>);
+    REQUIRE(UnpackableMonomial<int *, ns::mu00 &>);
+    REQUIRE(!UnpackableMonomial<const int *, const ns::mu00 &>);
+    REQUIRE(!UnpackableMonomial<double *, const ns::mu00 &>);
+
+    REQUIRE(!UnpackableMonomial<int *, const ns::nomu00 &>);
+    REQUIRE(!UnpackableMonomial<int *, ns::nomu00 &>);
+
+    REQUIRE(UnpackableMonomial<int *, const mu01 &>);
+    REQUIRE(!UnpackableMonomial<int *, mu01 &>);
+    REQUIRE(!UnpackableMonomial<const int *, const mu01 &>);
+
+    REQUIRE(!UnpackableMonomial<int *, const nomu01 &>);
+    REQUIRE(!UnpackableMonomial<int *, nomu01 &>);
+}
@@ -0,0 +1,283 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <mp++/integer.hpp>
+
+#include <obake/detail/cache_sizes.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/mul_policy.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+// Helper to check that two policies are identical.
+inline bool policy_eq(const polynomials::mul_policy &a, const polynomials::mul_policy &b)
+{
+    return a.sparse_seg_size == b.sparse_seg_size && a.dense_seg_size == b.dense_seg_size
+           && a.sp_threshold == b.sp_threshold && a.dense_sp_threshold == b.dense_sp_threshold
+           && a.dense_max_box_ratio == b.dense_max_box_ratio && a.dense_chunk_size == b.dense_chunk_size
+           && a.heap_max_size == b.heap_max_size && a.heap_min_size == b.heap_min_size
+           && a.heap_min_ratio == b.heap_min_ratio
+           && a.kronecker_min_size == b.kronecker_min_size && a.fft_min_size == b.fft_min_size
+           && a.fft_tolerance == b.fft_tolerance;
+}
+
+TEST_CASE("cache_mul_policy_test")
+{
+    const auto dp = polynomials::mul_policy{};
+
+    // Detection failure results in the default values.
+    REQUIRE(policy_eq(polynomials::cache_mul_policy(detail::cache_sizes{}), dp));
+
+    // Partial detection.
+    auto p = polynomials::cache_mul_policy(detail::cache_sizes{64ul * 1024ul, 0, 0});
+    REQUIRE(p.dense_seg_size == 40ul * 1024ul);
+    REQUIRE(p.sparse_seg_size == dp.sparse_seg_size);
+    REQUIRE(p.dense_chunk_size == dp.dense_chunk_size);
+    p = polynomials::cache_mul_policy(detail::cache_sizes{0, 1024ul * 1024ul, 0});
+    REQUIRE(p.dense_seg_size == dp.dense_seg_size);
+    REQUIRE(p.sparse_seg_size == 800ul * 1024ul);
+    REQUIRE(p.dense_chunk_size == 1024ul * 1024ul);
+
+    // Cache sizes too small to be meaningful
+    // result in the default segment sizes.
+    p = polynomials::cache_mul_policy(detail::cache_sizes{1, 1, 1});
+    REQUIRE(p.dense_seg_size == dp.dense_seg_size);
+    REQUIRE(p.sparse_seg_size == dp.sparse_seg_size);
+
+    // The default values were tuned on a machine
+    // with 32KB of L1d and 256KB of L2.
+    REQUIRE(policy_eq(polynomials::cache_mul_policy(detail::cache_sizes{32ul * 1024ul, 256ul * 1024ul, 0}), dp));
+
+    // The size-related thresholds grow with the cache sizes,
+    // and the other parameters do not depend on them.
+    auto prev = polynomials::cache_mul_policy(detail::cache_sizes{4096, 4096, 0});
+    for (unsigned long l1d = 8192, l2 = 8192; l1d <= 1024ul * 1024ul; l1d *= 2u, l2 *= 4u) {
+        const auto cur = polynomials::cache_mul_policy(detail::cache_sizes{l1d, l2, 0});
+
+        REQUIRE(cur.dense_seg_size > prev.dense_seg_size);
+        REQUIRE(cur.sparse_seg_size > prev.sparse_seg_size);
+        REQUIRE(cur.dense_chunk_size > prev.dense_chunk_size);
+        REQUIRE(cur.dense_seg_size < cur.sparse_seg_size);
+
+        auto tmp = cur;
+        tmp.dense_seg_size = dp.dense_seg_size;
+        tmp.sparse_seg_size = dp.sparse_seg_size;
+        tmp.dense_chunk_size = dp.dense_chunk_size;
+        REQUIRE(policy_eq(tmp, dp));
+
+        prev = cur;
+    }
+
+    // The policy deduced from the detected cache sizes.
+    REQUIRE(policy_eq(polynomials::cache_mul_policy(), polynomials::cache_mul_policy(detail::get_cache_sizes())));
+
+    // The policy info.
+    const auto &cs = detail::get_cache_sizes();
+    auto info = polynomials::get_mul_policy_info();
+    REQUIRE(info.cache_sizes.l1d == cs.l1d);
+    REQUIRE(info.cache_sizes.l2 == cs.l2);
+    REQUIRE(info.cache_sizes.l3 == cs.l3);
+    REQUIRE(policy_eq(info.policy, dp));
+    {
+        auto p2 = dp;
+        p2.dense_seg_size = 1024;
+        polynomials::mul_policy_guard g(p2);
+        info = polynomials::get_mul_policy_info();
+        REQUIRE(policy_eq(info.policy, p2));
+    }
+    REQUIRE(policy_eq(polynomials::get_mul_policy_info().policy, dp));
+}
+
+TEST_CASE("mul_policy_test")
+{
+    // The default policy.
+    const auto dp = polynomials::mul_policy{};
+    REQUIRE(dp.sparse_seg_size == 200ul * 1024ul);
+    REQUIRE(dp.dense_seg_size == 20ul * 1024ul);
+    REQUIRE(dp.sp_threshold == 1E-3);
+    REQUIRE(policy_eq(polynomials::get_mul_policy(), dp));
+
+    std::ostringstream oss;
+    oss << dp;
+    REQUIRE(!oss.str().empty());
+
+    // The policy deduced from the cache sizes.
+    const auto cp = polynomials::cache_mul_policy();
+    REQUIRE(cp.sparse_seg_size > 0u);
+    REQUIRE(cp.dense_seg_size > 0u);
+    REQUIRE(cp.sp_threshold == dp.sp_threshold);
+    REQUIRE(cp.dense_sp_threshold == dp.dense_sp_threshold);
+    REQUIRE(cp.dense_max_box_ratio == dp.dense_max_box_ratio);
+    REQUIRE(cp.dense_chunk_size > 0u);
+    REQUIRE(cp.heap_max_size == dp.heap_max_size);
+    REQUIRE(cp.heap_min_size == dp.heap_min_size);
+    REQUIRE(cp.heap_min_ratio == dp.heap_min_ratio);
+    REQUIRE(cp.kronecker_min_size == dp.kronecker_min_size);
+    REQUIRE(cp.fft_min_size == dp.fft_min_size);
+    REQUIRE(cp.fft_tolerance == 0.);
+
+    // It is used only if explicitly requested.
+    polynomials::set_mul_policy(cp);
+    REQUIRE(policy_eq(polynomials::get_mul_policy(), cp));
+    polynomials::reset_mul_policy();
+    REQUIRE(policy_eq(polynomials::get_mul_policy(), dp));
+
+    // Set/reset the global policy.
+    auto p = polynomials::mul_policy{};
+    p.sparse_seg_size = 1024;
+    p.dense_sp_threshold = 0;
+    polynomials::set_mul_policy(p);
+    REQUIRE(policy_eq(polynomials::get_mul_policy(), p));
+    // The global policy is visible from other threads.
+    std::thread([&p]() { REQUIRE(policy_eq(polynomials::get_mul_policy(), p)); }).join();
+    // The modifications are visible also from threads
+    // which already read the global policy.
+    {
+        std::promise<void> pr0, pr1;
+        auto fut1 = pr1.get_future();
+        std::thread t([&]() {
+            REQUIRE(policy_eq(polynomials::get_mul_policy(), p));
+            pr0.set_value();
+            fut1.wait();
+            REQUIRE(policy_eq(polynomials::get_mul_policy(), dp));
+        });
+        pr0.get_future().wait();
+        polynomials::reset_mul_policy();
+        pr1.set_value();
+        t.join();
+    }
+    REQUIRE(policy_eq(polynomials::get_mul_policy(), dp));
+
+    // Scoped overrides.
+    {
+        polynomials::mul_policy_guard g0(p);
+        REQUIRE(policy_eq(polynomials::get_mul_policy(), p));
+
+        // The override is not visible from other threads.
+        std::thread([&dp]() { REQUIRE(policy_eq(polynomials::get_mul_policy(), dp)); }).join();
+
+        {
+            auto p2 = p;
+            p2.dense_seg_size = 1;
+            polynomials::mul_policy_guard g1(p2);
+            REQUIRE(policy_eq(polynomials::get_mul_policy(), p2));
+        }
+
+        REQUIRE(policy_eq(polynomials::get_mul_policy(), p));
+    }
+    REQUIRE(policy_eq(polynomials::get_mul_policy(), dp));
+
+    // Invalid policies.
+    p = polynomials::mul_policy{};
+    p.sparse_seg_size = 0;
+    OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::set_mul_policy(p), std::invalid_argument,
+                                   "Invalid multiplication policy: the segment sizes must be nonzero");
+    OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::mul_policy_guard{p}, std::invalid_argument,
+                                   "Invalid multiplication policy: the segment sizes must be nonzero");
+    p = polynomials::mul_policy{};
+    p.sp_threshold = std::numeric_limits<double>::quiet_NaN();
+    OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::set_mul_policy(p), std::invalid_argument,
+                                   "Invalid multiplication policy: the sparsity thresholds must be non-negative");
+    p = polynomials::mul_policy{};
+    p.dense_sp_threshold = -1;
+    OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::set_mul_policy(p), std::invalid_argument,
+                                   "Invalid multiplication policy: the sparsity thresholds must be non-negative");
+    p = polynomials::mul_policy{};
+    p.dense_chunk_size = 0;
+    OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::set_mul_policy(p), std::invalid_argument,
+                                   "Invalid multiplication policy: the maximum box ratio and the chunk size");
+    p = polynomials::mul_policy{};
+    p.fft_tolerance = -1;
+    OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::set_mul_policy(p), std::invalid_argument,
+                                   "Invalid multiplication policy: the tolerance of the FFT algorithm must be finite");
+    p.fft_tolerance = std::numeric_limits<double>::infinity();
+    OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::mul_policy_guard{p}, std::invalid_argument,
+                                   "Invalid multiplication policy: the tolerance of the FFT algorithm must be finite");
+    REQUIRE(policy_eq(polynomials::get_mul_policy(), dp));
+
+    // Infinite thresholds are allowed.
+    p = polynomials::mul_policy{};
+    p.sp_threshold = std::numeric_limits<double>::infinity();
+    polynomials::mul_policy_guard{p};
+}
+
+TEST_CASE("mul_policy_poly_mul_test")
+{
+    using poly_t = polynomial<packed_monomial<std::int32_t>, mppp::integer<1>>;
+
+    auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+    auto f = obake::pow(1 + x + y + z, 10), g = f + 1;
+    const auto cmp = f * g;
+
+    // Helper to run the multi-threaded multiplication.
+    auto mt_mul = [&f, &g]() {
+        poly_t retval;
+        retval.set_symbol_set(f.get_symbol_set());
+        polynomials::detail::poly_mul_impl_mt_hm(retval, f, g);
+        return retval;
+    };
+
+    // Small segments, dense algorithm disabled.
+    {
+        auto p = polynomials::mul_policy{};
+        p.sparse_seg_size = 64;
+        p.dense_seg_size = 64;
+        p.dense_sp_threshold = 0;
+        polynomials::mul_policy_guard g0(p);
+
+        const auto ret = mt_mul();
+        REQUIRE(ret == cmp);
+        REQUIRE(ret.get_s_size() > 0u);
+    }
+
+    // Huge segments, dense algorithm disabled.
+    {
+        auto p = polynomials::mul_policy{};
+        p.sparse_seg_size = std::numeric_limits<unsigned long>::max();
+        p.dense_seg_size = std::numeric_limits<unsigned long>::max();
+        p.dense_sp_threshold = 0;
+        polynomials::mul_policy_guard g0(p);
+
+        const auto ret = mt_mul();
+        REQUIRE(ret == cmp);
+        REQUIRE(ret.get_s_size() == 0u);
+    }
+
+    // Dense algorithm with tiny chunks.
+    {
+        auto p = polynomials::mul_policy{};
+        p.dense_sp_threshold = std::numeric_limits<double>::infinity();
+        p.dense_chunk_size = 1;
+        polynomials::mul_policy_guard g0(p);
+
+        REQUIRE(mt_mul() == cmp);
+    }
+
+    // Dense algorithm with a box ratio which is too small.
+    {
+        auto p = polynomials::mul_policy{};
+        p.dense_sp_threshold = std::numeric_limits<double>::infinity();
+        p.dense_max_box_ratio = 1;
+        polynomials::mul_policy_guard g0(p);
+
+        REQUIRE(mt_mul() == cmp);
+    }
+}
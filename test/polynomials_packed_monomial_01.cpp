@@ -27,6 +27,7 @@
 #include <obake/polynomials/monomial_diff.hpp>
 #include <obake/polynomials/monomial_integrate.hpp>
 #include <obake/polynomials/monomial_subs.hpp>
+#include <obake/polynomials/monomial_unpack.hpp>
 #include <obake/polynomials/packed_monomial.hpp>
 #include <obake/symbols.hpp>
 #include <obake/type_traits.hpp>
@@ -327,3 +328,33 @@ TEST_CASE("monomial_integrate")
         }
     });
 }
+
+TEST_CASE("monomial_unpack")
+{
+    detail::tuple_for_each(int_types{}, [](const auto &n) {
+        using int_t = remove_cvref_t<decltype(n)>;
+        using pm_t = packed_monomial<int_t>;
+
+        REQUIRE(is_unpackable_monomial_v<int_t *, const pm_t &>);
+        REQUIRE(is_unpackable_monomial_v<int_t *, pm_t &>);
+        REQUIRE(is_unpackable_monomial_v<int_t *, pm_t>);
+        REQUIRE(!is_unpackable_monomial_v<const int_t *, const pm_t &>);
+        REQUIRE(!is_unpackable_monomial_v<int_t, const pm_t &>);
+
+        std::vector<int_t> out(3);
+
+        monomial_unpack(out.data(), pm_t{}, symbol_set{});
+        REQUIRE(out == std::vector<int_t>{0, 0, 0});
+
+        monomial_unpack(out.data(), pm_t{4}, symbol_set{"x"});
+        REQUIRE(out == std::vector<int_t>{4, 0, 0});
+
+        monomial_unpack(out.data(), pm_t{1, 2, 3}, symbol_set{"x", "y", "z"});
+        REQUIRE(out == std::vector<int_t>{1, 2, 3});
+
+        if constexpr (is_signed_v<int_t>) {
+            monomial_unpack(out.data(), pm_t{-1, 0, 3}, symbol_set{"x", "y", "z"});
+            REQUIRE(out == std::vector<int_t>{-1, 0, 3});
+        }
+    });
+}
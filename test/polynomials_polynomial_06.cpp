@@ -0,0 +1,613 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <mp++/integer.hpp>
+
+#include <obake/config.hpp>
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/kpack.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/mul_policy.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_traits.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using exp_t =
+#if defined(OBAKE_PACKABLE_INT64)
+    std::int64_t
+#else
+    std::int32_t
+#endif
+    ;
+
+using key_types = std::tuple<packed_monomial<exp_t>, d_packed_monomial<exp_t, polynomials::dpm_default_psize>,
+                             d_packed_monomial<exp_t, 1>>;
+
+// Helper to extract the terms of a polynomial
+// into a vector of pairs.
+template <typename P>
+inline auto to_vector(const P &p)
+{
+    std::vector<std::pair<series_key_t<P>, series_cf_t<P>>> ret;
+
+    for (const auto &t : p) {
+        ret.emplace_back(t.first, t.second);
+    }
+
+    return ret;
+}
+
+// Helper to compute the product of x and y
+// via the dense algorithm, with the given number of segments.
+template <typename P>
+inline auto dense_mul(const P &x, const P &y, unsigned log2_nsegs, const mppp::integer<1> &est_nterms)
+{
+    P retval;
+    retval.set_symbol_set(x.get_symbol_set());
+    retval.set_n_segments(log2_nsegs);
+
+    const auto flag = polynomials::detail::poly_mul_impl_mt_dense(retval, to_vector(x), to_vector(y), est_nterms,
+                                                                  polynomials::get_mul_policy());
+
+    return std::make_pair(flag, std::move(retval));
+}
+
+// Helper to compute the product of x and y
+// via the simple algorithm.
+template <typename P>
+inline auto simple_mul(const P &x, const P &y)
+{
+    P retval;
+    retval.set_symbol_set(x.get_symbol_set());
+    polynomials::detail::poly_mul_impl_simple(retval, x, y);
+
+    return retval;
+}
+
+TEST_CASE("polynomial_mul_dense_test")
+{
+    using cf_types = std::tuple<double, mppp::integer<1>>;
+
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+
+        REQUIRE(polynomials::detail::poly_mul_kbox_algo<polynomial<pm_t, double>>);
+        REQUIRE(polynomials::detail::poly_mul_kbox_algo<polynomial<pm_t, mppp::integer<1>>>);
+
+        detail::tuple_for_each(cf_types{}, [](auto xs) {
+            using poly_t = polynomial<pm_t, decltype(xs)>;
+
+            auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+            // Constants.
+            {
+                auto [flag, ret] = dense_mul(poly_t{3}, poly_t{4}, 0, mppp::integer<1>{1});
+                REQUIRE(flag);
+                REQUIRE(ret == 12);
+            }
+
+            // Examples with cancellations.
+            for (auto log2_nsegs : {0u, 1u, 3u}) {
+                auto [flag, ret] = dense_mul(x + y, x - y, log2_nsegs, mppp::integer<1>{4});
+                REQUIRE(flag);
+                REQUIRE(ret == x * x - y * y);
+
+                std::tie(flag, ret) = dense_mul(x * x + y * y, (x + y) * (x - y), log2_nsegs, mppp::integer<1>{4});
+                REQUIRE(flag);
+                REQUIRE(ret == x * x * x * x - y * y * y * y);
+            }
+
+            // Negative exponents and exponents not starting from zero.
+            if constexpr (is_signed_v<exp_t>) {
+                auto xm1 = poly_t{};
+                xm1.set_symbol_set(symbol_set{"x", "y", "z"});
+                xm1.add_term(pm_t{-1, 0, 0}, 1);
+
+                for (auto log2_nsegs : {0u, 2u}) {
+                    auto [flag, ret] = dense_mul(xm1 + y * y * z, xm1 * 2 - y * y * z + x * y, log2_nsegs,
+                                                 mppp::integer<1>{6});
+                    REQUIRE(flag);
+                    REQUIRE(ret == simple_mul(xm1 + y * y * z, xm1 * 2 - y * y * z + x * y));
+                }
+            }
+
+            // A bounding box too large with respect to the estimated
+            // number of terms.
+            {
+                auto [flag, ret] = dense_mul(obake::pow(x, 100) + 1, obake::pow(y, 100) + 1, 0, mppp::integer<1>{4});
+                REQUIRE(!flag);
+                REQUIRE(ret.empty());
+            }
+
+            // Larger dense products.
+            auto f = obake::pow(1 + x + y + z, 6), g = f + 1;
+
+            for (auto log2_nsegs : {0u, 1u, 4u}) {
+                auto [flag, ret] = dense_mul(f, g, log2_nsegs, mppp::integer<1>{455});
+                REQUIRE(flag);
+                REQUIRE(ret == simple_mul(f, g));
+            }
+        });
+    });
+}
+
+TEST_CASE("polynomial_mul_dense_mt_hm_test")
+{
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+        using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+        auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+        // NOTE: these products should be dense enough to
+        // be dispatched to the dense algorithm by the
+        // multi-threaded homomorphic implementation.
+        auto f = obake::pow(1 + x + y, 30), g = f + 1;
+        poly_t retval;
+        retval.set_symbol_set(f.get_symbol_set());
+        polynomials::detail::poly_mul_impl_mt_hm(retval, f, g);
+        REQUIRE(retval.size() == 1891u);
+        REQUIRE(retval == simple_mul(f, g));
+
+        f = obake::pow(1 + x + y * y + z * z * z, 10);
+        g = f + x * y * z - 1;
+        retval = poly_t{};
+        retval.set_symbol_set(f.get_symbol_set());
+        polynomials::detail::poly_mul_impl_mt_hm(retval, f, g);
+        REQUIRE(retval == simple_mul(f, g));
+    });
+}
+
+TEST_CASE("polynomial_mul_heap_test")
+{
+    using cf_types = std::tuple<double, mppp::integer<1>>;
+
+    // The cost model, with the default policy. The shapes of
+    // the products in the rectangular_01 benchmark (13 terms times
+    // a large polynomial) select the heap-based algorithm.
+    const auto dp = polynomials::mul_policy{};
+    REQUIRE(!polynomials::detail::poly_mul_heap_cost_model(1, 100000, dp));
+    REQUIRE(!polynomials::detail::poly_mul_heap_cost_model(13, 1000, dp));
+    REQUIRE(!polynomials::detail::poly_mul_heap_cost_model(1000, 10000, dp));
+    REQUIRE(!polynomials::detail::poly_mul_heap_cost_model(10000, 100000, dp));
+    REQUIRE(polynomials::detail::poly_mul_heap_cost_model(13, 5000, dp));
+    REQUIRE(polynomials::detail::poly_mul_heap_cost_model(13, 100000, dp));
+
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+
+        detail::tuple_for_each(cf_types{}, [](auto xs) {
+            using poly_t = polynomial<pm_t, decltype(xs)>;
+
+            // Helper to compute the product of x and y
+            // via the heap-based algorithm.
+            auto heap_mul = [](const poly_t &a, const poly_t &b) {
+                poly_t retval;
+                retval.set_symbol_set(a.get_symbol_set());
+
+                const auto flag = polynomials::detail::poly_mul_impl_heap(retval, a, b);
+                REQUIRE(flag);
+
+                return retval;
+            };
+
+            auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+            // A few simple tests.
+            REQUIRE(heap_mul(poly_t{3}, poly_t{4}) == 12);
+            REQUIRE(heap_mul(x + y, x - y) == x * x - y * y);
+            REQUIRE(heap_mul(x * x + y * y, (x + y) * (x - y)) == x * x * x * x - y * y * y * y);
+            REQUIRE(heap_mul(x - y, x - y) == x * x - 2 * x * y + y * y);
+
+            // Negative exponents.
+            if constexpr (is_signed_v<exp_t>) {
+                auto xm1 = poly_t{};
+                xm1.set_symbol_set(symbol_set{"x", "y", "z"});
+                xm1.add_term(pm_t{-1, 0, 0}, 1);
+
+                REQUIRE(heap_mul(xm1 + y * y * z, xm1 * 2 - y * y * z + x * y)
+                        == simple_mul(xm1 + y * y * z, xm1 * 2 - y * y * z + x * y));
+            }
+
+            // An overflowing example.
+            if constexpr (std::is_same_v<pm_t, packed_monomial<exp_t>>) {
+                auto a = poly_t{}, b = poly_t{};
+                a.set_symbol_set(symbol_set{"x"});
+                b.set_symbol_set(symbol_set{"x"});
+                a.add_term(pm_t{detail::kpack_get_lims<exp_t>(1).second}, 1);
+                b.add_term(pm_t{detail::kpack_get_lims<exp_t>(1).second}, 1);
+
+                poly_t retval;
+                retval.set_symbol_set(symbol_set{"x"});
+                OBAKE_REQUIRES_THROWS_CONTAINS(
+                    polynomials::detail::poly_mul_impl_heap(retval, a, b), std::overflow_error,
+                    "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+            }
+
+            // A sparse rectangular product.
+            auto f = x * y * y * y * z * z + x * x * y * y * z + x * y * y * y * z + x * y * y * z * z
+                     + y * y * y * z * z + y * y * y * z + 2 * y * y * z * z + 2 * x * y * z + y * y * z + y * z * z
+                     + y * y + 2 * y * z + z;
+            auto g = obake::pow(f, 5);
+
+            REQUIRE(heap_mul(f, g) == simple_mul(f, g));
+            REQUIRE(heap_mul(f, g) == obake::pow(f, 6));
+
+            // Force the selection of the heap-based
+            // algorithm in the multiplication operator.
+            {
+                auto mp = polynomials::mul_policy{};
+                mp.heap_min_size = 0;
+                mp.heap_min_ratio = 0;
+                polynomials::mul_policy_guard mpg(mp);
+
+                REQUIRE(polynomials::detail::poly_mul_heap_cost_model(f.size(), g.size(), mp));
+                REQUIRE(f * g == simple_mul(f, g));
+                REQUIRE(g * f == simple_mul(f, g));
+                REQUIRE((x + y) * (x - y) == x * x - y * y);
+            }
+        });
+    });
+}
+
+TEST_CASE("polynomial_mul_int_test")
+{
+    using poly_t_ = polynomial<packed_monomial<exp_t>, mppp::integer<1>>;
+    using polynomials::detail::poly_mul_int_algorithm;
+    using polynomials::detail::poly_mul_int_cost_model;
+
+    REQUIRE(polynomials::detail::poly_mul_kronecker_algo<poly_t_, mppp::integer<1>, mppp::integer<1>>);
+    REQUIRE(!polynomials::detail::poly_mul_kronecker_algo<poly_t_, mppp::integer<2>, mppp::integer<1>>);
+    REQUIRE(!polynomials::detail::poly_mul_kronecker_algo<polynomial<packed_monomial<exp_t>, double>, double, double>);
+
+    // The cost model.
+    REQUIRE(poly_mul_int_cost_model(mppp::integer<1>{4096} * 4096, 8191, 20, 20, 53)
+            == poly_mul_int_algorithm::kronecker);
+    REQUIRE(poly_mul_int_cost_model(mppp::integer<1>{1771} * 1771, 68921, 20, 20, 53) == poly_mul_int_algorithm::crt);
+    REQUIRE(poly_mul_int_cost_model(mppp::integer<1>{4096}, 20000, 30, 30, 68) == poly_mul_int_algorithm::none);
+    REQUIRE(poly_mul_int_cost_model(mppp::integer<1>{165} * 165, 4913, 200, 200, 409) == poly_mul_int_algorithm::none);
+    // Too many primes for the multi-modular algorithm.
+    REQUIRE(poly_mul_int_cost_model(mppp::integer<1>{1000000}, 1000, 9990, 9990, 20000)
+            == poly_mul_int_algorithm::kronecker);
+
+    // NOTE: the tests below need exponents larger than
+    // those allowed by the default packing of d_packed_monomial.
+    using kron_key_types = std::tuple<packed_monomial<exp_t>, d_packed_monomial<exp_t, 1>>;
+
+    detail::tuple_for_each(kron_key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+        using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+        // Helper to compute the product of a and b via the Kronecker
+        // substitution and multi-modular algorithms, checking that
+        // the two algorithms produce the same result.
+        auto kron_mul = [](const poly_t &a, const poly_t &b) {
+            std::pair<bool, poly_t> rets[2];
+
+            for (auto i = 0; i < 2; ++i) {
+                const auto algo = i == 0 ? poly_mul_int_algorithm::kronecker : poly_mul_int_algorithm::crt;
+
+                auto &[flag, retval] = rets[i];
+                retval.set_symbol_set(a.get_symbol_set());
+
+                if (&a == &b) {
+                    flag = polynomials::detail::poly_mul_impl_int<true>(retval, a, b, algo);
+                } else {
+                    flag = polynomials::detail::poly_mul_impl_int<false>(retval, a, b, algo);
+                }
+            }
+
+            REQUIRE(rets[0].first == rets[1].first);
+            REQUIRE(rets[0].second == rets[1].second);
+
+            return std::move(rets[0]);
+        };
+
+        auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+        auto [t] = make_polynomials<poly_t>("t");
+
+        std::mt19937 rng(42);
+
+        // Helper to generate a random coefficient with
+        // roughly nbits bits and random sign.
+        auto rnd_cf = [&rng](unsigned nbits) {
+            mppp::integer<1> ret{rng() % 2u};
+            for (unsigned i = 0; i < nbits; i += 16u) {
+                ret <<= 16u;
+                ret += rng() % (1u << 16);
+            }
+
+            return (rng() % 2u == 0u) ? ret : -ret;
+        };
+
+        for (auto nbits : {8u, 48u, 200u}) {
+            // Dense univariate polynomials.
+            poly_t a, b;
+            for (int i = 0; i < 128; ++i) {
+                a += rnd_cf(nbits) * obake::pow(t, i);
+                b += rnd_cf(nbits) * obake::pow(t, i + 3);
+            }
+
+            auto ret = kron_mul(a, b);
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == simple_mul(a, b));
+
+            // Squaring.
+            ret = kron_mul(a, a);
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == simple_mul(a, a));
+
+            // Dense trivariate polynomials.
+            a = poly_t{};
+            b = poly_t{};
+            for (int i = 0; i < 11; ++i) {
+                for (int j = 0; i + j < 11; ++j) {
+                    for (int l = 0; i + j + l < 11; ++l) {
+                        a += rnd_cf(nbits) * obake::pow(x, i) * obake::pow(y, j) * obake::pow(z, l);
+                        b += rnd_cf(nbits) * obake::pow(x, i) * obake::pow(y, j) * obake::pow(z, l);
+                    }
+                }
+            }
+
+            ret = kron_mul(a, b);
+            if (ret.first) {
+                REQUIRE(ret.second == simple_mul(a, b));
+            } else {
+                REQUIRE(ret.second.empty());
+            }
+        }
+
+        // Coefficients which cancel out.
+        {
+            poly_t a{1}, b{1};
+            for (int i = 0; i < 64; ++i) {
+                a *= 1 + t;
+                b *= 1 - t;
+            }
+
+            const auto ret = kron_mul(a, b);
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == simple_mul(a, b));
+        }
+
+        // Coefficients of the product reaching the bounds of the
+        // slots, both for single-limb and multi-limb slots.
+        for (auto nbits : {26u, 61u}) {
+            poly_t a, b;
+            const auto max_cf = (mppp::integer<1>{1} << nbits) - 1;
+            for (int i = 0; i < 200; ++i) {
+                a += max_cf * obake::pow(t, i);
+                b -= max_cf * obake::pow(t, i);
+            }
+
+            auto ret = kron_mul(a, b);
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == simple_mul(a, b));
+
+            ret = kron_mul(b, b);
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == simple_mul(b, b));
+        }
+
+        // Negative exponents.
+        if constexpr (is_signed_v<exp_t>) {
+            auto xm1 = poly_t{};
+            xm1.set_symbol_set(symbol_set{"x", "y", "z"});
+            xm1.add_term(pm_t{-1, 0, 0}, 1);
+
+            auto a = obake::pow(xm1 + x * y + 2, 20), b = obake::pow(xm1 - y + 3, 20);
+
+            const auto ret = kron_mul(a, b);
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == simple_mul(a, b));
+        }
+
+        // A sparse product, rejected by the cost model.
+        {
+            auto f = x * y * y * y * z * z + x * x * y * y * z + x * y * y * y * z + x * y * y * z * z
+                     + y * y * y * z * z + y * y * y * z + 2 * y * y * z * z + 2 * x * y * z + y * y * z + y * z * z
+                     + y * y + 2 * y * z + z;
+            auto g = obake::pow(f, 5);
+            g.add_term(pm_t{100, 100, 100}, 1);
+
+            const auto ret = kron_mul(f, g);
+            REQUIRE(!ret.first);
+            REQUIRE(ret.second.empty());
+        }
+
+        // An overflowing example.
+        if constexpr (std::is_same_v<pm_t, packed_monomial<exp_t>>) {
+            auto a = poly_t{}, b = poly_t{};
+            a.set_symbol_set(symbol_set{"x"});
+            b.set_symbol_set(symbol_set{"x"});
+            a.add_term(pm_t{detail::kpack_get_lims<exp_t>(1).second}, 1);
+            b.add_term(pm_t{detail::kpack_get_lims<exp_t>(1).second}, 1);
+
+            OBAKE_REQUIRES_THROWS_CONTAINS(
+                kron_mul(a, b), std::overflow_error,
+                "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+        }
+
+        // Via the public API, toggling the algorithm
+        // via the multiplication policy.
+        {
+            poly_t a = obake::pow(1 - 3 * x + 2 * y * y + 7 * z, 12), b = obake::pow(x - y + z, 12);
+
+            auto p = polynomials::get_mul_policy();
+            p.kronecker_min_size = 0;
+            poly_t r1, r2;
+            {
+                polynomials::mul_policy_guard g0(p);
+                r1 = a * b;
+            }
+            p.kronecker_min_size = std::numeric_limits<unsigned long>::max();
+            {
+                polynomials::mul_policy_guard g0(p);
+                r2 = a * b;
+            }
+
+            REQUIRE(r1 == r2);
+            REQUIRE(r1 == simple_mul(b, a));
+        }
+    });
+}
+
+TEST_CASE("polynomial_mul_workspace_test")
+{
+    using poly_t = polynomial<packed_monomial<exp_t>, mppp::integer<1>>;
+
+    auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+    // Helper to run the multi-threaded multiplication.
+    auto mt_mul = [](const poly_t &a, const poly_t &b) {
+        poly_t retval;
+        retval.set_symbol_set(a.get_symbol_set());
+        polynomials::detail::poly_mul_impl_mt_hm(retval, a, b);
+        return retval;
+    };
+
+    // Sparse products of decreasing and increasing size,
+    // which will be re-using the buffers of the workspace.
+    for (auto n : {8, 4, 2, 6}) {
+        auto f = obake::pow(1 + x + y * y * y + z * z * z * z * z * z * z, n), g = f - x * y * z;
+        REQUIRE(mt_mul(f, g) == simple_mul(f, g));
+    }
+
+    // Concurrent products.
+    auto f = obake::pow(1 + x + y * y * y + z * z * z * z * z * z * z, 6), g = f - x * y * z;
+    const auto cmp = simple_mul(f, g);
+    std::vector<poly_t> res(16);
+    ::tbb::parallel_for(::tbb::blocked_range<std::size_t>(0, res.size()), [&](const auto &range) {
+        for (auto i = range.begin(); i != range.end(); ++i) {
+            res[i] = mt_mul(f, g);
+        }
+    });
+    for (const auto &r : res) {
+        REQUIRE(r == cmp);
+    }
+}
+
+TEST_CASE("polynomial_mul_sqr_test")
+{
+    using cf_types = std::tuple<double, mppp::integer<1>>;
+
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+
+        detail::tuple_for_each(cf_types{}, [](auto xs) {
+            using poly_t = polynomial<pm_t, decltype(xs)>;
+
+            REQUIRE(polynomials::detail::poly_mul_sqr_algo<poly_t>);
+
+            // Helpers to compute the square of x via the squaring mode
+            // of the simple and multi-threaded implementations.
+            auto simple_sqr = [](const poly_t &a, const auto &...args) {
+                poly_t retval;
+                retval.set_symbol_set(a.get_symbol_set());
+                polynomials::detail::poly_mul_impl_simple<false, true>(retval, a, a, args...);
+                return retval;
+            };
+            // NOTE: in the multi-threaded implementation,
+            // use small segment sizes in order to produce
+            // segmented results (with both the sparse and the dense
+            // functors), and disable the dense algorithm.
+            auto mt_sqr = [](const poly_t &a, const auto &...args) {
+                poly_t retval;
+                retval.set_symbol_set(a.get_symbol_set());
+                polynomials::detail::poly_mul_impl_mt_hm<false, true>(retval, a, a, args...);
+
+                for (auto seg_size : {1ul, 256ul}) {
+                    auto mp = polynomials::get_mul_policy();
+                    mp.sparse_seg_size = seg_size;
+                    mp.dense_seg_size = seg_size;
+                    mp.dense_sp_threshold = 0;
+                    polynomials::mul_policy_guard g(mp);
+
+                    poly_t tmp;
+                    tmp.set_symbol_set(a.get_symbol_set());
+                    polynomials::detail::poly_mul_impl_mt_hm<false, true>(tmp, a, a, args...);
+                    REQUIRE(tmp == retval);
+                }
+
+                return retval;
+            };
+
+            auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+            // A few simple tests.
+            REQUIRE(simple_sqr(poly_t{3}) == 9);
+            REQUIRE(mt_sqr(poly_t{3}) == 9);
+            REQUIRE(simple_sqr(x - y) == x * x - 2 * x * y + y * y);
+            REQUIRE(mt_sqr(x - y) == x * x - 2 * x * y + y * y);
+            REQUIRE(simple_sqr(x + y + z) == simple_mul(x + y + z, x + y + z));
+            REQUIRE(mt_sqr(x + y + z) == simple_mul(x + y + z, x + y + z));
+
+            // Dense and sparse squares.
+            for (const auto &f :
+                 {obake::pow(1 + x + y + z, 8), obake::pow(1 + x + y * y * y + z * z * z * z * z * z * z, 6) - x * y}) {
+                const auto cmp = simple_mul(f, poly_t{f});
+
+                REQUIRE(simple_sqr(f) == cmp);
+                REQUIRE(mt_sqr(f) == cmp);
+                REQUIRE(f * f == cmp);
+
+                // Truncated squares.
+                for (auto deg : {0, 1, 5, 11, 100}) {
+                    poly_t retval;
+                    retval.set_symbol_set(f.get_symbol_set());
+                    polynomials::detail::poly_mul_impl_simple(retval, f, poly_t{f}, deg);
+
+                    REQUIRE(simple_sqr(f, deg) == retval);
+                    REQUIRE(mt_sqr(f, deg) == retval);
+                    REQUIRE(truncated_mul(f, f, deg) == retval);
+
+                    retval = poly_t{};
+                    retval.set_symbol_set(f.get_symbol_set());
+                    polynomials::detail::poly_mul_impl_simple(retval, f, poly_t{f}, deg, symbol_set{"x", "z"});
+
+                    REQUIRE(simple_sqr(f, deg, symbol_set{"x", "z"}) == retval);
+                    REQUIRE(mt_sqr(f, deg, symbol_set{"x", "z"}) == retval);
+                    REQUIRE(truncated_mul(f, f, deg, symbol_set{"x", "z"}) == retval);
+                }
+            }
+
+            // Squares with cancellations.
+            REQUIRE(simple_sqr((x + y) * (x - y)) == obake::pow(x, 4) - 2 * x * x * y * y + obake::pow(y, 4));
+            REQUIRE(mt_sqr((x + y) * (x - y)) == obake::pow(x, 4) - 2 * x * x * y * y + obake::pow(y, 4));
+
+            // Exponentiation via the pow cache.
+            auto f = 1 + x + y + z;
+            auto cmp = poly_t{1};
+            for (auto n = 0u; n < 10u; ++n) {
+                REQUIRE(obake::pow(f, n) == cmp);
+                cmp = cmp * f;
+            }
+        });
+    });
+}
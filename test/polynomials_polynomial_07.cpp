@@ -0,0 +1,285 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+
+#include <mp++/integer.hpp>
+
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/math/fma3.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using key_types = std::tuple<packed_monomial<std::int32_t>, d_packed_monomial<std::int32_t, 1>>;
+
+TEST_CASE("polynomial_fma3_test")
+{
+    REQUIRE(is_mult_addable_v<polynomial<packed_monomial<std::int32_t>, double> &,
+                              const polynomial<packed_monomial<std::int32_t>, double> &,
+                              const polynomial<packed_monomial<std::int32_t>, double> &>);
+    REQUIRE(!is_mult_addable_v<polynomial<packed_monomial<std::int32_t>, double> &,
+                               const polynomial<packed_monomial<std::int32_t>, double> &,
+                               const polynomial<packed_monomial<std::int32_t>, float> &>);
+    REQUIRE(!is_mult_addable_v<const polynomial<packed_monomial<std::int32_t>, double> &,
+                               const polynomial<packed_monomial<std::int32_t>, double> &,
+                               const polynomial<packed_monomial<std::int32_t>, double> &>);
+
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+        using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+        auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+        // Empty operands.
+        {
+            auto ret = x + 1;
+            obake::fma3(ret, poly_t{}, y);
+            REQUIRE(ret == x + 1);
+            obake::fma3(ret, y, poly_t{});
+            REQUIRE(ret == x + 1);
+        }
+
+        // Empty ret.
+        {
+            poly_t ret;
+            ret.set_symbol_set(symbol_set{"x", "y", "z"});
+            obake::fma3(ret, x + y, x - z);
+            REQUIRE(ret == (x + y) * (x - z));
+
+            ret = poly_t{};
+            obake::fma3(ret, x + y, x - z);
+            REQUIRE(ret == (x + y) * (x - z));
+        }
+
+        // Accumulation, with cancellations.
+        {
+            auto ret = x * x - y * y + z;
+            obake::fma3(ret, x + y, y - x);
+            REQUIRE(ret == z);
+
+            ret = x * x - y * y;
+            obake::fma3(ret, x + y, y - x);
+            REQUIRE(ret.empty());
+
+            // Differing symbol sets.
+            ret = z;
+            obake::fma3(ret, x + 1, x - 1);
+            REQUIRE(ret == x * x - 1 + z);
+        }
+
+        // Overlapping arguments.
+        {
+            auto ret = x + y;
+            obake::fma3(ret, ret, x - y);
+            REQUIRE(ret == x + y + (x + y) * (x - y));
+
+            ret = x + y;
+            obake::fma3(ret, x - y, ret);
+            REQUIRE(ret == x + y + (x + y) * (x - y));
+
+            ret = x + y;
+            obake::fma3(ret, ret, ret);
+            REQUIRE(ret == x + y + (x + y) * (x + y));
+        }
+
+        // Sum of products.
+        {
+            auto f = obake::pow(1 + x + y * y + z * z * z, 8), g = f - x * y * z;
+
+            poly_t ret, cmp;
+            for (auto i = 0; i < 4; ++i) {
+                auto a = f + i, b = g - i;
+
+                obake::fma3(ret, a, b);
+                cmp += a * b;
+
+                REQUIRE(ret == cmp);
+            }
+        }
+
+        // Accumulation into a segmented polynomial.
+        {
+            auto f = obake::pow(1 + x + y * y + z * z * z, 8), g = f - x * y * z;
+
+            poly_t ret;
+            ret.set_symbol_set(symbol_set{"x", "y", "z"});
+            ret.set_n_segments(4);
+            ret += f;
+
+            obake::fma3(ret, x + 1, y - 1);
+            REQUIRE(ret == f + (x + 1) * (y - 1));
+        }
+    });
+}
+
+TEST_CASE("polynomial_fma3_mt_hm_test")
+{
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+        using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+        auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+        auto f = obake::pow(1 + x + y * y + z * z * z, 8), g = f - x * y * z;
+
+        // Accumulation into polynomials with a different number
+        // of segments (which will be increased if needed).
+        for (auto log2_nsegs : {0u, 2u, 8u}) {
+            auto ret = poly_t{};
+            ret.set_symbol_set(f.get_symbol_set());
+            ret.set_n_segments(log2_nsegs);
+            ret += obake::pow(x - y, 3) - f * g;
+
+            polynomials::detail::poly_mul_impl_mt_hm<true>(ret, f, g);
+            REQUIRE(ret == obake::pow(x - y, 3));
+            REQUIRE(ret.get_s_size() >= log2_nsegs);
+
+            // Truncated accumulation.
+            polynomials::detail::poly_mul_impl_mt_hm<true>(ret, f, g, 10);
+            REQUIRE(ret == obake::pow(x - y, 3) + truncated_mul(f, g, 10));
+        }
+    });
+}
+
+TEST_CASE("polynomial_fma3_nested_test")
+{
+    // Polynomial coefficients.
+    using pm_t = packed_monomial<std::int32_t>;
+    using poly_t = polynomial<pm_t, polynomial<pm_t, mppp::integer<1>>>;
+
+    auto [x, y] = make_polynomials<poly_t>("x", "y");
+    auto [a, b] = make_polynomials<polynomial<pm_t, mppp::integer<1>>>("a", "b");
+
+    auto f = obake::pow(a * x + b * y + a * b + 1, 6), g = obake::pow(b * x - a * y + a - 1, 6);
+
+    REQUIRE(f * g == obake::pow((a * x + b * y + a * b + 1) * (b * x - a * y + a - 1), 6));
+}
+
+TEST_CASE("polynomial_pow_test")
+{
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+        using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+        auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+        // Helpers to compute the power via repeated multiplications.
+        auto rep_pow = [](const poly_t &p, unsigned n) {
+            poly_t retval{1};
+            for (auto i = 0u; i < n; ++i) {
+                retval *= p;
+            }
+            return retval;
+        };
+        auto rep_tpow = [](const poly_t &p, unsigned n, auto... args) {
+            auto retval = truncated_mul(poly_t{1}, poly_t{1}, args...);
+            for (auto i = 0u; i < n; ++i) {
+                retval = truncated_mul(retval, p, args...);
+            }
+            return retval;
+        };
+
+        // Untruncated exponentiation.
+        const auto f = x - 2 * y + 3 * z + 1;
+        for (auto n : {0u, 1u, 2u, 3u, 7u, 8u, 13u}) {
+            REQUIRE(polynomials::detail::poly_pow_binary(f, n < 2u ? 2u : n) == rep_pow(f, n < 2u ? 2u : n));
+            REQUIRE(obake::pow(f, n) == rep_pow(f, n));
+        }
+
+        // Algorithm selection.
+        {
+            const auto g = x * y - z;
+            using polynomials::detail::poly_pow_algorithm;
+            using polynomials::detail::poly_pow_select_algorithm;
+
+            REQUIRE(poly_pow_select_algorithm(g, 2, true) == poly_pow_algorithm::cache);
+            REQUIRE(poly_pow_select_algorithm(g, 2, false) == poly_pow_algorithm::repeated);
+            REQUIRE(polynomials::detail::poly_pow_repeated(g, 2) == g * g);
+            REQUIRE(polynomials::detail::poly_pow_repeated(g, 9) == rep_pow(g, 9));
+
+            // Binomials are sparse, binary exponentiation is cheaper.
+            REQUIRE(poly_pow_select_algorithm(g, 20, true) == poly_pow_algorithm::binary);
+            REQUIRE(obake::pow(g, 20) == rep_pow(g, 20));
+
+            // Dense case.
+            const auto h = (1 + x) * (1 + y) * (1 + z);
+            REQUIRE(poly_pow_select_algorithm(h, 10, true) == poly_pow_algorithm::cache);
+            REQUIRE(poly_pow_select_algorithm(h, 10, false) == poly_pow_algorithm::repeated);
+
+            // Fill the cache up to g**5.
+            REQUIRE(obake::pow(g, 2) == g * g);
+            REQUIRE(obake::pow(g, 3) == g * g * g);
+            REQUIRE(obake::pow(g, 4) == g * g * g * g);
+            REQUIRE(obake::pow(g, 5) == g * g * g * g * g);
+            REQUIRE(poly_pow_select_algorithm(g, 4, true) == poly_pow_algorithm::cache);
+            REQUIRE(poly_pow_select_algorithm(g, 6, true) == poly_pow_algorithm::cache);
+            REQUIRE(poly_pow_select_algorithm(g, 1000, true) == poly_pow_algorithm::binary);
+
+            // Truncated exponentiation.
+            REQUIRE(poly_pow_select_algorithm(g + 1, 3, false, 4) == poly_pow_algorithm::miller);
+            REQUIRE(poly_pow_select_algorithm(g + 1, 2, false, 4) != poly_pow_algorithm::miller);
+            REQUIRE(poly_pow_select_algorithm(g + 1, 3, false, -1) != poly_pow_algorithm::miller);
+            REQUIRE(poly_pow_select_algorithm(g, 3, false, 4) != poly_pow_algorithm::miller);
+            REQUIRE(poly_pow_select_algorithm(g + x, 3, false, 4) != poly_pow_algorithm::miller);
+            REQUIRE(poly_pow_select_algorithm(g + 1, 3, false, 4, symbol_set{"x"}) != poly_pow_algorithm::miller);
+            REQUIRE(poly_pow_select_algorithm(x + 1, 3, false, 4, symbol_set{"x"}) == poly_pow_algorithm::miller);
+
+            // The powers saturate the truncation limit, binary exponentiation is cheaper.
+            REQUIRE(poly_pow_select_algorithm(x + y + x * x, 5, false, 6) == poly_pow_algorithm::binary);
+            REQUIRE(truncated_pow(x + y + x * x, 5, 6) == rep_tpow(x + y + x * x, 5, 6));
+        }
+
+        // Truncated exponentiation, total degree.
+        for (const auto &p : {f, x * y - 2 * z + 3, x - y, 1 + x * x * y - z, 2 - x + x * y * z}) {
+            for (auto n : {0u, 1u, 2u, 3u, 6u, 11u}) {
+                for (auto lim : {-1, 0, 1, 2, 5, 9, 30}) {
+                    REQUIRE(truncated_pow(p, n, lim) == rep_tpow(p, n, lim));
+                }
+            }
+        }
+
+        // Truncated exponentiation, partial degree.
+        for (const auto &p : {f, x * y - 2 * z + 3, x - y, 1 + x * x * y - z, 2 - x + x * y * z}) {
+            for (auto n : {0u, 1u, 2u, 3u, 6u, 11u}) {
+                for (auto lim : {-1, 0, 1, 2, 5, 9, 30}) {
+                    REQUIRE(truncated_pow(p, n, lim, symbol_set{"x", "z"})
+                            == rep_tpow(p, n, lim, symbol_set{"x", "z"}));
+                    REQUIRE(truncated_pow(p, n, lim, symbol_set{"y", "a"})
+                            == rep_tpow(p, n, lim, symbol_set{"y", "a"}));
+                }
+            }
+        }
+
+        // Miller's recurrence vs binary exponentiation.
+        const auto h = 1 + x + y + z + x * y * z;
+        REQUIRE(polynomials::detail::poly_pow_miller(h, 9, 7) == polynomials::detail::poly_pow_binary(h, 9, 7));
+        REQUIRE(polynomials::detail::poly_pow_miller(3 * h - 1, 5, 40) == obake::pow(3 * h - 1, 5));
+
+        // Error handling.
+        OBAKE_REQUIRES_THROWS_CONTAINS(truncated_pow(f, -1, 3), std::invalid_argument,
+                                       "Invalid exponent for truncated polynomial exponentiation");
+    });
+
+    // Floating-point coefficients.
+    using poly_t = polynomial<packed_monomial<std::int32_t>, double>;
+
+    auto [x, y] = make_polynomials<poly_t>("x", "y");
+
+    const auto f = 1 + x / 2 + y / 4, g = truncated_pow(f, 6, 3);
+    REQUIRE(g == truncated_mul(obake::pow(f, 3), obake::pow(f, 3), 3));
+}
@@ -0,0 +1,290 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <mp++/integer.hpp>
+
+#include <obake/config.hpp>
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/kpack.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/mul_policy.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/power_series/power_series.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_traits.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using exp_t =
+#if defined(OBAKE_PACKABLE_INT64)
+    std::int64_t
+#else
+    std::int32_t
+#endif
+    ;
+
+// NOTE: the tests below need exponents larger than
+// those allowed by the default packing of d_packed_monomial.
+using key_types = std::tuple<packed_monomial<exp_t>, d_packed_monomial<exp_t, 1>>;
+
+// Helper to compute the product of x and y
+// via the simple algorithm.
+template <typename P>
+inline auto simple_mul(const P &x, const P &y)
+{
+    P retval;
+    retval.set_symbol_set(x.get_symbol_set());
+    if (x.size() <= y.size()) {
+        polynomials::detail::poly_mul_impl_simple(retval, x, y);
+    } else {
+        polynomials::detail::poly_mul_impl_simple(retval, y, x);
+    }
+
+    return retval;
+}
+
+// Helper to compute the product of x and y
+// via the FFT algorithm, bypassing the cost model.
+template <typename P>
+inline auto fft_mul(const P &x, const P &y)
+{
+    P retval;
+    retval.set_symbol_set(x.get_symbol_set());
+    const auto flag = polynomials::detail::poly_mul_impl_fft(retval, x, y, true);
+
+    return std::make_pair(flag, std::move(retval));
+}
+
+TEST_CASE("polynomial_mul_fft_test")
+{
+    REQUIRE(polynomials::detail::poly_mul_fft_algo<polynomial<packed_monomial<exp_t>, double>, double, double>);
+    REQUIRE(!polynomials::detail::poly_mul_fft_algo<polynomial<packed_monomial<exp_t>, float>, float, float>);
+    REQUIRE(!polynomials::detail::poly_mul_fft_algo<polynomial<packed_monomial<exp_t>, mppp::integer<1>>,
+                                                    mppp::integer<1>, mppp::integer<1>>);
+
+    // The cost model.
+    REQUIRE(polynomials::detail::poly_mul_fft_cost_model(mppp::integer<1>{128} * 128, 255));
+    REQUIRE(!polynomials::detail::poly_mul_fft_cost_model(mppp::integer<1>{64} * 64, 127));
+    REQUIRE(!polynomials::detail::poly_mul_fft_cost_model(mppp::integer<1>{455} * 455, 15625));
+
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+        using poly_t = polynomial<pm_t, double>;
+
+        auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+        auto [t] = make_polynomials<poly_t>("t");
+
+        std::mt19937 rng(42);
+
+        // Constants and small products.
+        {
+            auto ret = fft_mul(poly_t{3}, poly_t{4});
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == 12);
+
+            ret = fft_mul(x + 1, x - 1);
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == x * x - 1);
+        }
+
+        // Dense univariate polynomials with integral
+        // coefficients: the result is exact.
+        {
+            poly_t a, b;
+            for (int i = 0; i < 300; ++i) {
+                a += static_cast<double>(static_cast<int>(rng() % 2001u) - 1000) * obake::pow(t, i);
+                b += static_cast<double>(static_cast<int>(rng() % 2001u) - 1000) * obake::pow(t, i + 5);
+            }
+
+            auto ret = fft_mul(a, b);
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == simple_mul(a, b));
+
+            // Squaring.
+            ret = fft_mul(a, a);
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == simple_mul(a, a));
+        }
+
+        // Dense trivariate polynomials.
+        {
+            const auto a = obake::pow(1 + x - 2 * y + z, 6), b = obake::pow(x - y + 3 * z + 2, 5);
+
+            const auto ret = fft_mul(a, b);
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == simple_mul(a, b));
+        }
+
+        // Coefficients which cancel out.
+        {
+            const auto a = obake::pow(1 + t, 20), b = obake::pow(1 - t, 20);
+
+            const auto ret = fft_mul(a, b);
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == simple_mul(a, b));
+            REQUIRE(ret.second.size() == 21u);
+        }
+
+        // Negative exponents.
+        if constexpr (is_signed_v<exp_t>) {
+            auto xm1 = poly_t{};
+            xm1.set_symbol_set(symbol_set{"x", "y", "z"});
+            xm1.add_term(pm_t{-1, 0, 0}, 1);
+
+            const auto a = obake::pow(xm1 + x * y + 2, 8), b = obake::pow(xm1 - y + 3, 8);
+
+            const auto ret = fft_mul(a, b);
+            REQUIRE(ret.first);
+            REQUIRE(ret.second == simple_mul(a, b));
+        }
+
+        // Non-integral coefficients: the result is accepted only
+        // if a nonzero tolerance is specified in the policy.
+        {
+            std::uniform_real_distribution<double> dist(1., 2.);
+
+            poly_t a, b;
+            for (int i = 0; i < 200; ++i) {
+                a += dist(rng) * obake::pow(t, i);
+                b -= dist(rng) * obake::pow(t, i);
+            }
+
+            auto ret = fft_mul(a, b);
+            REQUIRE(!ret.first);
+            REQUIRE(ret.second.empty());
+
+            auto p = polynomials::get_mul_policy();
+            p.fft_tolerance = 1E-8;
+            polynomials::mul_policy_guard g0(p);
+
+            ret = fft_mul(a, b);
+            REQUIRE(ret.first);
+
+            const auto cmp = simple_mul(a, b);
+            REQUIRE(ret.second.size() == cmp.size());
+            for (const auto &[key, cf] : cmp) {
+                const auto it = ret.second.find(key);
+                REQUIRE(it != ret.second.end());
+                REQUIRE(std::abs(it->second - cf) <= std::abs(cf) * 1E-8);
+            }
+
+            // Coefficients spanning a wide dynamic range
+            // cannot be computed accurately.
+            a += 1E-30 * obake::pow(t, 300);
+            b += 1E-30 * obake::pow(t, 300);
+            ret = fft_mul(a, b);
+            REQUIRE(!ret.first);
+            REQUIRE(ret.second.empty());
+        }
+
+        // Integral coefficients too large for
+        // the exact computation of the result.
+        {
+            poly_t a, b;
+            for (int i = 0; i < 200; ++i) {
+                a += 0x1p40 * obake::pow(t, i);
+                b += 0x1p40 * obake::pow(t, i);
+            }
+
+            const auto ret = fft_mul(a, b);
+            REQUIRE(!ret.first);
+            REQUIRE(ret.second.empty());
+        }
+
+        // Non-finite coefficients.
+        {
+            const auto a = obake::pow(1 + t, 10) + std::numeric_limits<double>::infinity() * t;
+
+            const auto ret = fft_mul(a, a);
+            REQUIRE(!ret.first);
+            REQUIRE(ret.second.empty());
+        }
+
+        // An overflowing example.
+        if constexpr (std::is_same_v<pm_t, packed_monomial<exp_t>>) {
+            auto a = poly_t{}, b = poly_t{};
+            a.set_symbol_set(symbol_set{"x"});
+            b.set_symbol_set(symbol_set{"x"});
+            a.add_term(pm_t{detail::kpack_get_lims<exp_t>(1).second}, 1);
+            b.add_term(pm_t{detail::kpack_get_lims<exp_t>(1).second}, 1);
+
+            OBAKE_REQUIRES_THROWS_CONTAINS(
+                fft_mul(a, b), std::overflow_error,
+                "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+        }
+
+        // Via the public API, toggling the algorithm
+        // via the multiplication policy.
+        {
+            poly_t a, b;
+            for (int i = 0; i < 300; ++i) {
+                a += static_cast<double>(rng() % 1000u + 1u) * obake::pow(t, i);
+                b -= static_cast<double>(rng() % 1000u + 1u) * obake::pow(t, i);
+            }
+
+            auto p = polynomials::get_mul_policy();
+            p.fft_min_size = 0;
+            poly_t r1, r2;
+            {
+                polynomials::mul_policy_guard g0(p);
+                r1 = a * b;
+            }
+            p.fft_min_size = std::numeric_limits<unsigned long>::max();
+            {
+                polynomials::mul_policy_guard g0(p);
+                r2 = a * b;
+            }
+
+            REQUIRE(r1 == r2);
+            REQUIRE(r1 == simple_mul(a, b));
+        }
+
+        // Power series.
+        {
+            using ps_t = p_series<pm_t, double>;
+
+            auto [s] = make_p_series<ps_t>("s");
+
+            ps_t a, b;
+            for (int i = 0; i < 300; ++i) {
+                a += static_cast<double>(rng() % 1000u + 1u) * obake::pow(s, i);
+                b -= static_cast<double>(rng() % 1000u + 1u) * obake::pow(s, i);
+            }
+
+            auto p = polynomials::get_mul_policy();
+            p.fft_min_size = 0;
+            ps_t r1, r2;
+            {
+                polynomials::mul_policy_guard g0(p);
+                r1 = a * b;
+            }
+            p.fft_min_size = std::numeric_limits<unsigned long>::max();
+            {
+                polynomials::mul_policy_guard g0(p);
+                r2 = a * b;
+            }
+
+            REQUIRE(r1 == r2);
+            REQUIRE(r1.size() == 599u);
+        }
+    });
+}
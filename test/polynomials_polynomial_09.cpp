@@ -0,0 +1,217 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <mp++/integer.hpp>
+
+#include <obake/kpack.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/monomial_unpack.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_traits.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using pm_t = packed_monomial<std::int32_t>;
+
+// Check that no term of r is divisible
+// by the leading term of y.
+template <typename P>
+inline bool check_rem(const P &r, const P &y)
+{
+    const auto &ss = y.get_symbol_set();
+
+    auto lt = y.begin();
+    for (auto it = y.begin(); it != y.end(); ++it) {
+        if (it->first.get_value() > lt->first.get_value()) {
+            lt = it;
+        }
+    }
+
+    std::vector<std::int32_t> lm(ss.size()), tmp(ss.size());
+    monomial_unpack(lm.data(), lt->first, ss);
+
+    for (const auto &t : r) {
+        monomial_unpack(tmp.data(), t.first, ss);
+
+        bool divisible = true;
+        for (decltype(tmp.size()) k = 0; k < tmp.size(); ++k) {
+            divisible = divisible && tmp[k] >= lm[k];
+        }
+        if (divisible && t.second % lt->second == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+TEST_CASE("polynomial_div_test")
+{
+    using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+    REQUIRE(polynomials::detail::poly_div_algo<poly_t>);
+    REQUIRE(polynomials::detail::poly_div_algo<polynomial<pm_t, double>>);
+    REQUIRE(!polynomials::detail::poly_div_algo<polynomial<d_packed_monomial<std::int32_t, 8>, double>>);
+    // NOTE: the division operator is not
+    // enabled for polynomial divisors.
+    REQUIRE(!is_divisible_v<const poly_t &, const poly_t &>);
+
+    auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+    // Division by zero.
+    OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::div_exact(x, poly_t{}), std::domain_error,
+                                   "Cannot divide a polynomial by zero");
+    OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::divrem(x, poly_t{}), std::domain_error,
+                                   "Cannot divide a polynomial by zero");
+
+    // Simple cases.
+    REQUIRE(*polynomials::div_exact(poly_t{}, x) == 0);
+    REQUIRE(*polynomials::div_exact(poly_t{6}, poly_t{-3}) == -2);
+    REQUIRE(*polynomials::div_exact(x * y, y) == x);
+    REQUIRE(!polynomials::div_exact(poly_t{6}, poly_t{4}));
+    REQUIRE(!polynomials::div_exact(x, y));
+    REQUIRE(polynomials::divrem(poly_t{6}, poly_t{4}) == std::make_pair(poly_t{}, poly_t{6}));
+    REQUIRE(polynomials::divrem(x, y) == std::make_pair(poly_t{}, x));
+
+    // Exact factorisations.
+    {
+        const auto f = obake::pow(1 + x + y + z, 8), g = obake::pow(1 - x + 2 * y - z, 6) + x * y * z;
+        const auto fg = f * g;
+
+        REQUIRE(*polynomials::div_exact(fg, f) == g);
+        REQUIRE(*polynomials::div_exact(fg, g) == f);
+        REQUIRE(*polynomials::div_exact(fg, fg) == 1);
+        REQUIRE(polynomials::divrem(fg, g) == std::make_pair(f, poly_t{}));
+
+        // Non-exact divisions.
+        REQUIRE(!polynomials::div_exact(fg + 1, f));
+        REQUIRE(!polynomials::div_exact(fg, f + 1));
+        REQUIRE(!polynomials::div_exact(2 * fg, 3 * f));
+        REQUIRE(!polynomials::div_exact(f, fg));
+
+        // Division with remainder.
+        auto [q, r] = polynomials::divrem(fg + x * y - 3, f);
+        REQUIRE(q == g);
+        REQUIRE(r == x * y - 3);
+
+        std::tie(q, r) = polynomials::divrem(fg, f + 1);
+        REQUIRE(q * (f + 1) + r == fg);
+        REQUIRE(check_rem(r, f + 1));
+
+        std::tie(q, r) = polynomials::divrem(f, fg);
+        REQUIRE(q == 0);
+        REQUIRE(r == f);
+    }
+
+    // Integral coefficients: the leading coefficient of
+    // the divisor must divide the coefficients of the quotient.
+    {
+        REQUIRE(!polynomials::div_exact(x * x - 1, 2 * x + 2));
+        REQUIRE(polynomials::divrem(x * x - 1, 2 * x + 2) == std::make_pair(poly_t{}, x * x - 1));
+        REQUIRE(*polynomials::div_exact(4 * x * x - 4, 2 * x + 2) == 2 * x - 2);
+
+        using poly_d_t = polynomial<pm_t, double>;
+        auto [a] = make_polynomials<poly_d_t>("a");
+        REQUIRE(*polynomials::div_exact(a * a - 1, 2 * a + 2) == .5 * a - .5);
+    }
+
+    // The quotient may have exponents larger than the dividend.
+    {
+        // NOTE: y is the most significant variable.
+        auto [q, r] = polynomials::divrem(y * y, y - x);
+        REQUIRE(q == y + x);
+        REQUIRE(r == x * x);
+        REQUIRE(!polynomials::div_exact(y * y, y - x));
+    }
+
+    // Different symbol sets.
+    {
+        const auto a = obake::pow(x + 1, 3) * (y - 2);
+
+        REQUIRE(*polynomials::div_exact(a, y - 2) == obake::pow(x + 1, 3));
+        REQUIRE(*polynomials::div_exact(a, obake::pow(x + 1, 2)) == (x + 1) * (y - 2));
+        REQUIRE((*polynomials::div_exact(a, y - 2)).get_symbol_set() == symbol_set{"x", "y"});
+        REQUIRE(!polynomials::div_exact(a, z - 2));
+
+        auto [q, r] = polynomials::divrem(a + z, y - 2);
+        REQUIRE(q == obake::pow(x + 1, 3));
+        REQUIRE(r == z);
+        REQUIRE(q.get_symbol_set() == symbol_set{"x", "y", "z"});
+        REQUIRE(r.get_symbol_set() == symbol_set{"x", "y", "z"});
+    }
+
+    // Negative exponents.
+    {
+        poly_t xm1;
+        xm1.set_symbol_set(symbol_set{"x"});
+        xm1.add_term(pm_t{-1}, 1);
+
+        const auto a = obake::pow(xm1 + y, 3) * (x * y + 2);
+        REQUIRE(*polynomials::div_exact(a, obake::pow(xm1 + y, 3)) == x * y + 2);
+        REQUIRE(*polynomials::div_exact(xm1 * (x + y), xm1) == x + y);
+
+        // NOTE: the exponents of the quotient cannot be negative.
+        REQUIRE(!polynomials::div_exact(a, xm1 + y));
+        REQUIRE(!polynomials::div_exact(xm1, x));
+    }
+
+    // Random sparse polynomials.
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> edist(0, 10), cdist(-5, 5);
+
+        auto rand_poly = [&]() {
+            poly_t ret;
+            for (int i = 0; i < 30; ++i) {
+                ret += cdist(rng) * obake::pow(x, edist(rng)) * obake::pow(y, edist(rng)) * obake::pow(z, edist(rng));
+            }
+            return ret;
+        };
+
+        for (int n = 0; n < 10; ++n) {
+            auto a = rand_poly(), b = rand_poly();
+            if (b.empty()) {
+                continue;
+            }
+
+            REQUIRE(*polynomials::div_exact(a * b, b) == a);
+
+            const auto c = rand_poly();
+            auto [q, r] = polynomials::divrem(a * b + c, b);
+            REQUIRE(q * b + r == a * b + c);
+            REQUIRE(check_rem(r, b));
+        }
+    }
+
+    // Overflow.
+    {
+        poly_t a, b;
+        a.set_symbol_set(symbol_set{"x"});
+        b.set_symbol_set(symbol_set{"x"});
+        a.add_term(pm_t{detail::kpack_get_lims<std::int32_t>(1).second}, 1);
+        b.add_term(pm_t{-1}, 1);
+
+        OBAKE_REQUIRES_THROWS_CONTAINS(
+            polynomials::div_exact(a, b), std::overflow_error,
+            "An overflow in the monomial exponents was detected while attempting to divide two polynomials");
+        OBAKE_REQUIRES_THROWS_CONTAINS(
+            polynomials::divrem(a, b), std::overflow_error,
+            "An overflow in the monomial exponents was detected while attempting to divide two polynomials");
+    }
+}
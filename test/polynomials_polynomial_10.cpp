@@ -0,0 +1,125 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/math/evaluate.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/series.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_traits.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using int_t = mppp::integer<1>;
+using rat_t = mppp::rational<1>;
+
+using key_types = std::tuple<packed_monomial<std::int32_t>, d_packed_monomial<std::int32_t, 8>>;
+
+// Evaluation via the default series implementation.
+template <typename P, typename U>
+inline auto default_evaluate(const P &p, const symbol_map<U> &sm)
+{
+    return customisation::internal::series_default_evaluate_impl{}(p, sm);
+}
+
+TEST_CASE("polynomial_evaluate_test")
+{
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+        using poly_t = polynomial<pm_t, rat_t>;
+
+        REQUIRE(polynomials::detail::poly_evaluate_algo<const poly_t &, int_t> != 0);
+        REQUIRE(polynomials::detail::poly_evaluate_algo<const poly_t &, double> != 0);
+        REQUIRE(polynomials::detail::poly_evaluate_algo<const poly_t &, poly_t> != 0);
+        REQUIRE(polynomials::detail::poly_evaluate_algo<const poly_t &, void> == 0);
+        REQUIRE(std::is_same_v<decltype(evaluate(poly_t{}, symbol_map<double>{})), double>);
+        REQUIRE(std::is_same_v<decltype(evaluate(poly_t{}, symbol_map<int_t>{})), rat_t>);
+
+        auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+        const auto sm_q = symbol_map<rat_t>{{"x", rat_t{1, 2}}, {"y", rat_t{-2, 3}}, {"z", rat_t{5}}};
+
+        // Simple cases.
+        REQUIRE(evaluate(poly_t{}, sm_q) == 0);
+        REQUIRE(evaluate(poly_t{3}, sm_q) == 3);
+        REQUIRE(evaluate(x * y - 4 * obake::pow(z, 3), sm_q) == rat_t{-1501, 3});
+        REQUIRE(evaluate(x * y - obake::pow(z, -3) * 4 - 3 * obake::pow(x, -1), sm_q) == rat_t{-2387, 375});
+
+        // Missing symbols.
+        OBAKE_REQUIRES_THROWS_CONTAINS(evaluate(x * y, symbol_map<double>{{"x", 1.}}), std::invalid_argument,
+                                       "Cannot evaluate a series: the evaluation map, which contains the symbols "
+                                       "{'x'}, does not contain all the symbols in the series' symbol set, "
+                                       "{'x', 'y'}");
+
+        // Segmented polynomials with many terms and
+        // negative exponents.
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> edist(-10, 10), cdist(-5, 5);
+
+        for (auto s_idx : {0u, 1u, 3u, 6u}) {
+            poly_t p;
+            p.set_symbol_set(symbol_set{"x", "y", "z"});
+            p.set_n_segments(s_idx);
+            for (int i = 0; i < 1000; ++i) {
+                p.add_term(pm_t{edist(rng), edist(rng), edist(rng)}, cdist(rng));
+            }
+
+            const auto ret = evaluate(p, sm_q);
+            REQUIRE(ret == default_evaluate(p, sm_q));
+
+            // Evaluation with non-exact types.
+            const auto sm_d = symbol_map<double>{{"x", .5}, {"y", -2. / 3}, {"z", 5.}};
+            const auto ret_d = static_cast<double>(ret);
+            const auto ev_d = evaluate(p, sm_d);
+            REQUIRE(std::abs(ev_d - ret_d) <= 1E-10 * std::abs(ret_d));
+
+            // The partial results of the tables are added up
+            // in a fixed order: the result must be reproducible.
+            for (int i = 0; i < 10; ++i) {
+                REQUIRE(evaluate(p, sm_d) == ev_d);
+                REQUIRE(default_evaluate(p, sm_d) == default_evaluate(p, sm_d));
+            }
+
+            // Evaluation with a polynomial.
+            REQUIRE(evaluate(p, symbol_map<poly_t>{{"x", poly_t{sm_q.at("x")}},
+                                                   {"y", poly_t{sm_q.at("y")}},
+                                                   {"z", poly_t{sm_q.at("z")}}})
+                    == ret);
+
+            // Extra symbols in the evaluation map.
+            auto sm_q2 = sm_q;
+            sm_q2["t"] = rat_t{7};
+            REQUIRE(evaluate(p, sm_q2) == ret);
+        }
+
+        // Sparse exponents: the power tables would be too large,
+        // the default evaluation is used instead.
+        {
+            const auto p = 3 * obake::pow(x, 100) * y - 2 * z * obake::pow(y, 90) + 1;
+            REQUIRE(evaluate(p, sm_q) == default_evaluate(p, sm_q));
+            REQUIRE(evaluate(p, sm_q)
+                    == 3 * obake::pow(rat_t{1, 2}, 100) * rat_t{-2, 3} - 10 * obake::pow(rat_t{-2, 3}, 90) + 1);
+        }
+    });
+}
@@ -0,0 +1,176 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/rational.hpp>
+
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/math/evaluate.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_traits.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using rat_t = mppp::rational<1>;
+
+using key_types = std::tuple<packed_monomial<std::int32_t>, d_packed_monomial<std::int32_t, 8>>;
+
+// Extract the i-th point from a batch evaluation map.
+template <typename U>
+inline symbol_map<U> batch_point(const symbol_map<std::vector<U>> &sm, std::size_t i)
+{
+    symbol_map<U> retval;
+    for (const auto &p : sm) {
+        retval.emplace(p.first, p.second[i]);
+    }
+
+    return retval;
+}
+
+TEST_CASE("polynomial_evaluate_batch_test")
+{
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+        using poly_t = polynomial<pm_t, rat_t>;
+        using polyd_t = polynomial<pm_t, double>;
+
+        REQUIRE(polynomials::detail::poly_evaluate_batch_algo<poly_t, rat_t>);
+        REQUIRE(polynomials::detail::poly_evaluate_batch_algo<poly_t, double>);
+        REQUIRE(polynomials::detail::poly_evaluate_batch_algo<polyd_t, double>);
+        REQUIRE(!polynomials::detail::poly_evaluate_batch_algo<poly_t, void>);
+        REQUIRE(!polynomials::detail::poly_evaluate_batch_algo<polynomial<pm_t, poly_t>, double>);
+        REQUIRE(!polynomials::detail::poly_evaluate_batch_algo<int, double>);
+        REQUIRE(std::is_same_v<decltype(polynomials::evaluate_batch(poly_t{}, symbol_map<std::vector<rat_t>>{})),
+                               std::vector<rat_t>>);
+        REQUIRE(std::is_same_v<decltype(polynomials::evaluate_batch(poly_t{}, symbol_map<std::vector<double>>{})),
+                               std::vector<double>>);
+
+        auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+        // Simple cases.
+        REQUIRE(polynomials::evaluate_batch(poly_t{}, symbol_map<std::vector<rat_t>>{}).empty());
+        REQUIRE(polynomials::evaluate_batch(poly_t{},
+                                            symbol_map<std::vector<rat_t>>{{"x", {rat_t{1}, rat_t{2}, rat_t{3}}}})
+                == std::vector<rat_t>(3u));
+        REQUIRE(polynomials::evaluate_batch(poly_t{3}, symbol_map<std::vector<rat_t>>{{"x", {rat_t{1}, rat_t{2}}}})
+                == std::vector<rat_t>(2u, rat_t{3}));
+        REQUIRE(polynomials::evaluate_batch(x * y - 4 * obake::pow(z, 3),
+                                            symbol_map<std::vector<rat_t>>{{"x", {rat_t{1, 2}, rat_t{1}}},
+                                                                           {"y", {rat_t{-2, 3}, rat_t{2}}},
+                                                                           {"z", {rat_t{5}, rat_t{0}}}})
+                == std::vector<rat_t>{rat_t{-1501, 3}, rat_t{2}});
+
+        // Error handling.
+        OBAKE_REQUIRES_THROWS_CONTAINS(
+            polynomials::evaluate_batch(x * y, symbol_map<std::vector<double>>{{"x", {1.}}}), std::invalid_argument,
+            "Cannot evaluate a polynomial in batch mode: the symbol 'y' is missing from the evaluation map");
+        OBAKE_REQUIRES_THROWS_CONTAINS(
+            polynomials::evaluate_batch(x * y, symbol_map<std::vector<double>>{{"x", {1.}}, {"y", {1., 2.}}}),
+            std::invalid_argument,
+            "Cannot evaluate a polynomial in batch mode: the array of values for the symbol 'y' has a size of 2, "
+            "but the array of values for the symbol 'x' has a size of 1");
+
+        // Segmented polynomials with many terms, negative
+        // exponents and a number of points which is not
+        // a multiple of the block size.
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> edist(-10, 10), cdist(-5, 5), vdist(50, 100);
+
+        for (auto s_idx : {0u, 1u, 3u}) {
+            poly_t p;
+            p.set_symbol_set(symbol_set{"x", "y", "z"});
+            p.set_n_segments(s_idx);
+            for (int i = 0; i < 500; ++i) {
+                p.add_term(pm_t{edist(rng), edist(rng), edist(rng)}, cdist(rng));
+            }
+
+            symbol_map<std::vector<rat_t>> sm_q;
+            symbol_map<std::vector<double>> sm_d;
+            for (const auto &s : {"t", "x", "y", "z"}) {
+                for (auto i = 0; i < 300; ++i) {
+                    const auto num = vdist(rng), den = vdist(rng);
+                    sm_q[s].emplace_back(num, den);
+                    sm_d[s].push_back(static_cast<double>(num) / den);
+                }
+            }
+
+            const auto ret_q = polynomials::evaluate_batch(p, sm_q);
+            const auto ret_d = polynomials::evaluate_batch(p, sm_d);
+            REQUIRE(ret_q.size() == 300u);
+            REQUIRE(ret_d.size() == 300u);
+            for (std::size_t i = 0; i < 300u; ++i) {
+                REQUIRE(ret_q[i] == evaluate(p, batch_point(sm_q, i)));
+                const auto cmp = static_cast<double>(ret_q[i]);
+                REQUIRE(std::abs(ret_d[i] - cmp) <= 1E-8 * std::abs(cmp));
+            }
+
+            // The results must be reproducible.
+            for (int i = 0; i < 5; ++i) {
+                REQUIRE(polynomials::evaluate_batch(p, sm_d) == ret_d);
+            }
+        }
+
+        // Power tables which would be small compared to the number
+        // of terms, but too large when replicated for all
+        // the points in a block: the powers are computed on the fly.
+        {
+            std::uniform_int_distribution<int> wide_edist(-100, 100);
+
+            poly_t p;
+            p.set_symbol_set(symbol_set{"x", "y", "z"});
+            p.set_n_segments(1);
+            for (int i = 0; i < 2000; ++i) {
+                p.add_term(pm_t{wide_edist(rng), wide_edist(rng), wide_edist(rng)}, cdist(rng));
+            }
+            REQUIRE(p.size() > 603u);
+
+            symbol_map<std::vector<rat_t>> sm_q;
+            for (const auto &s : {"x", "y", "z"}) {
+                for (auto i = 0; i < 260; ++i) {
+                    sm_q[s].emplace_back(vdist(rng), vdist(rng));
+                }
+            }
+
+            const auto ret_q = polynomials::evaluate_batch(p, sm_q);
+            REQUIRE(ret_q.size() == 260u);
+            for (std::size_t i = 0; i < 260u; i += 37u) {
+                REQUIRE(ret_q[i] == evaluate(p, batch_point(sm_q, i)));
+            }
+        }
+
+        // Sparse exponents: the powers are computed
+        // on the fly.
+        {
+            const auto p = 3 * obake::pow(x, 100) * y - 2 * z * obake::pow(y, 90) + 1;
+            const auto sm = symbol_map<std::vector<rat_t>>{
+                {"x", {rat_t{1, 2}, rat_t{1}, rat_t{-1}}},
+                {"y", {rat_t{-2, 3}, rat_t{1}, rat_t{1}}},
+                {"z", {rat_t{5}, rat_t{1}, rat_t{2}}}};
+            const auto ret = polynomials::evaluate_batch(p, sm);
+            REQUIRE(ret.size() == 3u);
+            REQUIRE(ret[0] == 3 * obake::pow(rat_t{1, 2}, 100) * rat_t{-2, 3} - 10 * obake::pow(rat_t{-2, 3}, 90) + 1);
+            REQUIRE(ret[1] == 2);
+            REQUIRE(ret[2] == 0);
+        }
+    });
+}
@@ -0,0 +1,76 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <tuple>
+
+#include <mp++/rational.hpp>
+
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/math/degree.hpp>
+#include <obake/math/p_degree.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using rat_t = mppp::rational<1>;
+
+using key_types = std::tuple<packed_monomial<std::int32_t>, d_packed_monomial<std::int32_t, 8>>;
+
+TEST_CASE("polynomial_segmented_degree_test")
+{
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+        using poly_t = polynomial<pm_t, rat_t>;
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> edist(-10, 10), cdist(1, 5);
+
+        const auto ss = symbol_set{"x", "y", "z"};
+
+        for (auto s_idx : {0u, 1u, 2u, 4u, 6u}) {
+            // NOTE: with few terms, some of the tables
+            // will be empty.
+            for (auto n_terms : {1, 3, 500}) {
+                poly_t p;
+                p.set_symbol_set(ss);
+                p.set_n_segments(s_idx);
+
+                std::int32_t max_d = -100, max_pd = -100;
+                for (int i = 0; i < n_terms; ++i) {
+                    const auto a = edist(rng), b = edist(rng), c = edist(rng);
+                    p.add_term(pm_t{a, b, c}, cdist(rng));
+
+                    max_d = std::max(max_d, static_cast<std::int32_t>(a + b + c));
+                    max_pd = std::max(max_pd, static_cast<std::int32_t>(a + c));
+                }
+
+                REQUIRE(p._get_s_table().size() == 1u << s_idx);
+
+                // NOTE: the coefficients are all positive,
+                // thus no term can be cancelled.
+                REQUIRE(degree(p) == max_d);
+                REQUIRE(p_degree(p, symbol_set{"x", "z"}) == max_pd);
+            }
+        }
+
+        // Empty series.
+        poly_t p;
+        p.set_n_segments(3);
+        REQUIRE(degree(p) == 0);
+        REQUIRE(p_degree(p, symbol_set{"x"}) == 0);
+    });
+}
@@ -0,0 +1,142 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/hash.hpp>
+#include <obake/kpack.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using rat_t = mppp::rational<1>;
+
+using key_types = std::tuple<packed_monomial<std::int32_t>, d_packed_monomial<std::int32_t, 8>>;
+
+// Multiplication by a single term.
+TEST_CASE("polynomial_mul_monomial_test")
+{
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+        using poly_t = polynomial<pm_t, rat_t>;
+        using polyz_t = polynomial<pm_t, mppp::integer<1>>;
+
+        REQUIRE(polynomials::detail::poly_mul_inplace_algo<poly_t, poly_t, poly_t>);
+        REQUIRE(polynomials::detail::poly_mul_inplace_algo<poly_t, poly_t, polyz_t>);
+        REQUIRE(!polynomials::detail::poly_mul_inplace_algo<poly_t, polyz_t, poly_t>);
+
+        auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+        const auto m = 3 * x * obake::pow(y, 2) / 5;
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> edist(-10, 10), cdist(-5, 5);
+
+        for (auto s_idx : {0u, 1u, 3u, 5u}) {
+            poly_t p;
+            p.set_symbol_set(symbol_set{"x", "y", "z"});
+            p.set_n_segments(s_idx);
+            for (int i = 0; i < 500; ++i) {
+                p.add_term(pm_t{edist(rng), edist(rng), edist(rng)}, cdist(rng));
+            }
+
+            // The truncated product does not use
+            // the single-term implementation.
+            const auto cmp = truncated_mul(p, m, 1000);
+
+            auto ret = p * m;
+            REQUIRE(ret == cmp);
+            REQUIRE(ret._get_s_table().size() == 1u << s_idx);
+            REQUIRE(m * p == cmp);
+
+            // Check that the terms are in the right tables.
+            for (const auto &tab : ret._get_s_table()) {
+                for (const auto &t : tab) {
+                    REQUIRE(&tab == &ret._get_s_table()[hash(t.first) & (ret._get_s_table().size() - 1u)]);
+                }
+            }
+
+            // In-place multiplication of rvalues.
+            auto p_copy(p);
+            ret = std::move(p_copy) * m;
+            REQUIRE(ret == cmp);
+            REQUIRE(ret._get_s_table().size() == 1u << s_idx);
+            for (const auto &tab : ret._get_s_table()) {
+                for (const auto &t : tab) {
+                    REQUIRE(&tab == &ret._get_s_table()[hash(t.first) & (ret._get_s_table().size() - 1u)]);
+                }
+            }
+
+            p_copy = p;
+            ret = m * std::move(p_copy);
+            REQUIRE(ret == cmp);
+
+            p_copy = p;
+            auto m_copy(m);
+            ret = std::move(p_copy) * std::move(m_copy);
+            REQUIRE(ret == cmp);
+
+            // Mixed coefficient types.
+            p_copy = p;
+            auto [xz, yz] = make_polynomials<polyz_t>("x", "y");
+            ret = std::move(p_copy) * (2 * xz * yz);
+            REQUIRE(ret == truncated_mul(p, 2 * xz * yz, 1000));
+
+            // Different symbol sets: fall back to
+            // the general implementation.
+            p_copy = p;
+            auto [t] = make_polynomials<poly_t>("t");
+            REQUIRE(std::move(p_copy) * t == truncated_mul(p, t, 1000));
+        }
+
+        // If the exponents overflow, the in-place
+        // multiplication leaves the operand untouched.
+        if constexpr (std::is_same_v<pm_t, packed_monomial<std::int32_t>>) {
+            poly_t a, b;
+            a.set_symbol_set(symbol_set{"x"});
+            b.set_symbol_set(symbol_set{"x"});
+            a.add_term(pm_t{detail::kpack_get_lims<std::int32_t>(1).second}, 1);
+            a.add_term(pm_t{0}, 2);
+            b.add_term(pm_t{detail::kpack_get_lims<std::int32_t>(1).second}, 3);
+
+            const auto a_copy(a);
+            OBAKE_REQUIRES_THROWS_CONTAINS(
+                a *= b, std::overflow_error,
+                "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+            REQUIRE(a == a_copy);
+            REQUIRE(a.get_symbol_set() == symbol_set{"x"});
+            OBAKE_REQUIRES_THROWS_CONTAINS(
+                a = std::move(a) * b, std::overflow_error,
+                "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+            REQUIRE(a == a_copy);
+            REQUIRE(a.get_symbol_set() == symbol_set{"x"});
+        }
+
+        // Empty operands.
+        REQUIRE(poly_t{} * x == 0);
+        REQUIRE(x * poly_t{} == 0);
+        REQUIRE(poly_t{} * (x + y) == 0);
+        REQUIRE(std::move(x) * poly_t{} == 0);
+    });
+}
@@ -0,0 +1,112 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/hash.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/mul_policy.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using rat_t = mppp::rational<1>;
+
+using key_types = std::tuple<packed_monomial<std::int32_t>, d_packed_monomial<std::int32_t, 8>>;
+
+// Multiplication of operands depending on disjoint sets of symbols.
+TEST_CASE("polynomial_mul_tensor_test")
+{
+    detail::tuple_for_each(key_types{}, [](auto k) {
+        using pm_t = decltype(k);
+        using poly_t = polynomial<pm_t, rat_t>;
+        using polyz_t = polynomial<pm_t, mppp::integer<1>>;
+
+        auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+
+        REQUIRE(polynomials::detail::poly_mul_trim_identify(poly_t{}).empty());
+        REQUIRE(polynomials::detail::poly_mul_trim_identify(x + 2 * z * t - z + y - y)
+                == std::vector<int>{0, 0, 1, 0});
+
+        // Small operands.
+        {
+            const auto f = 1 + x + y, g = 1 - z / 3 + t * z;
+            const auto ret = f * g;
+            REQUIRE(ret.size() == f.size() * g.size());
+            REQUIRE(ret == truncated_mul(f, g, 1000));
+            REQUIRE(ret == g * f);
+        }
+
+        // Large operands, possibly multithreaded.
+        for (auto n : {10, 25}) {
+            const auto f = obake::pow(1 + x + y, n) * 2, g = obake::pow(1 - z / 3 + t, n);
+            const auto ret = f * g;
+            REQUIRE(ret.size() == f.size() * g.size());
+            REQUIRE(ret == truncated_mul(f, g, 1000));
+
+            // Check that the terms are in the right tables.
+            for (const auto &tab : ret._get_s_table()) {
+                for (const auto &term : tab) {
+                    REQUIRE(&tab == &ret._get_s_table()[hash(term.first) & (ret._get_s_table().size() - 1u)]);
+                }
+            }
+
+            // The segmentation follows the segment
+            // size in the multiplication policy.
+            {
+                polynomials::mul_policy mp;
+                mp.sparse_seg_size = 1ul << 30;
+                polynomials::mul_policy_guard mpg(mp);
+
+                REQUIRE((f * g)._get_s_table().size() == 1u);
+            }
+            {
+                polynomials::mul_policy mp;
+                mp.sparse_seg_size = 1;
+                polynomials::mul_policy_guard mpg(mp);
+
+                const auto ret2 = f * g;
+                REQUIRE(ret2._get_s_table().size() > 1u);
+                REQUIRE(ret2 == ret);
+            }
+
+            // Mixed coefficient types.
+            auto [xz, yz] = make_polynomials<polyz_t>("x", "y");
+            const auto fz = obake::pow(1 + xz + yz, n);
+            REQUIRE(fz * g == truncated_mul(fz, g, 1000));
+        }
+
+        // Overlapping symbols: the usual algorithms are used.
+        {
+            const auto f = 1 + x + y, g = 1 + y + z;
+            REQUIRE(f * g == truncated_mul(f, g, 1000));
+            REQUIRE((f * g).size() < f.size() * g.size());
+
+            // A single term of h shares a symbol with f.
+            const auto h = obake::pow(1 + z + t, 10) + x * t;
+            REQUIRE(f * h == truncated_mul(f, h, 1000));
+            REQUIRE((f * h).size() < f.size() * h.size());
+
+            // Squaring.
+            REQUIRE(f * f == truncated_mul(f, f, 1000));
+            REQUIRE((f * f).size() == 6u);
+        }
+    });
+}
@@ -19,6 +19,7 @@
 #include <obake/cf/cf_tex_stream_insert.hpp>
 #include <obake/math/degree.hpp>
 #include <obake/math/diff.hpp>
+#include <obake/math/fma3.hpp>
 #include <obake/math/integrate.hpp>
 #include <obake/math/p_degree.hpp>
 #include <obake/math/pow.hpp>
@@ -834,6 +835,67 @@ TEST_CASE("in-place multiplication")
     }
 }
 
+TEST_CASE("fma3")
+{
+    using pm_t = packed_monomial<std::int32_t>;
+    using ps_t = p_series<pm_t, double>;
+
+    REQUIRE(is_mult_addable_v<ps_t &, const ps_t &, const ps_t &>);
+
+    // No truncation.
+    {
+        auto [x, y] = make_p_series<ps_t>("x", "y");
+
+        auto ret = x - y;
+        obake::fma3(ret, x + y, x - y);
+        REQUIRE(ret == x - y + (x + y) * (x - y));
+        REQUIRE(get_truncation(ret).index() == 0u);
+    }
+
+    // Total degree truncation.
+    {
+        auto [x, y] = make_p_series_t<ps_t>(3, "x", "y");
+
+        auto ret = x * y;
+        obake::fma3(ret, x + y + 1, x - y - 1);
+        REQUIRE(ret == x * y + (x + y + 1) * (x - y - 1));
+        REQUIRE(std::get<1>(get_truncation(ret)) == 3);
+
+        obake::fma3(ret, x * x + y, x * y - 1);
+        REQUIRE(ret == x * y + (x + y + 1) * (x - y - 1) + (x * x + y) * (x * y - 1));
+        REQUIRE(degree(ret) <= 3);
+
+        // Empty ret.
+        ret = ps_t{};
+        ret.set_symbol_set(symbol_set{"x", "y"});
+        ret.tag() = x.tag();
+        obake::fma3(ret, x * x + y, x * y - 1);
+        REQUIRE(ret == (x * x + y) * (x * y - 1));
+        REQUIRE(std::get<1>(get_truncation(ret)) == 3);
+    }
+
+    // Partial degree truncation.
+    {
+        auto [x, y] = make_p_series_p<ps_t>(2, symbol_set{"x"}, "x", "y");
+
+        auto ret = x + y;
+        obake::fma3(ret, x + y, x * x + y * y);
+        REQUIRE(ret == x + y + (x + y) * (x * x + y * y));
+        REQUIRE(p_degree(ret, symbol_set{"x"}) <= 2);
+    }
+
+    // Differing truncation settings: fall back to
+    // the usual multiplication + addition.
+    {
+        auto [x, y] = make_p_series_t<ps_t>(3, "x", "y");
+        auto ret = make_p_series<ps_t>("x")[0];
+
+        obake::fma3(ret, x * x + y, x * y - 1);
+        REQUIRE(ret == make_p_series<ps_t>("x")[0] + (x * x + y) * (x * y - 1));
+        REQUIRE(std::get<1>(get_truncation(ret)) == 3);
+    }
+}
+
 TEST_CASE("division")
 {
     using pm_t = packed_monomial<std::int32_t>;
@@ -1045,6 +1107,26 @@ TEST_CASE("pow")
         REQUIRE(obake::pow(xt + yt, 5).empty());
         REQUIRE(!obake::pow(xt2 + yt2, 5).empty());
     }
+
+    // Larger exponents with a constant term (i.e., via
+    // Miller's recurrence) vs repeated multiplications.
+    {
+        auto [x, y] = make_p_series_t<ps_t>(6, "x", "y");
+        auto [xp, yp] = make_p_series_p<ps_t>(3, symbol_set{"x"}, "x", "y");
+
+        auto rep_pow = [](const ps_t &p, unsigned n) {
+            auto retval = p;
+            for (auto i = 1u; i < n; ++i) {
+                retval *= p;
+            }
+            return retval;
+        };
+
+        REQUIRE(obake::pow(1 + x - 2 * y, 11) == rep_pow(1 + x - 2 * y, 11));
+        REQUIRE(obake::pow(3 - x * y + x, 7) == rep_pow(3 - x * y + x, 7));
+        REQUIRE(obake::pow(1 + xp - 2 * yp, 11) == rep_pow(1 + xp - 2 * yp, 11));
+        REQUIRE(obake::get_truncation(obake::pow(1 + xp - 2 * yp, 11)) == obake::get_truncation(xp));
+    }
 }
 
 // Check that trimming preserves the tag.
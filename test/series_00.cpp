@@ -1226,6 +1226,28 @@ TEST_CASE("series_generic_ctor")
         s1_double.add_term(pm_t{7, 8, 9}, -.2);
         REQUIRE(s1_int_t{s1_double}.empty());
         REQUIRE(s1_int_t{s1_double}.get_s_size() == s_idx);
+
+        // Many terms, some of which are converted to zero.
+        s1_double = s1_double_t{};
+        s1_double.set_n_segments(s_idx);
+        s1_double.set_symbol_set(symbol_set{"x", "y", "z"});
+        for (std::int32_t i = 0; i < 1000; ++i) {
+            s1_double.add_term(pm_t{i % 10, -(i / 10 % 10), i / 100}, i % 3 == 0 ? .5 : static_cast<double>(i));
+        }
+        {
+            auto s1_double_copy = s1_double;
+
+            s1_int = s1_int_t{s1_double};
+            REQUIRE(s1_int.size() == 666u);
+            REQUIRE(s1_int.get_s_size() == s_idx);
+            for (const auto &p : s1_int) {
+                REQUIRE(p.second == s1_double.find(p.first)->second);
+            }
+
+            s1_int_t s1_int_2{std::move(s1_double_copy)};
+            REQUIRE(s1_int_2 == s1_int);
+            REQUIRE(s1_int_2.get_s_size() == s_idx);
+        }
     }
 
     // Construction from a series with higher rank.
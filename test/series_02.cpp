@@ -17,6 +17,7 @@
 
 #include <mp++/rational.hpp>
 
+#include <obake/math/pow.hpp>
 #include <obake/polynomials/packed_monomial.hpp>
 #include <obake/polynomials/polynomial.hpp>
 #include <obake/series.hpp>
@@ -701,6 +702,26 @@ TEST_CASE("series_default_mul")
         REQUIRE(n == 12);
         n *= std::move(s1);
         REQUIRE(n == 36);
+
+        // Many terms, and in-place operations with one
+        // of the coefficients of the series.
+        s1 = s1_t{};
+        s1.set_n_segments(s_idx1);
+        s1.set_symbol_set(symbol_set{"x"});
+        for (std::int32_t i = 0; i < 1000; ++i) {
+            s1.add_term(pm_t{i}, i + 1);
+        }
+
+        auto s1_copy = s1 * 2;
+        REQUIRE(s1_copy.size() == 1000u);
+        for (const auto &[k, c] : s1_copy) {
+            REQUIRE(c == 2 * s1.find(k)->second);
+        }
+
+        s1 *= s1.find(pm_t{1})->second;
+        REQUIRE(s1 == s1_copy);
+        s1 /= s1.find(pm_t{0})->second;
+        REQUIRE(s1 * 2 == s1_copy);
     }
 
     // Customisation points.
@@ -748,6 +769,68 @@ TEST_CASE("series_clear_terms")
     REQUIRE(s._get_s_table().size() == 16u);
 }
 
+TEST_CASE("series_content_hash")
+{
+    using pm_t = packed_monomial<std::int32_t>;
+    using s1_t = series<pm_t, rat_t, tag>;
+    using p1_t = polynomial<pm_t, rat_t>;
+
+    REQUIRE(s1_t{}.content_hash() == 0u);
+
+    auto [x, y, z] = make_polynomials<p1_t>("x", "y", "z");
+
+    // The hash does not depend on the term order,
+    // on the coefficients or on the segmentation.
+    const auto a = x + 2 * y - z;
+    REQUIRE(a.content_hash() == (-z + x + y).content_hash());
+    REQUIRE(a.content_hash() == a.content_hash());
+    for (auto l : {1u, 4u, 8u}) {
+        p1_t b;
+        b.set_symbol_set(a.get_symbol_set());
+        b.set_n_segments(l);
+        b.add_term(pm_t{0, 0, 1}, 1);
+        b.add_term(pm_t{1, 0, 0}, 4);
+        b.add_term(pm_t{0, 1, 0}, -1);
+        REQUIRE(b.content_hash() == a.content_hash());
+    }
+
+    // Mutations invalidate the cached hash.
+    auto c = a;
+    REQUIRE(c.content_hash() == a.content_hash());
+    c += x * y;
+    REQUIRE(c.content_hash() != a.content_hash());
+    REQUIRE(c.content_hash() == (a + x * y).content_hash());
+    c.add_term(pm_t{1, 1, 1}, 1);
+    REQUIRE(c.content_hash() == (a + x * y + x * y * z).content_hash());
+    c.clear_terms();
+    REQUIRE(c.content_hash() == 0u);
+    c = a;
+    REQUIRE(c.content_hash() == a.content_hash());
+    c.set_n_segments(2);
+    REQUIRE(c.content_hash() == 0u);
+    c = a * a;
+    REQUIRE(c.content_hash() == (a * a).content_hash());
+    auto d = std::move(c);
+    REQUIRE(d.content_hash() == (a * a).content_hash());
+    c = a;
+    swap(c, d);
+    REQUIRE(c.content_hash() == (a * a).content_hash());
+    REQUIRE(d.content_hash() == a.content_hash());
+    d.clear();
+    REQUIRE(d.content_hash() == 0u);
+
+    // Large segmented series.
+    auto e = obake::pow(x + y + z + 1, 20);
+    const auto e_hash = e.content_hash();
+    auto f = e;
+    f.set_n_segments(e.get_s_size() == 0u ? 4u : 0u);
+    f.set_symbol_set(e.get_symbol_set());
+    for (const auto &t : e) {
+        f.add_term(t.first, t.second);
+    }
+    REQUIRE(f.content_hash() == e_hash);
+}
+
 namespace ns
 {
 
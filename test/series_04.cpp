@@ -13,9 +13,12 @@
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <fmt/core.h>
 
+#include <tbb/parallel_for.h>
+
 #include <mp++/integer.hpp>
 #include <mp++/rational.hpp>
 
@@ -110,14 +113,110 @@ TEST_CASE("series_pow_test")
               "series/coefficient types do not support the necessary operations)");
 
     // Test clearing of the cache.
-    auto [map, _] = customisation::internal::get_series_pow_map();
-    detail::ignore(_);
-
-    REQUIRE(!map.empty());
+    REQUIRE(customisation::internal::get_series_pow_cache_stats().n_entries != 0u);
 
     customisation::internal::clear_series_pow_map();
 
-    REQUIRE(map.empty());
+    REQUIRE(customisation::internal::get_series_pow_cache_stats().n_entries == 0u);
+    REQUIRE(customisation::internal::get_series_pow_cache_stats().n_bytes == 0u);
+}
+
+TEST_CASE("series_pow_cache_test")
+{
+    using namespace customisation::internal;
+
+    using pm_t = packed_monomial<std::int32_t>;
+    using p1_t = polynomial<pm_t, rat_t>;
+
+    auto [x, y, z] = make_polynomials<p1_t>("x", "y", "z");
+
+    clear_series_pow_map();
+
+    const auto orig_max_bytes = get_series_pow_cache_max_bytes();
+    REQUIRE(orig_max_bytes > 0u);
+
+    // Hits and misses.
+    auto st0 = get_series_pow_cache_stats();
+    REQUIRE(st0.n_entries == 0u);
+    REQUIRE(st0.max_bytes == orig_max_bytes);
+
+    REQUIRE(series_pow_cache_size(x - y) == 0u);
+    REQUIRE(series_pow_from_cache(x - y, 3) == (x - y) * (x - y) * (x - y));
+    REQUIRE(series_pow_cache_size(x - y) == 4u);
+    REQUIRE(series_pow_from_cache(x - y, 2) == (x - y) * (x - y));
+    REQUIRE(series_pow_from_cache(x - y, 0) == 1);
+
+    auto st1 = get_series_pow_cache_stats();
+    REQUIRE(st1.hits == st0.hits + 2u);
+    REQUIRE(st1.misses == st0.misses + 1u);
+    REQUIRE(st1.n_entries == 1u);
+    REQUIRE(st1.n_bytes > 0u);
+
+    // Different bases (and different types) get different entries.
+    REQUIRE(series_pow_from_cache(x + y, 2) == (x + y) * (x + y));
+    REQUIRE(series_pow_from_cache(p1_t{x - y} * 1, 4) == obake::pow(x - y, 4));
+    REQUIRE(series_pow_from_cache(polynomial<pm_t, mppp::integer<1>>{x - y}, 2) == (x - y) * (x - y));
+    REQUIRE(get_series_pow_cache_stats().n_entries == 3u);
+
+    // Eviction.
+    set_series_pow_cache_max_bytes(0);
+    auto st2 = get_series_pow_cache_stats();
+    REQUIRE(st2.n_entries == 0u);
+    REQUIRE(st2.n_bytes == 0u);
+    REQUIRE(st2.evictions == st1.evictions + 3u);
+
+    // With a zero budget, nothing is retained.
+    REQUIRE(series_pow_from_cache(x - z, 3) == (x - z) * (x - z) * (x - z));
+    REQUIRE(series_pow_cache_size(x - z) == 0u);
+    REQUIRE(get_series_pow_cache_stats().n_entries == 0u);
+
+    // Least recently used entries are evicted first.
+    set_series_pow_cache_max_bytes(orig_max_bytes);
+    const auto b0 = x + y + z + 1;
+    REQUIRE(series_pow_from_cache(b0, 10) == obake::pow(b0, 10));
+    const auto bytes0 = get_series_pow_cache_stats().n_bytes;
+    // NOTE: with many bases, some of them will end up in the same shard as b0.
+    set_series_pow_cache_max_bytes(bytes0 * 64u);
+    std::vector<p1_t> bases;
+    for (auto i = 0; i < 200; ++i) {
+        bases.push_back(x + y + z + 2 + i);
+        series_pow_from_cache(bases.back(), 10);
+        // Keep b0 alive.
+        REQUIRE(series_pow_cache_size(b0) == 11u);
+    }
+    auto st3 = get_series_pow_cache_stats();
+    REQUIRE(st3.evictions > st2.evictions);
+    REQUIRE(st3.n_bytes <= bytes0 * 64u);
+    REQUIRE(st3.n_entries < 201u);
+
+    // The budget applies to the cache as a whole: a single
+    // base can use more than 1/16 of the budget.
+    set_series_pow_cache_max_bytes(orig_max_bytes);
+    clear_series_pow_map();
+    series_pow_from_cache(b0, 10);
+    const auto bytes1 = get_series_pow_cache_stats().n_bytes;
+    set_series_pow_cache_max_bytes(bytes1 * 2u);
+    auto st4 = get_series_pow_cache_stats();
+    REQUIRE(st4.n_entries == 1u);
+    REQUIRE(st4.n_bytes == bytes1);
+    REQUIRE(series_pow_from_cache(b0, 10) == obake::pow(b0, 10));
+    REQUIRE(series_pow_cache_size(b0) == 11u);
+    auto st5 = get_series_pow_cache_stats();
+    REQUIRE(st5.hits == st4.hits + 1u);
+    REQUIRE(st5.evictions == st4.evictions);
+
+    // Concurrent computation of different bases.
+    set_series_pow_cache_max_bytes(orig_max_bytes);
+    clear_series_pow_map();
+    std::vector<p1_t> res(64);
+    tbb::parallel_for(0, 64, [&res, d = x - y](int i) { res[i] = series_pow_from_cache(d + i % 8, 7); });
+    for (auto i = 0; i < 64; ++i) {
+        const auto b = x - y + i % 8;
+        REQUIRE(res[i] == b * b * b * b * b * b * b);
+    }
+    REQUIRE(get_series_pow_cache_stats().n_entries == 8u);
+
+    clear_series_pow_map();
 }
 
 TEST_CASE("series_evaluate_test")
@@ -239,6 +338,37 @@ TEST_CASE("series_trim_test")
     REQUIRE(trim(p5) == p5);
     REQUIRE(trim(p5).get_symbol_set() != p5.get_symbol_set());
     REQUIRE(trim(p5).get_symbol_set() == symbol_set{});
+
+    // Segmented series.
+    auto [a] = make_polynomials<p1_t>("a");
+    const auto p6 = p2 + a - a;
+    REQUIRE(p6.get_symbol_set() == symbol_set{"a", "x", "y", "z"});
+
+    for (auto s_idx : {1u, 3u, 5u}) {
+        p1_t p7;
+        p7.set_symbol_set(p6.get_symbol_set());
+        p7.set_n_segments(s_idx);
+        for (const auto &t : p6) {
+            p7.add_term(t.first, t.second);
+        }
+
+        const auto p7_tr = trim(p7);
+        REQUIRE(p7_tr == p2);
+        REQUIRE(p7_tr.get_symbol_set() == symbol_set{"x", "y", "z"});
+        REQUIRE(p7_tr._get_s_table().size() == 1u << s_idx);
+        REQUIRE(p7.get_symbol_set() == symbol_set{"a", "x", "y", "z"});
+        REQUIRE(p7.size() == p2.size());
+
+        // Rvalue input.
+        const auto p7_tr_m = trim(std::move(p7));
+        REQUIRE(p7_tr_m == p2);
+        REQUIRE(p7_tr_m.get_symbol_set() == symbol_set{"x", "y", "z"});
+        REQUIRE(p7_tr_m._get_s_table().size() == 1u << s_idx);
+    }
+
+    // Rvalue input, single table.
+    auto p8(p3);
+    REQUIRE(trim(std::move(p8)) == p3);
 }
 
 // Test the fmt formatter specialisation.
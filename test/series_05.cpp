@@ -175,6 +175,31 @@ TEST_CASE("series_filter_test")
     REQUIRE(obake::degree(pf) == 3);
     REQUIRE(pf.get_symbol_set() == symbol_set{"x", "y", "z"});
 
+    // Check the number of removed terms.
+    pf = p;
+    REQUIRE(filter(pf, [](const auto &) { return true; }) == 0u);
+    REQUIRE(pf == p);
+    REQUIRE(filter(pf, [&ss = p.get_symbol_set()](const auto &t) { return obake::key_degree(t.first, ss) <= 3; })
+            == 15u);
+    REQUIRE(pf.size() == 20u);
+    REQUIRE(filter(pf, [](const auto &) { return false; }) == 20u);
+    REQUIRE(pf.empty());
+
+    // Segmented series.
+    for (auto s_idx : {1u, 3u, 5u}) {
+        pf = p;
+        pf.set_n_segments(s_idx);
+        for (const auto &t : p) {
+            pf.add_term(t.first, t.second);
+        }
+        REQUIRE(pf == p);
+        REQUIRE(filter(pf, [&ss = p.get_symbol_set()](const auto &t) { return obake::key_degree(t.first, ss) <= 2; })
+                == 25u);
+        REQUIRE(pf._get_s_table().size() == 1u << s_idx);
+        REQUIRE(pf.size() == 10u);
+        REQUIRE(obake::degree(pf) == 2);
+    }
+
     REQUIRE(!is_detected_v<filter_t, void, void>);
     REQUIRE(!is_detected_v<filter_t, void, int>);
     REQUIRE(!is_detected_v<filter_t, int, void>);
@@ -243,6 +268,38 @@ TEST_CASE("series_add_symbols_test")
     REQUIRE(add_symbols(p, symbol_set{"t", "x", "y", "z"}) == p);
     REQUIRE(add_symbols(p, symbol_set{"t", "x", "y", "z"}).get_symbol_set() == symbol_set{"t", "x", "y", "z"});
 
+    // Segmented series with many terms.
+    p = obake::pow(1 + x + y + z, 20);
+    const auto cmp = add_symbols(p, symbol_set{"t", "u"});
+    REQUIRE(cmp.get_s_size() == 0u);
+    for (auto s_idx : {1u, 2u, 5u, 8u}) {
+        auto ps = p1_t{};
+        ps.set_symbol_set(p.get_symbol_set());
+        ps.set_n_segments(s_idx);
+        for (const auto &t : p) {
+            ps.add_term(t.first, t.second);
+        }
+
+        auto ret = add_symbols(ps, symbol_set{"t", "u"});
+        REQUIRE(ret == cmp);
+        REQUIRE(ret.get_s_size() == s_idx);
+
+        ret = add_symbols(std::move(ps), symbol_set{"t", "u"});
+        REQUIRE(ret == cmp);
+        REQUIRE(ret.get_s_size() == s_idx);
+
+        // Symbol merging with coefficient conversion.
+        auto pd = polynomial<pm_t, double>{};
+        pd.set_symbol_set(symbol_set{"t"});
+        pd.set_n_segments(s_idx);
+        for (auto i = 0; i < 30; ++i) {
+            pd.add_term(pm_t{i}, i + .5);
+        }
+        auto ret2 = ret + pd;
+        REQUIRE(ret2.size() == cmp.size() + 29u);
+        REQUIRE(ret2 - pd == cmp);
+    }
+
     REQUIRE(!is_detected_v<add_symbols_t, void>);
     REQUIRE(!is_detected_v<add_symbols_t, const void>);
     REQUIRE(!is_detected_v<add_symbols_t, int>);
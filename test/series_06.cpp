@@ -123,6 +123,15 @@ TEST_CASE("series_div")
 
     OBAKE_REQUIRES_THROWS_CONTAINS(x / 0, mppp::zero_division_error, "");
 
+    // If an exception is thrown during an in-place division, the
+    // series loses its terms, but it retains its symbol set.
+    {
+        auto tmp = x + y;
+        OBAKE_REQUIRES_THROWS_CONTAINS(tmp /= 0, mppp::zero_division_error, "");
+        REQUIRE(tmp.empty());
+        REQUIRE(tmp.get_symbol_set() == symbol_set{"x", "y"});
+    }
+
     REQUIRE(std::is_same_v<s2_t, decltype(s1_t{} / 3.)>);
     REQUIRE((s2_t{} / 3.).empty());
     REQUIRE(s2_t{1} / 2. == 1. / 2.);
@@ -221,6 +230,37 @@ TEST_CASE("series_filtered_test")
     REQUIRE(obake::degree(pf) == 3);
     REQUIRE(pf.get_symbol_set() == symbol_set{"x", "y", "z"});
 
+    // Rvalue input.
+    auto p_copy(p);
+    pf = filtered(std::move(p_copy),
+                  [&ss = p.get_symbol_set()](const auto &t) { return obake::key_degree(t.first, ss) <= 2; });
+    REQUIRE(pf
+            == filtered(p, [&ss = p.get_symbol_set()](const auto &t) { return obake::key_degree(t.first, ss) <= 2; }));
+    REQUIRE(pf.size() == 10u);
+    REQUIRE(pf.get_symbol_set() == symbol_set{"x", "y", "z"});
+
+    // Segmented series.
+    for (auto s_idx : {1u, 3u, 5u}) {
+        p1_t ps;
+        ps.set_symbol_set(p.get_symbol_set());
+        ps.set_n_segments(s_idx);
+        for (const auto &t : p) {
+            ps.add_term(t.first, t.second);
+        }
+
+        pf = filtered(ps, [&ss = p.get_symbol_set()](const auto &t) { return obake::key_degree(t.first, ss) <= 2; });
+        REQUIRE(pf._get_s_table().size() == 1u << s_idx);
+        REQUIRE(pf.size() == 10u);
+        REQUIRE(ps.size() == 35u);
+        REQUIRE(obake::degree(pf) == 2);
+
+        pf = filtered(std::move(ps),
+                      [&ss = p.get_symbol_set()](const auto &t) { return obake::key_degree(t.first, ss) <= 1; });
+        REQUIRE(pf._get_s_table().size() == 1u << s_idx);
+        REQUIRE(pf.size() == 4u);
+        REQUIRE(obake::degree(pf) == 1);
+    }
+
     REQUIRE(!is_detected_v<filtered_t, void, void>);
     REQUIRE(!is_detected_v<filtered_t, void, int>);
     REQUIRE(!is_detected_v<filtered_t, int, void>);
@@ -0,0 +1,164 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mp++/rational.hpp>
+
+#include <obake/detail/hc.hpp>
+#include <obake/hash.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/series.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using rat_t = mppp::rational<1>;
+
+using namespace obake;
+
+using pm_t = packed_monomial<std::int32_t>;
+using poly_t = polynomial<pm_t, rat_t>;
+
+template <typename S, typename R>
+using add_terms_t = decltype(std::declval<S &>().add_terms(std::declval<R>()));
+
+// Check that the terms of s are in the right tables.
+template <typename S>
+inline bool check_tables(const S &s)
+{
+    const auto &s_table = s._get_s_table();
+
+    for (const auto &tab : s_table) {
+        for (const auto &t : tab) {
+            if (&tab != &s_table[hash(t.first) & (s_table.size() - 1u)]) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+TEST_CASE("series_add_terms_test")
+{
+    // Type checks.
+    REQUIRE(is_detected_v<add_terms_t, poly_t, std::vector<std::pair<pm_t, rat_t>>>);
+    REQUIRE(is_detected_v<add_terms_t, poly_t, std::vector<std::pair<pm_t, rat_t>> &>);
+    REQUIRE(is_detected_v<add_terms_t, poly_t, const std::vector<std::pair<pm_t, rat_t>> &>);
+    REQUIRE(is_detected_v<add_terms_t, poly_t, std::vector<std::pair<pm_t, int>>>);
+    REQUIRE(is_detected_v<add_terms_t, poly_t, std::vector<std::tuple<pm_t, int>>>);
+    REQUIRE(!is_detected_v<add_terms_t, poly_t, std::list<std::pair<pm_t, rat_t>>>);
+    REQUIRE(!is_detected_v<add_terms_t, poly_t, std::vector<std::pair<int, rat_t>>>);
+    REQUIRE(!is_detected_v<add_terms_t, poly_t, std::vector<std::pair<pm_t, std::vector<int>>>>);
+    REQUIRE(!is_detected_v<add_terms_t, poly_t, std::vector<int>>);
+
+    // Empty range.
+    poly_t p;
+    p.add_terms(std::vector<std::pair<pm_t, rat_t>>{});
+    REQUIRE(p.empty());
+
+    // Simple case.
+    p.set_symbol_set(symbol_set{"x", "y"});
+    p.add_terms(std::vector<std::pair<pm_t, int>>{{pm_t{1, 2}, 1}, {pm_t{0, 1}, -2}, {pm_t{1, 2}, 3}, {pm_t{}, 0}});
+    REQUIRE(p.size() == 2u);
+    auto [x, y] = make_polynomials<poly_t>("x", "y");
+    REQUIRE(p == 4 * x * y * y - 2 * y);
+
+    // Terms are accumulated with the existing ones.
+    p.add_terms(std::vector<std::tuple<pm_t, int>>{{pm_t{1, 2}, -4}, {pm_t{1, 0}, 1}});
+    REQUIRE(p == x - 2 * y);
+
+    // Incompatible keys.
+    poly_t q;
+    q.set_symbol_set(symbol_set{});
+    OBAKE_REQUIRES_THROWS_CONTAINS(q.add_terms(std::vector<std::pair<pm_t, int>>{{pm_t{}, 1}, {pm_t(1), 1}}),
+                                   std::invalid_argument, "not compatible with the series' symbol set");
+    // The series is cleared out on error.
+    REQUIRE(q.empty());
+
+    // from_terms().
+    REQUIRE(poly_t::from_terms(symbol_set{"x", "y"}, std::vector<std::pair<pm_t, int>>{{pm_t{1, 0}, 1}})
+            == x);
+
+    // Large number of terms, with and without duplicates.
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> edist(0, 50), cdist(1, 5);
+
+    std::vector<std::pair<pm_t, rat_t>> v;
+    poly_t cmp;
+    cmp.set_symbol_set(symbol_set{"x", "y", "z"});
+    for (int i = 0; i < 200000; ++i) {
+        v.emplace_back(pm_t{edist(rng), edist(rng), edist(rng)}, cdist(rng));
+        cmp.add_term(v.back().first, v.back().second);
+    }
+
+    auto p2 = poly_t::from_terms(symbol_set{"x", "y", "z"}, v);
+    REQUIRE(p2 == cmp);
+    REQUIRE(check_tables(p2));
+
+    // Explicitly segmented series.
+    poly_t p3;
+    p3.set_symbol_set(symbol_set{"x", "y", "z"});
+    p3.set_n_segments(4);
+    p3.add_terms(v);
+    REQUIRE(p3 == cmp);
+    REQUIRE(p3._get_s_table().size() == 16u);
+    REQUIRE(check_tables(p3));
+
+    // Unique terms, moved from.
+    std::vector<std::pair<pm_t, rat_t>> vu;
+    for (const auto &t : cmp) {
+        vu.emplace_back(t.first, t.second);
+    }
+    auto p4 = poly_t::from_terms<true>(symbol_set{"x", "y", "z"}, std::move(vu));
+    REQUIRE(p4 == cmp);
+    REQUIRE(check_tables(p4));
+}
+
+// Check that the automatic segmentation
+// depends on the number of terms.
+TEST_CASE("series_add_terms_segmentation_test")
+{
+    if (detail::hc() == 1u) {
+        return;
+    }
+
+    auto make_terms = [](std::size_t n) {
+        std::vector<std::pair<pm_t, int>> v;
+        for (std::size_t i = 0; i < n; ++i) {
+            v.emplace_back(pm_t{static_cast<std::int32_t>(i % 1024u), static_cast<std::int32_t>(i / 1024u)}, 1);
+        }
+        return v;
+    };
+
+    const auto n1 = detail::series_add_terms_mt_threshold;
+    const auto n2 = 2u * std::max(n1, std::size_t(4) * detail::hc() * detail::series_add_terms_seg_size);
+
+    const auto p1 = poly_t::from_terms<true>(symbol_set{"x", "y"}, make_terms(n1));
+    const auto p2 = poly_t::from_terms<true>(symbol_set{"x", "y"}, make_terms(n2));
+
+    REQUIRE(p1.size() == n1);
+    REQUIRE(p2.size() == n2);
+    REQUIRE(p1.get_s_size() > 0u);
+    REQUIRE(p2.get_s_size() > p1.get_s_size());
+    REQUIRE(check_tables(p1));
+    REQUIRE(check_tables(p2));
+}